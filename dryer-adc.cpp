@@ -0,0 +1,305 @@
+#include "dryer-adc.h"
+#include "dryer-latency.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+static const int DATA_RATES[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+static const char* CHANNEL_NAMES[4] = {"rpm", "drum", "vanes", "height"};
+static const int NAME_CHANNELS[4] = {ADC_CHAN_RPM, ADC_CHAN_DRUM_SIZE, ADC_CHAN_VANES, ADC_CHAN_VANE_HEIGHT};
+
+// Without ALERT/RDY: the data rate is only good to 10%, plus wake-up time
+static const double CONVERSION_MARGIN = 1.1;
+static const uint64_t WAKEUP_NS = 25000;
+static const uint64_t ERROR_BACKOFF_MS = 10;
+static const uint64_t START_TIMEOUT_MS = 200;
+
+// ============================================================================
+// AdcStream
+// ============================================================================
+
+AdcStream::AdcStream()
+    : written(0)
+{
+    for (int i = 0; i < SIZE; i++) {
+        times[i].store(0, std::memory_order_relaxed);
+        values[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void AdcStream::push(uint64_t timeNs, uint16_t value) {
+    uint64_t index = written.load(std::memory_order_relaxed);
+    times[index % SIZE].store(timeNs, std::memory_order_relaxed);
+    values[index % SIZE].store(value, std::memory_order_relaxed);
+    written.store(index + 1, std::memory_order_release);
+}
+
+bool AdcStream::valueAt(uint64_t timeNs, float& value) const {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint64_t count = written.load(std::memory_order_acquire);
+        if (count == 0) return false;
+
+        // Newest sample at or before timeNs; one slot is left to the writer
+        uint64_t newest = count - 1;
+        uint64_t oldest = count > SIZE - 1 ? count - (SIZE - 1) : 0;
+        uint64_t index = newest;
+        while (index > oldest && times[index % SIZE].load(std::memory_order_relaxed) > timeNs) {
+            index--;
+        }
+
+        uint64_t t0 = times[index % SIZE].load(std::memory_order_relaxed);
+        float v0 = values[index % SIZE].load(std::memory_order_relaxed);
+        float result = v0;
+        if (index < newest && t0 <= timeNs) {
+            uint64_t t1 = times[(index + 1) % SIZE].load(std::memory_order_relaxed);
+            float v1 = values[(index + 1) % SIZE].load(std::memory_order_relaxed);
+            if (t1 > t0) {
+                result = v0 + (v1 - v0) * static_cast<float>(timeNs - t0) / static_cast<float>(t1 - t0);
+            }
+        }
+
+        // Valid unless the writer came round to the slots just read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (written.load(std::memory_order_relaxed) < index + SIZE) {
+            value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t AdcStream::latest() const {
+    uint64_t count = written.load(std::memory_order_acquire);
+    return count > 0 ? values[(count - 1) % SIZE].load(std::memory_order_relaxed) : ADC_MAX_VALUE / 2;
+}
+
+uint64_t AdcStream::intervalNs() const {
+    uint64_t count = written.load(std::memory_order_acquire);
+    if (count < 2) return 0;
+    uint64_t newer = times[(count - 1) % SIZE].load(std::memory_order_relaxed);
+    uint64_t older = times[(count - 2) % SIZE].load(std::memory_order_relaxed);
+    return newer > older ? newer - older : 0;
+}
+
+// ============================================================================
+// AdcScheduler
+// ============================================================================
+
+AdcScheduler::AdcScheduler(DryerHardware& hardware)
+    : hardware(hardware)
+    , enabled(false)
+    , samplesPerSecond(860)
+    , useReady(false)
+    , running(false)
+    , realtime(nullptr)
+    , readyTimeouts(0)
+    , transferErrors(0)
+    , startNs(0)
+{
+    // CV-worthy inputs first: RPM and vane height get 4x the pots' share
+    weights[ADC_CHAN_RPM] = 4;
+    weights[ADC_CHAN_DRUM_SIZE] = 1;
+    weights[ADC_CHAN_VANES] = 1;
+    weights[ADC_CHAN_VANE_HEIGHT] = 4;
+    for (double& p : pass) {
+        p = 0.0;
+    }
+}
+
+AdcScheduler::~AdcScheduler() {
+    stop();
+}
+
+void AdcScheduler::loadFromEnvironment() {
+    const char* value = std::getenv("DRYER_ADC");
+    if (!value || std::strcmp(value, "1") != 0) return;
+    enabled = true;
+
+    if (const char* text = std::getenv("DRYER_ADC_PRIORITY")) {
+        const char* entry = text;
+        while (entry && *entry) {
+            // input=weight
+            char name[16];
+            int weight = 0;
+            bool found = false;
+            if (std::sscanf(entry, "%15[^=]=%d", name, &weight) == 2) {
+                for (int i = 0; i < 4; i++) {
+                    if (std::strcmp(name, CHANNEL_NAMES[i]) == 0) {
+                        weights[NAME_CHANNELS[i]] = std::clamp(weight, 1, 100);
+                        found = true;
+                    }
+                }
+            }
+            if (!found) {
+                std::cerr << "WARNING: ignoring DRYER_ADC_PRIORITY entry " << entry << std::endl;
+            }
+
+            entry = std::strchr(entry, ',');
+            if (entry) entry++;
+        }
+    }
+
+    if (const char* text = std::getenv("DRYER_ADC_SPS")) {
+        // Next supported rate up
+        int requested = std::atoi(text);
+        samplesPerSecond = 860;
+        for (int rate : DATA_RATES) {
+            if (rate >= requested) {
+                samplesPerSecond = rate;
+                break;
+            }
+        }
+    }
+
+    const char* ready = std::getenv("DRYER_ADC_READY");
+    useReady = ready && std::strcmp(ready, "1") == 0;
+
+    std::cout << "ADC: " << samplesPerSecond << " SPS,";
+    for (int i = 0; i < 4; i++) {
+        std::cout << " " << CHANNEL_NAMES[i] << "=" << weights[NAME_CHANNELS[i]];
+    }
+    if (useReady) {
+        std::cout << ", ALERT/RDY on GPIO " << GPIO_ADC_READY;
+    }
+    std::cout << std::endl;
+}
+
+bool AdcScheduler::start(DryerRealtime* realtime) {
+    if (!enabled || running) return false;
+
+    if (!hardware.hasADC()) {
+        std::cerr << "WARNING: no ADS1115, CV inputs off" << std::endl;
+        enabled = false;
+        return false;
+    }
+    if (useReady && !hardware.enableADCReady()) {
+        std::cerr << "WARNING: ADC ready input GPIO " << GPIO_ADC_READY
+                  << " unavailable, timing conversions instead" << std::endl;
+        useReady = false;
+    }
+
+    this->realtime = realtime;
+    startNs = latencyNowNs();
+    running = true;
+    thread = std::thread(&AdcScheduler::run, this);
+
+    // Every input sampled once before anyone reads them
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(START_TIMEOUT_MS);
+    for (int i = 0; i < 4; i++) {
+        while (streams[i].count() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return true;
+}
+
+void AdcScheduler::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+int AdcScheduler::nextChannel() {
+    // Stride scheduling: the input furthest behind its share goes next
+    int channel = 0;
+    for (int i = 1; i < 4; i++) {
+        if (pass[i] < pass[channel]) channel = i;
+    }
+    pass[channel] += 1.0 / weights[channel];
+    return channel;
+}
+
+void AdcScheduler::run() {
+    if (realtime) {
+        realtime->enterThread(THREAD_ADC);
+    }
+
+    // Real time per conversion (a sped-up sim converts faster)
+    const double timeScale = hardware.timeScale();
+    const uint64_t conversionNs = static_cast<uint64_t>(1e9 / samplesPerSecond / timeScale);
+    const auto timedWait = std::chrono::nanoseconds(
+        static_cast<int64_t>(conversionNs * CONVERSION_MARGIN + WAKEUP_NS / timeScale));
+    const int readyTimeoutUs = static_cast<int>(2 * conversionNs / 1000) + 1000;
+
+    // Start the first conversion; there is nothing to read back yet
+    int channel = nextChannel();
+    uint16_t value = 0;
+    hardware.exchangeADC(channel, samplesPerSecond, value);
+    uint64_t startedNs = latencyNowNs();
+    uint64_t lastSampleNs = startedNs;
+
+    while (running) {
+        // Wait for the conversion: the ALERT/RDY edge, or its nominal time
+        bool waited = false;
+        if (useReady) {
+            int ready = hardware.waitADCReady(readyTimeoutUs);
+            if (ready == 0) {
+                readyTimeouts.fetch_add(1, std::memory_order_relaxed);
+            }
+            waited = ready >= 0;
+        }
+        if (!waited) {
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(startedNs)) + timedWait);
+        }
+
+        // Read it back and start the next one in the same transaction
+        int next = nextChannel();
+        bool ok = hardware.exchangeADC(next, samplesPerSecond, value);
+        uint64_t nowNs = latencyNowNs();
+        if (ok) {
+            // The chip integrates over the conversion: stamp its middle
+            streams[channel].push(startedNs + conversionNs / 2, value);
+        } else {
+            transferErrors.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(ERROR_BACKOFF_MS));
+        }
+        channel = next;
+        startedNs = nowNs;
+
+        if (realtime && nowNs - lastSampleNs >= 1000000000ULL) {
+            lastSampleNs = nowNs;
+            realtime->sampleThread(THREAD_ADC);
+        }
+    }
+}
+
+bool AdcScheduler::valueAt(int channel, uint64_t nowNs, float& value) const {
+    if (!running || channel < 0 || channel > 3) return false;
+
+    // One interval back there are samples on both sides to interpolate
+    const AdcStream& stream = streams[channel];
+    return stream.valueAt(nowNs - stream.intervalNs(), value);
+}
+
+const uint16_t* AdcScheduler::latestValues(uint16_t* values) const {
+    if (!running) return nullptr;
+    for (int i = 0; i < 4; i++) {
+        values[i] = streams[i].latest();
+    }
+    return values;
+}
+
+void AdcScheduler::report(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    double seconds = (latencyNowNs() - startNs) * 1e-9;
+    out << "=== Dryer ADC ===\n";
+    out << "rate: " << samplesPerSecond << " SPS, " << (useReady ? "ALERT/RDY" : "timed") << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (int i = 0; i < 4; i++) {
+        const AdcStream& stream = streams[NAME_CHANNELS[i]];
+        out << std::left << std::setw(7) << CHANNEL_NAMES[i] << std::right
+            << stream.count() << " samples, " << (seconds > 0.0 ? stream.count() / seconds : 0.0) << " Hz\n";
+    }
+    out << "ready timeouts: " << readyTimeouts.load(std::memory_order_relaxed)
+        << ", transfer errors: " << transferErrors.load(std::memory_order_relaxed) << "\n";
+    out.flags(flags);
+    out.precision(precision);
+}
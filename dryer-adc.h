@@ -0,0 +1,95 @@
+#ifndef DRYER_ADC_H
+#define DRYER_ADC_H
+
+#include "dryer-hardware.h"
+#include "dryer-realtime.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+// ============================================================================
+// DRYER ADC - The four ADS1115 inputs as CV, sampled at up to 860 SPS
+//   DRYER_ADC=1                run the scheduler (default: 20 Hz pot reads)
+//   DRYER_ADC_PRIORITY=rpm=4,height=4,drum=1,vanes=1
+//                              share of the conversions per input, 1..100;
+//                              every input keeps some, the knobs need them
+//   DRYER_ADC_SPS=860          ADS1115 data rate
+//   DRYER_ADC_READY=1          ALERT/RDY is wired to GPIO_ADC_READY: wait for
+//                              its edge instead of the nominal conversion time
+//
+// One single-shot conversion at a time, channels picked by stride
+// scheduling so each gets its share of the data rate. Reading a result and
+// starting the next conversion is one combined I2C transaction. Every
+// sample is timestamped; physics interpolates RPM and vane height per step
+// one sample interval behind, so the modulation is smooth at LFO rates.
+// ============================================================================
+
+// Timestamped samples of one input; one writer, any number of readers
+class AdcStream {
+public:
+    AdcStream();
+
+    void push(uint64_t timeNs, uint16_t value);
+
+    // Raw code at timeNs, linear between the samples around it and held
+    // past the newest; false before the first sample
+    bool valueAt(uint64_t timeNs, float& value) const;
+
+    uint16_t latest() const;
+    uint64_t intervalNs() const;    // between the last two samples
+    uint64_t count() const { return written.load(std::memory_order_acquire); }
+
+private:
+    static constexpr int SIZE = 16;
+
+    std::atomic<uint64_t> times[SIZE];
+    std::atomic<uint16_t> values[SIZE];
+    std::atomic<uint64_t> written;
+};
+
+class AdcScheduler {
+public:
+    AdcScheduler(DryerHardware& hardware);
+    ~AdcScheduler();
+
+    void loadFromEnvironment();
+    bool isEnabled() const { return enabled; }
+
+    // False (and disabled) without an ADS1115
+    bool start(DryerRealtime* realtime = nullptr);
+    void stop();
+
+    // Channel value for a physics step at nowNs, interpolated one sample
+    // interval back; false until the channel has samples
+    bool valueAt(int channel, uint64_t nowNs, float& value) const;
+
+    // Newest raw code of every channel (mid-scale if none yet), for
+    // DryerHardware::readParameters
+    const uint16_t* latestValues(uint16_t* values) const;
+
+    void report(std::ostream& out) const;
+
+private:
+    DryerHardware& hardware;
+    bool enabled;
+    int samplesPerSecond;
+    bool useReady;
+    int weights[4];
+    double pass[4];             // stride scheduling: lowest goes next
+
+    AdcStream streams[4];
+
+    std::thread thread;
+    std::atomic<bool> running;
+    DryerRealtime* realtime;
+
+    std::atomic<uint64_t> readyTimeouts;
+    std::atomic<uint64_t> transferErrors;
+    uint64_t startNs;
+
+    void run();
+    int nextChannel();
+};
+
+#endif // DRYER_ADC_H
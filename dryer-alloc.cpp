@@ -0,0 +1,68 @@
+#include "dryer-alloc.h"
+
+#ifdef DRYER_ALLOC_CHECK
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+static std::atomic<uint64_t> g_allocations(0);
+static std::atomic<uint64_t> g_violations(0);
+static std::atomic<bool> g_strict(false);
+
+static thread_local bool t_armed = false;
+
+static void* countedAlloc(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (t_armed) {
+        g_violations.fetch_add(1, std::memory_order_relaxed);
+        if (g_strict.load(std::memory_order_relaxed)) {
+            // No iostream here: it could allocate and recurse
+            static const char msg[] = "DRYER_ALLOC_CHECK: heap allocation on a realtime thread in steady state\n";
+            ssize_t ignored = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+            (void)ignored;
+            std::abort();
+        }
+    }
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace DryerAlloc {
+
+    bool trackingEnabled() { return true; }
+    uint64_t allocationCount() { return g_allocations.load(std::memory_order_relaxed); }
+    uint64_t violationCount() { return g_violations.load(std::memory_order_relaxed); }
+    void setStrict(bool strict) { g_strict = strict; }
+    void armThread() { t_armed = true; }
+    void disarmThread() { t_armed = false; }
+
+}
+
+#else
+
+namespace DryerAlloc {
+
+    bool trackingEnabled() { return false; }
+    uint64_t allocationCount() { return 0; }
+    uint64_t violationCount() { return 0; }
+    void setStrict(bool) {}
+    void armThread() {}
+    void disarmThread() {}
+
+}
+
+#endif // DRYER_ALLOC_CHECK
@@ -0,0 +1,38 @@
+#ifndef DRYER_ALLOC_H
+#define DRYER_ALLOC_H
+
+#include <cstdint>
+
+// ============================================================================
+// DRYER ALLOCATION CHECK - Debug hook for the zero-allocation steady state
+// Build with -DDRYER_ALLOC_CHECK (cmake -DDRYER_ALLOC_CHECK=ON, or
+// make ALLOC_CHECK=1) to replace global operator new with a counting one.
+// A thread that has been armed counts every allocation it makes as a
+// violation; in strict mode (DRYER_ALLOC_STRICT=1 for the app) the first
+// one aborts with a message, which fails any run that exercises it. The
+// app also exits 1 if any were counted; make check-alloc and ctest run it
+// headless (sim hardware, memory renderer) to catch regressions.
+// Without the define every call here is a no-op returning 0.
+// ============================================================================
+
+namespace DryerAlloc {
+
+    // True when the counting operator new is compiled in
+    bool trackingEnabled();
+
+    // Total operator new calls since process start
+    uint64_t allocationCount();
+
+    // Allocations made on armed threads
+    uint64_t violationCount();
+
+    // Abort on the first violation instead of only counting
+    void setStrict(bool strict);
+
+    // Arm/disarm the calling thread (call once warm-up is done)
+    void armThread();
+    void disarmThread();
+
+}
+
+#endif // DRYER_ALLOC_H
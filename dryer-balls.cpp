@@ -0,0 +1,142 @@
+#include "dryer-balls.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static const float AIR_DENSITY = 1.225f;    // kg/m³
+
+static const int BUILTIN_COUNT = 5;
+
+// Built on first use: DryerPhysics objects may be constructed statically
+static const BallPreset* builtinPresets() {
+    static const BallPreset presets[BUILTIN_COUNT] = {
+        BallPreset::make("tennis",    0.035f, 0.058f,  0.75f, 0.55f, false),
+        BallPreset::make("balloon",   0.075f, 0.001f,  0.10f, 0.47f, false),
+        BallPreset::make("ping-pong", 0.020f, 0.0027f, 0.89f, 0.50f, true),
+        BallPreset::make("rubber",    0.030f, 0.050f,  0.85f, 0.47f, true),
+        BallPreset::make("steel",     0.025f, 0.514f,  0.60f, 0.47f, true),
+    };
+    return presets;
+}
+
+BallPreset BallPreset::make(const char* name, float radius, float mass, float restitution,
+                            float dragCoeff, bool quadraticDrag) {
+    BallPreset preset;
+    std::snprintf(preset.name, sizeof(preset.name), "%s", name);
+    preset.radius = radius;
+    preset.mass = mass;
+    preset.restitution = restitution;
+    preset.dragCoeff = dragCoeff;
+    preset.quadraticDrag = quadraticDrag;
+
+    float area = static_cast<float>(M_PI) * radius * radius;
+    preset.inverseMass = 1.0f / mass;
+    preset.bounce = 1.0f + restitution;
+    preset.dragFactor = 0.5f * AIR_DENSITY * dragCoeff * area * preset.inverseMass;
+    return preset;
+}
+
+const BallPreset* builtinBallPreset(const char* name) {
+    const BallPreset* presets = builtinPresets();
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        if (std::strcmp(presets[i].name, name) == 0) return &presets[i];
+    }
+    return nullptr;
+}
+
+BallLibrary::BallLibrary()
+    : offIndex(0)
+    , onIndex(1)
+{
+    const BallPreset* builtins = builtinPresets();
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        presets.push_back(builtins[i]);
+    }
+}
+
+void BallLibrary::loadFromEnvironment() {
+    if (const char* path = std::getenv("DRYER_BALLS")) {
+        loadFile(path);
+    }
+
+    if (const char* value = std::getenv("DRYER_BALL")) {
+        // off[,on]
+        char names[2][16] = {"", ""};
+        std::sscanf(value, "%15[^,],%15s", names[0], names[1]);
+        int* indices[2] = {&offIndex, &onIndex};
+        for (int i = 0; i < 2; i++) {
+            if (!names[i][0]) continue;
+            int index = indexOf(names[i]);
+            if (index < 0) {
+                std::cerr << "WARNING: unknown ball preset in DRYER_BALL: " << names[i] << std::endl;
+                continue;
+            }
+            *indices[i] = index;
+        }
+        std::cout << "Balls: " << presets[offIndex].name << " (switch off), "
+                  << presets[onIndex].name << " (switch on)" << std::endl;
+    }
+}
+
+bool BallLibrary::loadFile(const char* path) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        std::cerr << "WARNING: cannot open ball presets " << path << std::endl;
+        return false;
+    }
+
+    char line[128];
+    int lineNumber = 0;
+    int loaded = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        if (char* comment = std::strchr(line, '#')) {
+            *comment = '\0';
+        }
+
+        // name radius_cm mass_g restitution drag_coeff [linear|quadratic]
+        char name[16];
+        float radiusCm, massG, restitution, dragCoeff;
+        char drag[16] = "linear";
+        int fields = std::sscanf(line, "%15s %f %f %f %f %15s", name, &radiusCm, &massG,
+                                 &restitution, &dragCoeff, drag);
+        if (fields <= 0) continue;
+
+        bool quadratic = std::strcmp(drag, "quadratic") == 0;
+        if (fields < 5 || radiusCm <= 0.0f || massG <= 0.0f || restitution < 0.0f || restitution > 1.0f ||
+            dragCoeff < 0.0f || (!quadratic && std::strcmp(drag, "linear") != 0)) {
+            std::cerr << "WARNING: " << path << ":" << lineNumber << ": bad ball preset" << std::endl;
+            continue;
+        }
+
+        BallPreset preset = BallPreset::make(name, radiusCm / 100.0f, massG / 1000.0f,
+                                             restitution, dragCoeff, quadratic);
+        int index = indexOf(name);
+        if (index >= 0) {
+            presets[index] = preset;
+        } else if (!presets.push_back(preset)) {
+            std::cerr << "WARNING: " << path << ":" << lineNumber << ": more than "
+                      << MAX_PRESETS << " ball presets" << std::endl;
+            continue;
+        }
+        loaded++;
+    }
+    std::fclose(file);
+
+    std::cout << "Balls: " << loaded << " presets from " << path << std::endl;
+    return true;
+}
+
+int BallLibrary::indexOf(const char* name) const {
+    for (size_t i = 0; i < presets.size(); i++) {
+        if (std::strcmp(presets[i].name, name) == 0) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const BallPreset* BallLibrary::find(const char* name) const {
+    int index = indexOf(name);
+    return index >= 0 ? &presets[index] : nullptr;
+}
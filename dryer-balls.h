@@ -0,0 +1,62 @@
+#ifndef DRYER_BALLS_H
+#define DRYER_BALLS_H
+
+#include "dryer-fixed-vector.h"
+
+// ============================================================================
+// DRYER BALLS - Ball presets for the ball type switch
+//   DRYER_BALLS=/etc/dryer/balls.txt   extra presets, one per line:
+//       name radius_cm mass_g restitution drag_coeff [linear|quadratic]
+//     e.g. "squash 2.0 24 0.40 0.50 quadratic"; '#' starts a comment, and a
+//     name that is already known replaces that preset
+//   DRYER_BALL=tennis,balloon          presets for switch off, on
+//
+// Built in: tennis, balloon, ping-pong, rubber, steel. Everything the step
+// needs per ball (impulse factor, inverse mass, drag per v²) is worked out
+// when a preset is made, so switching balls is a copy at a step boundary.
+// ============================================================================
+
+struct BallPreset {
+    char name[16];
+    float radius;           // meters
+    float mass;             // kg
+    float restitution;      // 0-1
+    float dragCoeff;        // Cd
+    bool quadraticDrag;     // false = the original fixed linear damping
+
+    // Derived
+    float inverseMass;      // 1/kg
+    float bounce;           // 1 + restitution, the collision impulse factor
+    float dragFactor;       // 0.5·ρ·Cd·A/m: quadratic drag accel = dragFactor·v²
+
+    static BallPreset make(const char* name, float radius, float mass, float restitution,
+                           float dragCoeff, bool quadraticDrag);
+};
+
+// Built-in preset by name; nullptr if unknown
+const BallPreset* builtinBallPreset(const char* name);
+
+class BallLibrary {
+public:
+    static constexpr int MAX_PRESETS = 16;
+
+    BallLibrary();
+
+    // DRYER_BALLS file, then DRYER_BALL
+    void loadFromEnvironment();
+    bool loadFile(const char* path);
+
+    const BallPreset* find(const char* name) const;
+
+    // Preset for the ball type switch position
+    const BallPreset& forSwitch(bool on) const { return presets[on ? onIndex : offIndex]; }
+
+private:
+    FixedVector<BallPreset, MAX_PRESETS> presets;
+    int offIndex;
+    int onIndex;
+
+    int indexOf(const char* name) const;
+};
+
+#endif // DRYER_BALLS_H
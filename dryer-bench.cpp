@@ -0,0 +1,663 @@
+#include "dryer-physics.h"
+#include "dryer-reference.h"
+#include "dryer-renderer.h"
+#include "dryer-image.h"
+#include "pins.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// ============================================================================
+// DRYER BENCH - Headless rendering benchmark and golden-image check
+// Renders a fixed set of physics scenes into the in-memory framebuffer; no
+// display, GPIO or MIDI needed. --physics times the physics step instead,
+// every feature-toggle combination with the specialized kernel against
+// runtime dispatch. --fixed runs each scene's physics for a while with the
+// float and the fixed-point step, checks that both give about as many
+// audible hits and that the fixed-point hits hash to the committed value,
+// the same on every machine; exits 1 otherwise. --diff runs random
+// scenarios through the step and the frozen reference engine
+// (dryer-reference.h) and reports where they first part; exits 1 if any do.
+//
+//   dryer-bench [--frames N] [--full-repaint]
+//               [--dump DIR] [--golden DIR] [--update-golden DIR] [--tolerance N]
+//   dryer-bench --physics [--steps N]
+//   dryer-bench --fixed [--seconds N]
+//   dryer-bench --diff [--scenarios N] [--seed N] [--seconds N] [--kernel runtime|fixed]
+// ============================================================================
+
+static const int CANVAS_SIZE = 480;
+static const float STEP_DT = 1.0f / PHYSICS_RATE_HZ;
+static const int STEPS_PER_FRAME = PHYSICS_RATE_HZ / DISPLAY_FPS;
+
+struct BenchScene {
+    const char* name;
+    float rpm;
+    float drumSize;         // cm
+    int vanes;
+    float vaneHeight;       // percent
+    bool balloon;
+    bool lintTrap;
+    bool moonGravity;
+    int warmupSteps;        // physics steps before the first frame
+    int drums;              // polyrhythm mode, RPM ratios from DRUM_RATIOS
+};
+
+static const float DRUM_RATIOS[MAX_DRUMS] = {1.0f, 1.5f, 0.75f, 1.25f};
+
+static const BenchScene SCENES[] = {
+    {"tennis-3-vanes",   20.0f,  80.0f, 3, 30.0f, false, false, false, 480,  1},
+    {"tennis-9-vanes",   40.0f,  60.0f, 9, 20.0f, false, false, false, 720,  1},
+    {"balloon-5-vanes",  10.0f, 100.0f, 5, 50.0f, true,  false, false, 960,  1},
+    {"moon-lint-trap",   30.0f,  70.0f, 6, 40.0f, false, true,  true,  600,  1},
+    {"slow-drum",         1.0f,  90.0f, 4, 10.0f, false, false, false, 1200, 1},
+    {"stopped-drum",      0.0f,  80.0f, 6, 30.0f, false, false, false, 1200, 1},
+    {"polyrhythm-3",     20.0f,  80.0f, 4, 30.0f, false, false, false, 480,  3},
+};
+
+// --fixed: hash of each scene's fixed-point hits over FIXED_HASH_SECONDS.
+// The step is integer-only, so these hold on every machine; a change meant
+// to alter the fixed-point rhythm output updates them in the same commit.
+static const double FIXED_HASH_SECONDS = 60.0;
+static const uint64_t FIXED_HIT_HASHES[] = {
+    0x5e0b30d94915edbaULL,  // tennis-3-vanes
+    0xa8adb39e529531d6ULL,  // tennis-9-vanes
+    0xf3d018cd27ed2564ULL,  // balloon-5-vanes
+    0xa539115cbccf43cbULL,  // moon-lint-trap
+    0x7ae6931026e706a9ULL,  // slow-drum
+    0x7e06ee7570da01faULL,  // stopped-drum
+    0xd41e4ca452fd89d3ULL,  // polyrhythm-3
+};
+static_assert(sizeof(FIXED_HIT_HASHES) / sizeof(FIXED_HIT_HASHES[0]) == sizeof(SCENES) / sizeof(SCENES[0]),
+              "one fixed-point hash per scene");
+
+// --fixed: float and fixed-point hit counts, counting hits faster than
+// FIXED_COMPARE_SPEED, may differ by this fraction (or FIXED_COMPARE_SLACK
+// hits). Slower ones are corner chatter, which Q16.16 resolves differently.
+static const float FIXED_COMPARE_SPEED = 0.05f;    // m/s
+static const double FIXED_COUNT_TOLERANCE = 0.15;
+static const int FIXED_COMPARE_SLACK = 3;
+
+struct BenchOptions {
+    int frames;
+    bool physics;
+    int steps;
+    bool fixedPoint;
+    bool diff;
+    int scenarios;
+    uint32_t seed;
+    const char* kernel;     // --diff: step kernel under test
+    double seconds;
+    bool fullRepaint;
+    const char* dumpDir;
+    const char* goldenDir;
+    bool updateGolden;
+    int tolerance;
+};
+
+static void setupScene(DryerPhysics* drums, const BenchScene& scene) {
+    for (int drum = 0; drum < scene.drums; drum++) {
+        DryerPhysics& physics = drums[drum];
+        physics.setParameters(scene.rpm * DRUM_RATIOS[drum], scene.drumSize, scene.vanes, scene.vaneHeight);
+        physics.setBall(*builtinBallPreset(scene.balloon ? "balloon" : "tennis"));
+        physics.setLintTrap(scene.lintTrap);
+        physics.setMoonGravity(scene.moonGravity);
+
+        for (int i = 0; i < scene.warmupSteps; i++) {
+            physics.step(STEP_DT);
+        }
+    }
+}
+
+static std::string scenePath(const char* dir, const BenchScene& scene, const char* extension) {
+    return std::string(dir) + "/" + scene.name + extension;
+}
+
+// One frame from a fresh renderer with fixed highlights: identical on every run
+static bool checkScene(const BenchScene& scene, const BenchOptions& options) {
+    DryerPhysics drums[MAX_DRUMS];
+    setupScene(drums, scene);
+
+    DryerRenderer renderer(CANVAS_SIZE, CANVAS_SIZE);
+    if (!renderer.initialize(false, RENDER_MEMORY)) {
+        return false;
+    }
+
+    renderer.highlightCollision(DryerPhysics::surfaceSlot(0, SURFACE_DRUM));
+    renderer.highlightCollision(DryerPhysics::surfaceSlot(scene.vanes - 1, SURFACE_VANE_LEADING));
+    renderer.render(drums, scene.drums);
+
+    auto* target = static_cast<MemoryFramebufferTarget*>(renderer.getFramebufferTarget());
+    Framebuffer frame = target->frontBuffer();
+    bool ok = true;
+
+    if (options.dumpDir) {
+        ok = writeImage(scenePath(options.dumpDir, scene, ".png").c_str(), frame) && ok;
+    }
+
+    if (options.goldenDir) {
+        std::string path = scenePath(options.goldenDir, scene, ".ppm");
+
+        if (options.updateGolden) {
+            ok = writePPM(path.c_str(), frame) && ok;
+            std::cout << "  golden " << scene.name << ": written" << std::endl;
+        } else {
+            Image golden;
+            if (!readPPM(path.c_str(), golden)) {
+                std::cout << "  golden " << scene.name << ": MISSING " << path << std::endl;
+                ok = false;
+            } else {
+                ImageDiff diff = compareImages(frame, golden, options.tolerance);
+                bool match = diff.differentPixels == 0;
+                std::cout << "  golden " << scene.name << ": " << (match ? "ok" : "DIFFERENT")
+                          << " (" << diff.differentPixels << " pixels, max delta "
+                          << diff.maxChannelDelta << ")" << std::endl;
+                ok = match && ok;
+            }
+        }
+    }
+
+    renderer.shutdown();
+    return ok;
+}
+
+// N animated frames; physics advances as it would at DISPLAY_FPS
+static void benchScene(const BenchScene& scene, const BenchOptions& options) {
+    DryerPhysics drums[MAX_DRUMS];
+    setupScene(drums, scene);
+
+    DryerRenderer renderer(CANVAS_SIZE, CANVAS_SIZE);
+    if (!renderer.initialize(false, RENDER_MEMORY)) {
+        return;
+    }
+
+    double dirtySum = 0.0;
+    int surfaceCount = static_cast<int>(drums[0].getSurfaces().size());
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        for (int drum = 0; drum < scene.drums; drum++) {
+            for (int i = 0; i < STEPS_PER_FRAME; i++) {
+                drums[drum].step(STEP_DT);
+            }
+        }
+
+        // A hit every quarter second keeps the highlight path busy
+        if (frame % (DISPLAY_FPS / 4) == 0) {
+            renderer.highlightCollision(drums[0].getSurfaces()[frame % surfaceCount].slot,
+                                        frame % scene.drums);
+        }
+
+        if (options.fullRepaint) {
+            renderer.invalidate();
+        }
+
+        renderer.render(drums, scene.drums);
+        dirtySum += renderer.getDirtyFraction();
+    }
+
+    const RenderProfile& profile = renderer.getProfile();
+    double frames = static_cast<double>(profile.frames);
+    double total = 0.0;
+
+    std::cout << "  " << std::left << std::setw(18) << scene.name << std::right;
+    for (int stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+        double ms = profile.stageNs[stage] / frames / 1e6;
+        total += ms;
+        std::cout << std::setw(9) << ms;
+    }
+    std::cout << std::setw(9) << total << std::setw(8) << std::setprecision(1)
+              << (100.0 * dirtySum / frames) << std::setprecision(3) << std::endl;
+
+    renderer.shutdown();
+}
+
+// ns per physics step for one feature mask, specialized or not
+static double timeStep(unsigned features, bool specialized, int steps) {
+    DryerPhysics physics;
+    physics.setParameters(40.0f, 60.0f, 9, 20.0f);
+    physics.setStepFeatures(features);
+    physics.setSpecializedStep(specialized);
+
+    int hits = 0;
+    physics.onCollision([&hits](const Surface&, float) { hits++; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) {
+        physics.step(STEP_DT);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / steps;
+}
+
+static std::string featureNames(unsigned features) {
+    static const char* NAMES[] = {"centrifugal", "coriolis", "drag", "quadratic", "lint"};
+    std::string names;
+    for (int bit = 0; bit < 5; bit++) {
+        if (features & (1u << bit)) {
+            names += names.empty() ? "" : "+";
+            names += NAMES[bit];
+        }
+    }
+    return names.empty() ? "none" : names;
+}
+
+static void benchPhysics(const BenchOptions& options) {
+    std::cout << "Physics step, " << options.steps << " steps per feature mask (ns/step)" << std::endl;
+    std::cout << "  " << std::left << std::setw(40) << "features" << std::right
+              << std::setw(10) << "runtime" << std::setw(12) << "specialized"
+              << std::setw(9) << "speedup" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1);
+    double runtimeSum = 0.0;
+    double specializedSum = 0.0;
+    for (unsigned features = 0; features < STEP_FEATURE_COUNT; features++) {
+        // Quadratic drag only means something with drag on
+        if ((features & STEP_QUADRATIC_DRAG) && !(features & STEP_AIR_DRAG)) continue;
+
+        double runtime = timeStep(features, false, options.steps);
+        double specialized = timeStep(features, true, options.steps);
+        runtimeSum += runtime;
+        specializedSum += specialized;
+        std::cout << "  " << std::left << std::setw(40) << featureNames(features) << std::right
+                  << std::setw(10) << runtime << std::setw(12) << specialized
+                  << std::setw(8) << std::setprecision(2) << runtime / specialized << "x"
+                  << std::setprecision(1) << std::endl;
+    }
+    std::cout << "  " << std::left << std::setw(40) << "all" << std::right
+              << std::setw(10) << runtimeSum << std::setw(12) << specializedSum
+              << std::setw(8) << std::setprecision(2) << runtimeSum / specializedSum << "x" << std::endl;
+}
+
+// The setters announce themselves on stdout; not wanted per run
+struct QuietStdout {
+    std::streambuf* saved;
+    QuietStdout() : saved(std::cout.rdbuf(nullptr)) {}
+    ~QuietStdout() {
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+    }
+};
+
+// A run's hits: step and surface, plus an FNV-1a hash that also covers the
+// velocities' bits
+struct HitLog {
+    std::vector<std::pair<int, int>> hits;
+    int fastHits = 0;       // faster than FIXED_COMPARE_SPEED
+    uint64_t hash = 1469598103934665603ULL;
+    int step = 0;
+
+    void add(int slot, float velocity) {
+        hits.emplace_back(step, slot);
+        if (velocity > FIXED_COMPARE_SPEED) {
+            fastHits++;
+        }
+        uint32_t bits;
+        std::memcpy(&bits, &velocity, sizeof(bits));
+        uint32_t words[3] = {static_cast<uint32_t>(step), static_cast<uint32_t>(slot), bits};
+        for (uint32_t word : words) {
+            for (int byte = 0; byte < 4; byte++) {
+                hash = (hash ^ ((word >> (8 * byte)) & 0xff)) * 1099511628211ULL;
+            }
+        }
+    }
+};
+
+// One scene's drum 0 for options.seconds from reset, float vs fixed-point
+// step, both with resting contact as the app runs them. False if the
+// audible hit counts are too far apart or the hash is not the expected one.
+static bool benchFixed(int index, const BenchOptions& options) {
+    const BenchScene& scene = SCENES[index];
+    HitLog logs[2];
+    double ns[2];
+    int steps = static_cast<int>(options.seconds * PHYSICS_RATE_HZ);
+
+    for (int mode = 0; mode < 2; mode++) {
+        DryerPhysics physics;
+        HitLog& log = logs[mode];
+        {
+            QuietStdout quiet;
+            physics.setFixedPoint(mode == 1);
+            setupScene(&physics, BenchScene{scene.name, scene.rpm, scene.drumSize, scene.vanes, scene.vaneHeight,
+                                            scene.balloon, scene.lintTrap, scene.moonGravity, 0, 1});
+        }
+        physics.onCollision([&log](const Surface& surface, float velocity) { log.add(surface.slot, velocity); });
+
+        auto start = std::chrono::steady_clock::now();
+        for (log.step = 0; log.step < steps; log.step++) {
+            physics.step(STEP_DT);
+        }
+        ns[mode] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / steps;
+    }
+
+    // Leading hits that agree: same surface within a couple of steps
+    size_t same = 0;
+    while (same < logs[0].hits.size() && same < logs[1].hits.size() &&
+           logs[0].hits[same].second == logs[1].hits[same].second &&
+           std::abs(logs[0].hits[same].first - logs[1].hits[same].first) <= 2) {
+        same++;
+    }
+
+    int difference = std::abs(logs[0].fastHits - logs[1].fastHits);
+    bool countsOk = difference <= std::max(static_cast<double>(FIXED_COMPARE_SLACK),
+                                           FIXED_COUNT_TOLERANCE * std::max(logs[0].fastHits, logs[1].fastHits));
+    bool checkHash = options.seconds == FIXED_HASH_SECONDS;
+    bool hashOk = !checkHash || logs[1].hash == FIXED_HIT_HASHES[index];
+
+    std::cout << "  " << std::left << std::setw(18) << scene.name << std::right
+              << std::setw(8) << logs[0].hits.size() << std::setw(8) << logs[1].hits.size()
+              << std::setw(8) << logs[0].fastHits << std::setw(8) << logs[1].fastHits
+              << std::setw(8) << same << std::setw(10) << ns[0] << std::setw(10) << ns[1]
+              << "  " << std::hex << std::setfill('0') << std::setw(16) << logs[1].hash
+              << std::dec << std::setfill(' ') << "  ";
+    if (!countsOk) {
+        std::cout << "COUNTS DIFFER";
+    } else if (!hashOk) {
+        std::cout << "HASH DIFFERS (expected " << std::hex << std::setfill('0') << std::setw(16)
+                  << FIXED_HIT_HASHES[index] << std::dec << std::setfill(' ') << ")";
+    } else {
+        std::cout << "ok";
+    }
+    std::cout << std::endl;
+    return countsOk && hashOk;
+}
+
+// --diff tolerances: ball position every step, velocity of each hit
+static const float DIFF_POSITION_TOLERANCE = 1e-4f;    // m
+static const float DIFF_VELOCITY_TOLERANCE = 1e-3f;    // m/s
+
+static const char* const DIFF_BALLS[] = {"tennis", "balloon", "ping-pong", "rubber", "steel"};
+
+struct DiffScenario {
+    float rpm;
+    float drumSize;         // cm
+    int vanes;
+    float vaneHeight;       // percent
+    const char* ball;
+    bool lintTrap;
+    bool moonGravity;
+    bool centrifugal;
+    bool coriolis;
+    bool airDrag;
+    bool contactSleep;
+    float x, y;             // starting state
+    float vx, vy;
+
+    // Knobs turned mid-run (at that fraction of it), morphing over morphTime
+    bool change;
+    float changeAt;
+    float morphTime;        // s, 0 = at once
+    float newRpm, newDrumSize, newVaneHeight;
+    int newVanes;
+};
+
+// mt19937 output is the same everywhere, the standard distributions are not
+static float uniform(std::mt19937& rng, float low, float high) {
+    return low + (high - low) * static_cast<float>(rng() / 4294967296.0);
+}
+
+static bool chance(std::mt19937& rng, float probability) {
+    return uniform(rng, 0.0f, 1.0f) < probability;
+}
+
+static DiffScenario randomScenario(std::mt19937& rng) {
+    DiffScenario scenario;
+    scenario.rpm = chance(rng, 0.1f) ? 0.0f : uniform(rng, 1.0f, 40.0f);
+    scenario.drumSize = uniform(rng, 60.0f, 100.0f);
+    scenario.vanes = 1 + static_cast<int>(rng() % 9);
+    scenario.vaneHeight = uniform(rng, 10.0f, 50.0f);
+    scenario.ball = DIFF_BALLS[rng() % 5];
+    scenario.lintTrap = chance(rng, 0.5f);
+    scenario.moonGravity = chance(rng, 0.25f);
+    scenario.centrifugal = chance(rng, 0.8f);
+    scenario.coriolis = chance(rng, 0.8f);
+    scenario.airDrag = chance(rng, 0.8f);
+    scenario.contactSleep = chance(rng, 0.8f);
+
+    // Anywhere well inside the drum, at up to 2 m/s
+    float radius = uniform(rng, 0.0f, 0.5f) * scenario.drumSize / 100.0f;
+    float angle = uniform(rng, 0.0f, 2.0f * M_PI);
+    scenario.x = radius * std::cos(angle);
+    scenario.y = radius * std::sin(angle);
+    scenario.vx = uniform(rng, -2.0f, 2.0f);
+    scenario.vy = uniform(rng, -2.0f, 2.0f);
+
+    // Half of them change course; a smaller drum carries the ball in
+    scenario.change = chance(rng, 0.5f);
+    scenario.changeAt = uniform(rng, 0.1f, 0.6f);
+    scenario.morphTime = chance(rng, 0.25f) ? 0.0f : uniform(rng, 0.1f, 3.0f);
+    scenario.newRpm = chance(rng, 0.1f) ? 0.0f : uniform(rng, 1.0f, 40.0f);
+    scenario.newDrumSize = uniform(rng, 60.0f, 100.0f);
+    scenario.newVanes = chance(rng, 0.5f) ? scenario.vanes : 1 + static_cast<int>(rng() % 9);
+    scenario.newVaneHeight = uniform(rng, 10.0f, 50.0f);
+    return scenario;
+}
+
+// One scenario through DryerPhysics and ReferencePhysics in lockstep; false
+// at the first step where the ball or the hits differ
+static bool diffScenario(int number, const DiffScenario& scenario, const BenchOptions& options) {
+    const BallPreset& preset = *builtinBallPreset(scenario.ball);
+    DryerPhysics physics;
+    ReferencePhysics reference;
+    {
+        QuietStdout quiet;
+        physics.setFixedPoint(std::strcmp(options.kernel, "fixed") == 0);
+        physics.setSpecializedStep(std::strcmp(options.kernel, "runtime") != 0);
+        physics.setParameters(scenario.rpm, scenario.drumSize, scenario.vanes, scenario.vaneHeight);
+        physics.setBall(preset);
+        physics.setMoonGravity(scenario.moonGravity);
+        physics.setStepFeatures((scenario.centrifugal ? STEP_CENTRIFUGAL : 0u) |
+                                (scenario.coriolis ? STEP_CORIOLIS : 0u) |
+                                (scenario.airDrag ? STEP_AIR_DRAG : 0u) |
+                                (preset.quadraticDrag ? STEP_QUADRATIC_DRAG : 0u) |
+                                (scenario.lintTrap ? STEP_LINT_TRAP : 0u));
+        physics.setContactSleep(scenario.contactSleep);
+        physics.setBallState(scenario.x, scenario.y, scenario.vx, scenario.vy);
+        physics.setMorphTime(scenario.morphTime);
+    }
+    reference.setParameters(scenario.rpm, scenario.drumSize, scenario.vanes, scenario.vaneHeight);
+    reference.setBall(preset);
+    reference.setMoonGravity(scenario.moonGravity);
+    reference.setFeatures(scenario.centrifugal, scenario.coriolis, scenario.airDrag);
+    reference.setLintTrap(scenario.lintTrap);
+    reference.setContactSleep(scenario.contactSleep);
+    reference.setBallState(scenario.x, scenario.y, scenario.vx, scenario.vy);
+    reference.setMorphTime(scenario.morphTime);
+
+    std::vector<ReferenceHit> hits;
+    physics.onCollision([&hits](const Surface& surface, float velocity) {
+        hits.push_back(ReferenceHit{surface.slot, velocity});
+    });
+
+    std::cout << "  " << std::setw(3) << number << "  " << std::setw(4) << scenario.rpm << " rpm "
+              << std::setw(3) << static_cast<int>(scenario.drumSize) << " cm " << scenario.vanes << " vanes "
+              << std::setw(2) << static_cast<int>(scenario.vaneHeight) << "%  " << std::left << std::setw(10)
+              << scenario.ball << std::right << (scenario.lintTrap ? "lint " : "") << (scenario.moonGravity ? "moon " : "")
+              << (scenario.contactSleep ? "" : "no-sleep ");
+    if (scenario.change) {
+        std::cout << "-> " << std::setw(4) << scenario.newRpm << " rpm " << static_cast<int>(scenario.newDrumSize)
+                  << " cm " << scenario.newVanes << " vanes " << static_cast<int>(scenario.newVaneHeight) << "% over "
+                  << scenario.morphTime << " s ";
+    }
+    std::cout << ": ";
+
+    const auto& surfaces = physics.getSurfaces();
+    int steps = static_cast<int>(options.seconds * PHYSICS_RATE_HZ);
+    int changeStep = scenario.change ? static_cast<int>(scenario.changeAt * steps) : -1;
+    int hitCount = 0;
+    for (int step = 0; step < steps; step++) {
+        if (step == changeStep) {
+            physics.setParameters(scenario.newRpm, scenario.newDrumSize, scenario.newVanes, scenario.newVaneHeight);
+            reference.setParameters(scenario.newRpm, scenario.newDrumSize, scenario.newVanes,
+                                    scenario.newVaneHeight);
+        }
+        hits.clear();
+        physics.step(STEP_DT);
+        reference.step(STEP_DT);
+        double time = (step + 1) * static_cast<double>(STEP_DT);
+
+        const ReferenceHit* expected = reference.getHits().begin();
+        size_t count = std::max(hits.size(), reference.getHits().size());
+        for (size_t i = 0; i < count; i++, hitCount++) {
+            bool mine = i < hits.size();
+            bool theirs = i < reference.getHits().size();
+            if (mine && theirs && hits[i].slot == expected[i].slot &&
+                std::abs(hits[i].velocity - expected[i].velocity) <= DIFF_VELOCITY_TOLERANCE) {
+                continue;
+            }
+            std::cout << "DIVERGES at " << std::setprecision(3) << time << " s, hit " << hitCount << ": ";
+            if (mine) {
+                std::cout << surfaces[hits[i].slot].id << " " << hits[i].velocity << " m/s";
+            } else {
+                std::cout << "none";
+            }
+            std::cout << ", reference ";
+            if (theirs) {
+                std::cout << surfaces[expected[i].slot].id << " " << expected[i].velocity << " m/s";
+            } else {
+                std::cout << "none";
+            }
+            std::cout << std::setprecision(1) << std::endl;
+            return false;
+        }
+
+        const Ball& ball = physics.getBall();
+        float error = std::max(std::abs(ball.x - reference.getBall().x), std::abs(ball.y - reference.getBall().y));
+        if (!(error <= DIFF_POSITION_TOLERANCE)) {
+            std::cout << "DIVERGES at " << std::setprecision(3) << time << " s, ball off by "
+                      << error * 1000.0f << " mm after " << hitCount << " hits" << std::setprecision(1) << std::endl;
+            return false;
+        }
+    }
+    std::cout << "ok, " << hitCount << " hits" << std::endl;
+    return true;
+}
+
+static bool benchDiff(const BenchOptions& options) {
+    std::cout << "Differential check, " << options.scenarios << " scenarios of " << options.seconds
+              << " s from seed " << options.seed << ", " << options.kernel << " step vs reference" << std::endl;
+
+    std::mt19937 rng(options.seed);
+    int diverged = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int i = 0; i < options.scenarios; i++) {
+        DiffScenario scenario = randomScenario(rng);
+        if (!diffScenario(i, scenario, options)) {
+            diverged++;
+        }
+    }
+    std::cout << (diverged ? "FAILED: " : "OK: ") << diverged << " of " << options.scenarios
+              << " scenarios diverged" << std::endl;
+    return diverged == 0;
+}
+
+static void usage() {
+    std::cout << "Usage: dryer-bench [--frames N] [--full-repaint]" << std::endl;
+    std::cout << "                   [--dump DIR] [--golden DIR] [--update-golden DIR] [--tolerance N]" << std::endl;
+    std::cout << "       dryer-bench --physics [--steps N]" << std::endl;
+    std::cout << "       dryer-bench --fixed [--seconds N]   (hashes checked at 60 s)" << std::endl;
+    std::cout << "       dryer-bench --diff [--scenarios N] [--seed N] [--seconds N] [--kernel runtime|fixed]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options = {600, false, 200000, false, false, 20, 1, "specialized", 60.0,
+                            false, nullptr, nullptr, false, 0};
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--physics") == 0) {
+            options.physics = true;
+        } else if (std::strcmp(argv[i], "--steps") == 0 && hasValue) {
+            options.steps = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--fixed") == 0) {
+            options.fixedPoint = true;
+        } else if (std::strcmp(argv[i], "--diff") == 0) {
+            options.diff = true;
+        } else if (std::strcmp(argv[i], "--scenarios") == 0 && hasValue) {
+            options.scenarios = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--kernel") == 0 && hasValue) {
+            options.kernel = argv[++i];
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) {
+            options.seconds = std::max(1.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--full-repaint") == 0) {
+            options.fullRepaint = true;
+        } else if (std::strcmp(argv[i], "--dump") == 0 && hasValue) {
+            options.dumpDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--golden") == 0 && hasValue) {
+            options.goldenDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--update-golden") == 0 && hasValue) {
+            options.goldenDir = argv[++i];
+            options.updateGolden = true;
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            options.tolerance = std::atoi(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (options.physics) {
+        benchPhysics(options);
+        return 0;
+    }
+
+    if (options.diff) {
+        return benchDiff(options) ? 0 : 1;
+    }
+
+    if (options.fixedPoint) {
+        std::cout << "Physics, " << options.seconds << " simulated seconds per scene, drum 0"
+                  << (options.seconds == FIXED_HASH_SECONDS ? "" : " (no expected hashes for this length)")
+                  << std::endl;
+        std::cout << "  " << std::left << std::setw(18) << "" << std::right << std::setw(16) << "hits"
+                  << std::setw(16) << "> 5 cm/s" << std::endl;
+        std::cout << "  " << std::left << std::setw(18) << "scene" << std::right
+                  << std::setw(8) << "float" << std::setw(8) << "fixed" << std::setw(8) << "float"
+                  << std::setw(8) << "fixed" << std::setw(8) << "same"
+                  << std::setw(10) << "float ns" << std::setw(10) << "fixed ns"
+                  << "  " << "fixed-point hit hash" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        int failed = 0;
+        for (int i = 0; i < static_cast<int>(sizeof(SCENES) / sizeof(SCENES[0])); i++) {
+            if (!benchFixed(i, options)) {
+                failed++;
+            }
+        }
+        std::cout << (failed ? "FAILED: " : "OK: ") << failed << " scenes off" << std::endl;
+        return failed ? 1 : 0;
+    }
+
+    bool ok = true;
+
+    if (options.dumpDir || options.goldenDir) {
+        std::cout << "Scenes:" << std::endl;
+        for (const auto& scene : SCENES) {
+            ok = checkScene(scene, options) && ok;
+        }
+    }
+
+    std::cout << "Rendering " << options.frames << " frames per scene, "
+              << CANVAS_SIZE << "x" << CANVAS_SIZE << " memory target"
+              << (options.fullRepaint ? ", full repaint" : "") << " (ms/frame)" << std::endl;
+
+    std::cout << "  " << std::left << std::setw(18) << "scene" << std::right;
+    for (int stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+        std::cout << std::setw(9) << RenderProfile::stageName(stage);
+    }
+    std::cout << std::setw(9) << "total" << std::setw(8) << "dirty%" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& scene : SCENES) {
+        benchScene(scene, options);
+    }
+
+    return ok ? 0 : 1;
+}
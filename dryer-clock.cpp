@@ -0,0 +1,359 @@
+#include "dryer-clock.h"
+#include "dryer-latency.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+static const int MIDI_CLOCK_PPQN = 24;
+static const uint64_t MIDI_BYTE_NS = 320000;        // 10 bits at 31250 baud
+static const int POLL_TIMEOUT_MS = 100;
+
+// Loop filter: phase and period gains per tick (critically damped enough
+// to ride out UART/USB jitter, fast enough to follow a tempo ramp)
+static const double PLL_PHASE_GAIN = 0.2;
+static const double PLL_PERIOD_GAIN = 0.02;
+static const double OUTLIER_FRACTION = 0.5;         // of a tick period
+static const int RELOCK_OUTLIERS = 3;               // in a row: re-measure tempo
+static const int LOCK_TICKS = 4;                    // good ticks before locking
+static const double TIMEOUT_TICKS = 4.0;
+static const uint64_t TIMEOUT_MIN_NS = 500000000ULL;
+
+// Accepted beat period: 20..300 BPM
+static const double BEAT_NS_MIN = 60e9 / 300.0;
+static const double BEAT_NS_MAX = 60e9 / 20.0;
+
+// Drum steering: phase error (rad) -> velocity correction (rad/s), capped
+// at a fraction of the nominal velocity, and an angular acceleration limit
+static const double PHASE_CORRECTION_GAIN = 1.0;
+static const double MAX_PHASE_CORRECTION = 0.1;
+static const double MIN_PHASE_CORRECTION = 0.05;    // rad/s, near-zero tempos
+static const float MAX_ANGULAR_ACCEL = 2.0f;        // rad/s^2
+static const double TWO_PI = 2.0 * M_PI;
+
+ClockSync::ClockSync(DryerHardware& hardware)
+    : hardware(hardware)
+    , source(CLOCK_NONE)
+    , beatsPerRevolution(4)
+    , pulsesPerBeat(1)
+    , running(false)
+    , realtime(nullptr)
+    , havePeriod(false)
+    , lastTickNs(0)
+    , predictedNs(0.0)
+    , periodNs(0.0)
+    , tickCount(-1)
+    , goodTicks(0)
+    , outliers(0)
+    , transportRunning(true)
+    , wasLocked(false)
+    , jitterSquareSum(0.0)
+    , jitterCount(0)
+    , published{false, true, 0, 0.0, 0.0}
+    , ticksReceived(0)
+    , relocks(0)
+    , jitterRmsNs(0.0)
+    , sppBytesPending(0)
+    , sppValue(0)
+{
+}
+
+ClockSync::~ClockSync() {
+    stop();
+}
+
+void ClockSync::loadFromEnvironment() {
+    const char* value = std::getenv("DRYER_CLOCK");
+    if (!value || !value[0] || std::strcmp(value, "off") == 0) return;
+
+    if (std::strcmp(value, "midi") == 0) {
+        source = CLOCK_MIDI;
+        pulsesPerBeat = MIDI_CLOCK_PPQN;
+    } else if (std::strcmp(value, "gate") == 0) {
+        source = CLOCK_GATE;
+        if (const char* ppqn = std::getenv("DRYER_CLOCK_PPQN")) {
+            pulsesPerBeat = std::max(1, std::atoi(ppqn));
+        }
+    } else {
+        std::cerr << "WARNING: unknown DRYER_CLOCK=" << value << ", using the RPM knob" << std::endl;
+        return;
+    }
+
+    if (const char* beats = std::getenv("DRYER_CLOCK_BEATS")) {
+        beatsPerRevolution = std::max(1, std::atoi(beats));
+    }
+
+    std::cout << "Clock sync: " << value << ", " << pulsesPerBeat << " PPQN, "
+              << beatsPerRevolution << " beats per revolution" << std::endl;
+}
+
+bool ClockSync::start(DryerRealtime* realtime) {
+    if (source == CLOCK_NONE || running) return false;
+
+    // Without input the PLL never locks and the drums follow the knob
+    if (source == CLOCK_GATE && !hardware.enableClockInput()) {
+        std::cerr << "WARNING: clock input GPIO " << GPIO_CLOCK_IN
+                  << " unavailable, using the RPM knob" << std::endl;
+        return false;
+    }
+
+    this->realtime = realtime;
+    running = true;
+    thread = std::thread(&ClockSync::run, this);
+    return true;
+}
+
+void ClockSync::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+ClockState ClockSync::snapshot() const {
+    std::lock_guard<PiMutex> lock(stateMutex);
+    return published;
+}
+
+float ClockSync::drumVelocity(const ClockState& state, const DryerPhysics& drum, float rpmRatio,
+                              float dt, uint64_t nowNs) const {
+    float target;
+    if (!state.locked) {
+        // No clock (yet): behave like the knob (getRPM already has the ratio)
+        target = drum.getRPM() * static_cast<float>(TWO_PI / 60.0);
+    } else if (!state.running) {
+        target = 0.0f;
+    } else {
+        // Where the drum should be now, extrapolated from the last tick
+        double sinceRef = static_cast<double>(static_cast<int64_t>(nowNs - state.refNs));
+        double beats = state.refBeat + sinceRef / state.beatNs;
+        double revolutions = rpmRatio * beats / beatsPerRevolution;
+        double wanted = TWO_PI * (revolutions - std::floor(revolutions));
+        double error = std::remainder(wanted - drum.getDrumAngle(), TWO_PI);
+
+        // Nominal tempo plus a bounded pull towards the right phase
+        double nominal = TWO_PI * rpmRatio * 1e9 / (state.beatNs * beatsPerRevolution);
+        double maxCorrection = std::max(nominal * MAX_PHASE_CORRECTION, MIN_PHASE_CORRECTION);
+        double correction = std::clamp(PHASE_CORRECTION_GAIN * error, -maxCorrection, maxCorrection);
+        target = static_cast<float>(nominal + correction);
+    }
+
+    // Slew limit: tempo changes and relocks ramp instead of jerking the drum
+    float current = drum.getAngularVelocity();
+    float maxChange = MAX_ANGULAR_ACCEL * dt;
+    return current + std::clamp(target - current, -maxChange, maxChange);
+}
+
+void ClockSync::run() {
+    if (realtime) {
+        realtime->enterThread(THREAD_CLOCK);
+    }
+
+    uint8_t bytes[64];
+    uint64_t edges[16];
+    bool warned = false;
+    uint64_t lastSampleNs = latencyNowNs();
+
+    while (running) {
+        int count;
+        if (source == CLOCK_MIDI) {
+            count = hardware.readMIDIInput(bytes, sizeof(bytes), POLL_TIMEOUT_MS);
+            if (count > 0) {
+                parseMIDI(bytes, count, latencyNowNs());
+            }
+        } else {
+            count = hardware.readClockEdges(edges, 16, POLL_TIMEOUT_MS);
+            for (int i = 0; i < count; i++) {
+                tick(edges[i]);
+            }
+        }
+
+        if (count < 0) {
+            if (!warned) {
+                std::cerr << "WARNING: clock input unavailable" << std::endl;
+                warned = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+        }
+
+        uint64_t nowNs = latencyNowNs();
+        checkTimeout(nowNs);
+
+        if (realtime && nowNs - lastSampleNs >= 1000000000ULL) {
+            lastSampleNs = nowNs;
+            realtime->sampleThread(THREAD_CLOCK);
+        }
+    }
+}
+
+void ClockSync::parseMIDI(const uint8_t* bytes, int count, uint64_t readNs) {
+    for (int i = 0; i < count; i++) {
+        uint8_t byte = bytes[i];
+
+        if (byte >= 0xF8) {
+            // Realtime messages may appear anywhere, even between data bytes.
+            // Bytes of one read arrived back to back, the last one at readNs.
+            if (byte == 0xF8) {
+                tick(readNs - static_cast<uint64_t>(count - 1 - i) * MIDI_BYTE_NS);
+            } else {
+                transport(byte);
+            }
+        } else if (byte == 0xF2) {
+            sppBytesPending = 2;
+            sppValue = 0;
+        } else if (byte & 0x80) {
+            sppBytesPending = 0;        // any other status cancels an SPP
+        } else if (sppBytesPending > 0) {
+            sppValue |= byte << (sppBytesPending == 2 ? 0 : 7);
+            if (--sppBytesPending == 0) {
+                // Position in sixteenths, 6 clocks each; the next clock plays it
+                tickCount = static_cast<int64_t>(sppValue) * 6 - 1;
+            }
+        }
+    }
+}
+
+void ClockSync::transport(uint8_t status) {
+    switch (status) {
+        case 0xFA:                      // start: the next clock is beat 0
+            tickCount = -1;
+            transportRunning = true;
+            break;
+        case 0xFB:                      // continue from the song position
+            transportRunning = true;
+            break;
+        case 0xFC:                      // stop
+            transportRunning = false;
+            break;
+        default:
+            return;
+    }
+    publish(published.refNs, wasLocked);
+}
+
+void ClockSync::tick(uint64_t timeNs) {
+    ticksReceived.fetch_add(1, std::memory_order_relaxed);
+    tickCount++;
+
+    if (!havePeriod) {
+        // First interval seeds the period
+        if (lastTickNs != 0) {
+            double interval = static_cast<double>(timeNs - lastTickNs);
+            double beat = interval * pulsesPerBeat;
+            if (beat >= BEAT_NS_MIN && beat <= BEAT_NS_MAX) {
+                periodNs = interval;
+                predictedNs = static_cast<double>(timeNs) + periodNs;
+                havePeriod = true;
+                goodTicks = 0;
+                outliers = 0;
+            }
+        }
+        lastTickNs = timeNs;
+        publish(timeNs, false);
+        return;
+    }
+    lastTickNs = timeNs;
+
+    double error = static_cast<double>(timeNs) - predictedNs;
+
+    // Dropped ticks (lost UART bytes, missed edges) land close to a later
+    // prediction: count them instead of dragging the tempo down
+    if (error > OUTLIER_FRACTION * periodNs) {
+        double missed = std::round(error / periodNs);
+        if (std::fabs(error - missed * periodNs) <= OUTLIER_FRACTION * periodNs * 0.5) {
+            tickCount += static_cast<int64_t>(missed);
+            predictedNs += missed * periodNs;
+            error -= missed * periodNs;
+        }
+    }
+
+    if (std::fabs(error) > OUTLIER_FRACTION * periodNs) {
+        // Glitch or tempo jump: coast on the current tempo from this tick,
+        // re-measure it if the clock keeps disagreeing
+        goodTicks = 0;
+        if (++outliers >= RELOCK_OUTLIERS) {
+            havePeriod = false;
+            relocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        predictedNs = static_cast<double>(timeNs) + periodNs;
+        publish(timeNs, wasLocked && havePeriod);
+        return;
+    }
+
+    outliers = 0;
+    jitterSquareSum += error * error;
+    jitterCount++;
+    jitterRmsNs.store(std::sqrt(jitterSquareSum / jitterCount), std::memory_order_relaxed);
+
+    double phaseNs = predictedNs + PLL_PHASE_GAIN * error;
+    periodNs = std::clamp(periodNs + PLL_PERIOD_GAIN * error,
+                          BEAT_NS_MIN / pulsesPerBeat, BEAT_NS_MAX / pulsesPerBeat);
+    predictedNs = phaseNs + periodNs;
+
+    // Lock once the period has settled; a few outliers don't unlock
+    if (goodTicks < LOCK_TICKS) {
+        goodTicks++;
+    }
+    publish(static_cast<uint64_t>(phaseNs), wasLocked || goodTicks >= LOCK_TICKS);
+}
+
+void ClockSync::publish(uint64_t refNs, bool locked) {
+    if (locked != wasLocked) {
+        if (locked) {
+            // Formatted apart: std::cout's flags are shared with every thread
+            std::ostringstream bpm;
+            bpm << std::fixed << std::setprecision(1) << 60e9 / (periodNs * pulsesPerBeat);
+            std::cout << "Clock locked at " << bpm.str() << " BPM" << std::endl;
+        } else {
+            std::cout << "Clock lost, using the RPM knob" << std::endl;
+        }
+        wasLocked = locked;
+    }
+
+    std::lock_guard<PiMutex> lock(stateMutex);
+    published.locked = locked;
+    published.running = transportRunning;
+    published.refNs = refNs;
+    published.refBeat = static_cast<double>(tickCount) / pulsesPerBeat;
+    published.beatNs = periodNs * pulsesPerBeat;
+}
+
+void ClockSync::checkTimeout(uint64_t nowNs) {
+    if (lastTickNs == 0) return;
+
+    uint64_t timeoutNs = std::max(TIMEOUT_MIN_NS, static_cast<uint64_t>(TIMEOUT_TICKS * periodNs));
+    if (nowNs > lastTickNs && nowNs - lastTickNs > timeoutNs) {
+        havePeriod = false;
+        goodTicks = 0;
+        outliers = 0;
+        lastTickNs = 0;
+        publish(nowNs, false);
+    }
+}
+
+void ClockSync::report(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    ClockState state = snapshot();
+    out << "=== Dryer clock ===\n";
+    out << "source: " << (source == CLOCK_MIDI ? "midi" : source == CLOCK_GATE ? "gate" : "off");
+    if (state.locked) {
+        out << ", " << std::fixed << std::setprecision(1) << 60e9 / state.beatNs << " BPM, locked"
+            << (state.running ? "" : ", stopped");
+    } else {
+        out << ", unlocked";
+    }
+    out << "\n";
+    out << "ticks: " << ticksReceived.load(std::memory_order_relaxed)
+        << ", relocks: " << relocks.load(std::memory_order_relaxed)
+        << ", tick jitter rms: " << std::fixed << std::setprecision(3)
+        << jitterRmsNs.load(std::memory_order_relaxed) / 1e6 << " ms\n";
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,108 @@
+#ifndef DRYER_CLOCK_H
+#define DRYER_CLOCK_H
+
+#include "dryer-hardware.h"
+#include "dryer-physics.h"
+#include "dryer-realtime.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+// ============================================================================
+// DRYER CLOCK - Lock drum rotation to an external clock
+//   DRYER_CLOCK=midi|gate      MIDI clock on the UART RX, or rising edges
+//                              on GPIO_CLOCK_IN
+//   DRYER_CLOCK_BEATS=4        beats per drum revolution
+//   DRYER_CLOCK_PPQN=1         gate pulses per beat (MIDI clock is 24)
+//
+// The input thread timestamps every tick and runs a second-order PLL on
+// them (tick phase + period), which smooths out transport jitter. The
+// physics thread then steers each drum's angular velocity towards the
+// PLL's beat phase: nominal tempo plus a bounded phase correction, slewed,
+// so the drum never jumps and the ball never feels a jolt.
+// ============================================================================
+
+enum ClockSource {
+    CLOCK_NONE,
+    CLOCK_MIDI,         // 0xF8 clock, 0xFA start, 0xFB continue, 0xFC stop, 0xF2 SPP
+    CLOCK_GATE          // rising edges on GPIO_CLOCK_IN
+};
+
+// What the physics thread needs from the PLL, published after every tick
+struct ClockState {
+    bool locked;        // tempo known and ticks still arriving
+    bool running;       // MIDI transport (always true for a gate clock)
+    uint64_t refNs;     // filtered time of the latest tick
+    double refBeat;     // beat position at refNs
+    double beatNs;      // filtered beat period
+};
+
+class ClockSync {
+public:
+    ClockSync(DryerHardware& hardware);
+    ~ClockSync();
+
+    // DRYER_CLOCK* (default: no clock, knob RPM as before)
+    void loadFromEnvironment();
+    bool isEnabled() const { return source != CLOCK_NONE; }
+    int getBeatsPerRevolution() const { return beatsPerRevolution; }
+
+    bool start(DryerRealtime* realtime = nullptr);
+    void stop();
+
+    // Consistent copy of the PLL state; safe from any thread
+    ClockState snapshot() const;
+
+    // Angular velocity for a drum that should make rpmRatio revolutions
+    // per getBeatsPerRevolution() beats, phase-locked to the clock. Falls
+    // back to the drum's knob RPM while unlocked. Call once per step.
+    float drumVelocity(const ClockState& state, const DryerPhysics& drum, float rpmRatio,
+                       float dt, uint64_t nowNs) const;
+
+    void report(std::ostream& out) const;
+
+private:
+    DryerHardware& hardware;
+    ClockSource source;
+    int beatsPerRevolution;
+    int pulsesPerBeat;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    DryerRealtime* realtime;
+
+    // PLL (input thread only)
+    bool havePeriod;
+    uint64_t lastTickNs;
+    double predictedNs;         // expected time of the next tick
+    double periodNs;            // per tick
+    int64_t tickCount;          // ticks since start / song position
+    int goodTicks;              // consecutive ticks close to the prediction
+    int outliers;               // consecutive ticks far from it
+    bool transportRunning;
+    bool wasLocked;
+    double jitterSquareSum;     // raw tick error vs. prediction
+    uint64_t jitterCount;
+
+    // Published state, copied out by snapshot()
+    mutable PiMutex stateMutex;
+    ClockState published;
+
+    std::atomic<uint64_t> ticksReceived;
+    std::atomic<uint64_t> relocks;
+    std::atomic<double> jitterRmsNs;
+
+    // MIDI parser: Song Position Pointer data bytes still expected
+    int sppBytesPending;
+    int sppValue;
+
+    void run();
+    void tick(uint64_t timeNs);
+    void transport(uint8_t status);
+    void parseMIDI(const uint8_t* bytes, int count, uint64_t readNs);
+    void publish(uint64_t refNs, bool locked);
+    void checkTimeout(uint64_t nowNs);
+};
+
+#endif // DRYER_CLOCK_H
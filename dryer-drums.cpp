@@ -0,0 +1,203 @@
+#include "dryer-drums.h"
+#include "dryer-alloc.h"
+#include "dryer-latency.h"
+#include <iostream>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const ThreadRole DRUM_ROLES[MAX_DRUMS] = {
+    THREAD_PHYSICS, THREAD_DRUM_1, THREAD_DRUM_2, THREAD_DRUM_3
+};
+
+// A drum step is a microsecond or so: spin this long for the workers
+// before sleeping, so the usual case makes no syscall
+static const int BARRIER_SPINS = 2000;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free, "futex word must be a plain uint32_t");
+
+// Sleep while word still holds expected; returns at once if it doesn't
+static void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+}
+
+static void futexWakeAll(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX,
+            nullptr, nullptr, 0);
+}
+
+DrumGroup::DrumGroup()
+    : drumCount(1)
+    , realtime(nullptr)
+    , tick(0)
+    , stepDt(0.0f)
+    , stepSequence(0)
+    , doneSequence(0)
+    , pendingWorkers(0)
+    , running(false)
+{
+    for (int i = 0; i < MAX_DRUMS; i++) {
+        configs[i] = DrumConfig{1.0f, 0};
+
+        // Buffer hits; they are handed on once every drum has stepped
+        drums[i].onCollision([this, i](const Surface& surface, float velocity) {
+            hits[i].push_back(Hit{&surface, velocity, latencyNowNs()});
+        });
+    }
+}
+
+DrumGroup::~DrumGroup() {
+    stop();
+}
+
+void DrumGroup::loadFromEnvironment() {
+    const char* value = std::getenv("DRYER_DRUMS");
+    if (!value || !value[0]) return;
+
+    int count = 0;
+    const char* entry = value;
+    while (entry && count < MAX_DRUMS) {
+        // rpm-ratio[:vanes]
+        float ratio = 0.0f;
+        int vanes = 0;
+        int fields = std::sscanf(entry, "%f:%d", &ratio, &vanes);
+        if (fields < 1 || ratio < 0.0f) {
+            std::cerr << "WARNING: ignoring DRYER_DRUMS=" << value << std::endl;
+            return;
+        }
+        if (fields < 2 || vanes < ParamRanges::VANES_MIN || vanes > ParamRanges::VANES_MAX) {
+            vanes = 0;
+        }
+        configs[count++] = DrumConfig{ratio, vanes};
+
+        entry = std::strchr(entry, ',');
+        if (entry) entry++;
+    }
+    if (entry) {
+        std::cerr << "WARNING: DRYER_DRUMS has more than " << MAX_DRUMS << " drums, using the first "
+                  << MAX_DRUMS << std::endl;
+    }
+
+    drumCount = count;
+    std::cout << "Drums: " << drumCount;
+    for (int i = 0; i < drumCount; i++) {
+        std::cout << (i == 0 ? " (" : ", ") << "x" << configs[i].rpmRatio;
+        if (configs[i].vanes > 0) {
+            std::cout << " " << configs[i].vanes << " vanes";
+        }
+    }
+    std::cout << ")" << std::endl;
+}
+
+void DrumGroup::start(DryerRealtime* realtime) {
+    if (running) return;
+
+    this->realtime = realtime;
+    running = true;
+    uint32_t sequence = stepSequence.load(std::memory_order_relaxed);
+    for (int i = 1; i < drumCount; i++) {
+        workers[i] = std::thread(&DrumGroup::workerLoop, this, i, sequence);
+    }
+}
+
+void DrumGroup::stop() {
+    if (!running.exchange(false)) return;
+
+    stepSequence.fetch_add(1, std::memory_order_release);
+    futexWakeAll(stepSequence);
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void DrumGroup::step(float dt) {
+    if (drumCount == 1 || !running) {
+        for (int i = 0; i < drumCount; i++) {
+            drums[i].step(dt);
+        }
+        tick++;
+        deliverHits();
+        return;
+    }
+
+    // The release on stepSequence publishes stepDt and the worker count
+    stepDt = dt;
+    pendingWorkers.store(drumCount - 1, std::memory_order_relaxed);
+    tick++;
+    stepSequence.fetch_add(1, std::memory_order_release);
+    futexWakeAll(stepSequence);
+
+    // Drum 0 on this thread while the workers do theirs
+    drums[0].step(dt);
+
+    // Spin, then sleep on doneSequence. It is read before pendingWorkers, so
+    // a last worker finishing in between changes it and the wait returns.
+    for (int spin = 0; spin < BARRIER_SPINS; spin++) {
+        if (pendingWorkers.load(std::memory_order_acquire) == 0) break;
+    }
+    while (true) {
+        uint32_t done = doneSequence.load(std::memory_order_acquire);
+        if (pendingWorkers.load(std::memory_order_acquire) == 0) break;
+        futexWait(doneSequence, done);
+    }
+
+    deliverHits();
+}
+
+void DrumGroup::workerLoop(int index, uint32_t done) {
+    if (realtime) {
+        realtime->enterThread(DRUM_ROLES[index]);
+    }
+
+    int sampleCounter = 0;
+
+    while (true) {
+        uint32_t sequence = stepSequence.load(std::memory_order_acquire);
+        if (!running.load(std::memory_order_relaxed)) break;
+        if (sequence == done) {
+            futexWait(stepSequence, done);
+            continue;
+        }
+        done = sequence;
+
+        drums[index].step(stepDt);
+
+        // The last one out wakes the stepping thread
+        if (pendingWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            doneSequence.fetch_add(1, std::memory_order_release);
+            futexWakeAll(doneSequence);
+        }
+
+        if (++sampleCounter >= PHYSICS_RATE_HZ) {
+            sampleCounter = 0;
+            if (realtime) {
+                realtime->sampleThread(DRUM_ROLES[index]);
+            }
+
+            // Warmed up: from here on the loop must not allocate
+            DryerAlloc::armThread();
+        }
+    }
+
+    DryerAlloc::disarmThread();
+}
+
+void DrumGroup::deliverHits() {
+    for (int i = 0; i < drumCount; i++) {
+        for (const Hit& hit : hits[i]) {
+            if (hitCallback) {
+                hitCallback(i, *hit.surface, hit.velocity, hit.detectNs);
+            }
+        }
+        hits[i].clear();
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef DRYER_DRUMS_H
+#define DRYER_DRUMS_H
+
+#include "dryer-physics.h"
+#include "dryer-realtime.h"
+#include "dryer-fixed-vector.h"
+#include "pins.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// ============================================================================
+// DRYER DRUMS - Several independent drums in lockstep (polyrhythm mode)
+// DRYER_DRUMS lists one drum per entry as rpm-ratio[:vanes], relative to the
+// knobs; e.g. "1,1.5,0.75:3" runs three drums, the second turning 3:2
+// against the first, the third at 3/4 speed with 3 vanes.
+//
+// Drum 0 is stepped by the caller (the physics thread), every other drum by
+// its own worker thread. Each step is a barrier on a shared tick, so all
+// drums have always simulated exactly the same time. The barrier is two
+// atomic words and futex wait/wake: no mutex for FIFO threads to queue on.
+// ============================================================================
+
+struct DrumConfig {
+    float rpmRatio;     // times the RPM knob
+    int vanes;          // 0 = from the vanes knob
+};
+
+class DrumGroup {
+public:
+    // Hits are reported on the stepping thread once the whole step is done,
+    // in drum order. detectNs is when the drum's own step saw the hit.
+    using HitCallback = std::function<void(int drum, const Surface& surface, float velocity,
+                                           uint64_t detectNs)>;
+
+    DrumGroup();
+    ~DrumGroup();
+    DrumGroup(const DrumGroup&) = delete;
+    DrumGroup& operator=(const DrumGroup&) = delete;
+
+    // DRYER_DRUMS (default: one drum at the knob settings)
+    void loadFromEnvironment();
+    int size() const { return drumCount; }
+    const DrumConfig& getConfig(int index) const { return configs[index]; }
+
+    DryerPhysics& drum(int index) { return drums[index]; }
+    const DryerPhysics& drum(int index) const { return drums[index]; }
+
+    void onHit(HitCallback callback) { hitCallback = callback; }
+
+    // Worker threads for drums 1.. (none with a single drum)
+    void start(DryerRealtime* realtime = nullptr);
+    void stop();
+
+    // Advance every drum by dt; returns when all of them are done
+    void step(float dt);
+
+    // Steps taken so far: the shared simulation clock
+    uint64_t getTick() const { return tick; }
+
+private:
+    // Worst case per step: every vane and the drum wall, once each
+    static const int MAX_HITS_PER_STEP = 1 + DryerPhysics::MAX_VANES;
+
+    struct Hit {
+        const Surface* surface;     // valid until the surfaces change
+        float velocity;
+        uint64_t detectNs;
+    };
+
+    DryerPhysics drums[MAX_DRUMS];
+    DrumConfig configs[MAX_DRUMS];
+    int drumCount;
+    HitCallback hitCallback;
+
+    // Written only by the thread stepping that drum, read after the barrier
+    FixedVector<Hit, MAX_HITS_PER_STEP> hits[MAX_DRUMS];
+
+    DryerRealtime* realtime;
+    std::thread workers[MAX_DRUMS];
+    uint64_t tick;
+    float stepDt;                              // published by stepSequence
+    std::atomic<uint32_t> stepSequence;        // futex: bumped per step and on stop
+    std::atomic<uint32_t> doneSequence;        // futex: bumped by the last worker
+    std::atomic<int> pendingWorkers;
+    std::atomic<bool> running;
+
+    void workerLoop(int index, uint32_t done);   // done: last sequence already stepped
+    void deliverHits();
+};
+
+#endif // DRYER_DRUMS_H
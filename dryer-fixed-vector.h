@@ -0,0 +1,52 @@
+#ifndef DRYER_FIXED_VECTOR_H
+#define DRYER_FIXED_VECTOR_H
+
+#include <cstddef>
+
+// ============================================================================
+// DRYER FIXED VECTOR - Inline, fixed-capacity vector
+// Storage lives inside the object, so filling and copying it never touches
+// the heap. push_back() past capacity is refused rather than reallocating.
+// ============================================================================
+
+template <typename T, size_t Capacity>
+class FixedVector {
+public:
+    FixedVector() : count(0) {}
+
+    bool push_back(const T& item) {
+        if (count >= Capacity) {
+            return false;
+        }
+        items[count++] = item;
+        return true;
+    }
+
+    void pop_back() {
+        if (count > 0) {
+            count--;
+        }
+    }
+
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+private:
+    T items[Capacity];
+    size_t count;
+};
+
+#endif // DRYER_FIXED_VECTOR_H
@@ -0,0 +1,66 @@
+#include "dryer-fixed.h"
+
+static const int64_t TRIG_ONE = int64_t(1) << TRIG_SHIFT;
+static const int64_t QUARTER_PI = 843314857;    // π/4, Q2.30
+
+// Integer square root, rounded down. IEEE sqrt is correctly rounded
+// everywhere, and the fix-up makes the result exact whatever it returned.
+static uint64_t squareRoot(uint64_t value) {
+    uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+    while (root * root > value) {
+        root--;
+    }
+    while ((root + 1) * (root + 1) <= value) {
+        root++;
+    }
+    return root;
+}
+
+Fixed fixedHypot(Fixed x, Fixed y) {
+    // Q32.32 sum of squares; its root is Q16.16
+    uint64_t sum = static_cast<uint64_t>(static_cast<int64_t>(x) * x) +
+                   static_cast<uint64_t>(static_cast<int64_t>(y) * y);
+    return static_cast<Fixed>(squareRoot(sum));
+}
+
+// Taylor series on [0, π/4], Q2.30: at most a couple of LSB off
+static int64_t sinOctant(int64_t x) {
+    int64_t x2 = (x * x) >> TRIG_SHIFT;
+    int64_t term = TRIG_ONE - x2 / 72;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 42;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 20;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 6;
+    return (x * term) >> TRIG_SHIFT;
+}
+
+static int64_t cosOctant(int64_t x) {
+    int64_t x2 = (x * x) >> TRIG_SHIFT;
+    int64_t term = TRIG_ONE - x2 / 90;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 56;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 30;
+    term = TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 12;
+    return TRIG_ONE - ((x2 * term) >> TRIG_SHIFT) / 2;
+}
+
+void fixedSinCos(uint32_t phase, int32_t& cosine, int32_t& sine) {
+    // Quadrant, then the octant within it: past π/4, sin and cos swap
+    uint32_t quadrant = phase >> 30;
+    uint32_t within = phase & ((1u << 30) - 1);
+    bool upper = within >= (1u << 29);
+    int64_t x = ((upper ? (1u << 30) - within : within) * QUARTER_PI) >> 29;
+
+    int64_t s = sinOctant(x);
+    int64_t c = cosOctant(x);
+    if (upper) {
+        int64_t swap = s;
+        s = c;
+        c = swap;
+    }
+
+    switch (quadrant) {
+        case 0: cosine = static_cast<int32_t>(c);  sine = static_cast<int32_t>(s);  break;
+        case 1: cosine = static_cast<int32_t>(-s); sine = static_cast<int32_t>(c);  break;
+        case 2: cosine = static_cast<int32_t>(-c); sine = static_cast<int32_t>(-s); break;
+        default: cosine = static_cast<int32_t>(s); sine = static_cast<int32_t>(-c); break;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef DRYER_FIXED_H
+#define DRYER_FIXED_H
+
+#include <cmath>
+#include <cstdint>
+
+// ============================================================================
+// DRYER FIXED - Q16.16 arithmetic for the deterministic physics step
+// Integers only, so a step gives the same bits on the Pi's Cortex-A53 and
+// on x86; float does not (FMA contraction, libm sin/cos). Products go
+// through 64 bits. Signed right shifts are arithmetic on every compiler the
+// project builds with.
+// ============================================================================
+
+typedef int32_t Fixed;                      // Q16.16
+
+static constexpr int FIXED_SHIFT = 16;
+static constexpr Fixed FIXED_ONE = 1 << FIXED_SHIFT;
+static constexpr int TRIG_SHIFT = 30;       // sin/cos: Q2.30
+
+// Exact both ways for |x| < 256, where 24 significant bits fit a float
+inline Fixed fixedFromFloat(float x) {
+    return static_cast<Fixed>(std::llround(x * 65536.0f));
+}
+
+inline float fixedToFloat(Fixed x) {
+    return static_cast<float>(x) * (1.0f / 65536.0f);
+}
+
+inline Fixed fixedMul(Fixed a, Fixed b) {
+    return static_cast<Fixed>((static_cast<int64_t>(a) * b) >> FIXED_SHIFT);
+}
+
+inline Fixed fixedDiv(Fixed a, Fixed b) {
+    return static_cast<Fixed>((static_cast<int64_t>(a) * FIXED_ONE) / b);
+}
+
+// Q16.16 times a Q2.30 sin/cos
+inline Fixed fixedMulTrig(Fixed a, int32_t trig) {
+    return static_cast<Fixed>((static_cast<int64_t>(a) * trig) >> TRIG_SHIFT);
+}
+
+// sqrt(x² + y²)
+Fixed fixedHypot(Fixed x, Fixed y);
+
+// cos and sin (Q2.30) of a phase with 2^32 per revolution
+void fixedSinCos(uint32_t phase, int32_t& cosine, int32_t& sine);
+
+#endif // DRYER_FIXED_H
@@ -0,0 +1,88 @@
+#include "dryer-frame-scheduler.h"
+#include "dryer-latency.h"
+#include <chrono>
+#include <iomanip>
+#include <thread>
+
+static const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+FrameScheduler::FrameScheduler(int maxHz, int idleHz)
+    : maxHz(maxHz)
+    , tickNs(NS_PER_SECOND / maxHz)
+    , idleIntervalNs(NS_PER_SECOND / idleHz)
+    , nextTickNs(0)
+    , lastRenderNs(0)
+    , windowStartNs(0)
+    , windowFrames(0)
+    , measuredHz(0.0f)
+    , framesRendered(0)
+    , skippedStatic(0)
+    , skippedPressure(0)
+{
+}
+
+void FrameScheduler::waitForTick() {
+    uint64_t now = latencyNowNs();
+
+    if (nextTickNs == 0) {
+        nextTickNs = now;
+        windowStartNs = now;
+    }
+
+    if (nextTickNs > now) {
+        // latencyNowNs is steady_clock time since its epoch
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(nextTickNs)));
+        now = latencyNowNs();
+    }
+
+    // Resync rather than burst after a long frame (vsync wait, stall)
+    nextTickNs += tickNs;
+    if (nextTickNs < now) {
+        nextTickNs = now + tickNs;
+    }
+
+    // Roll the effective-rate window once a second
+    if (now - windowStartNs >= NS_PER_SECOND) {
+        measuredHz.store(windowFrames * static_cast<float>(NS_PER_SECOND) / (now - windowStartNs),
+                         std::memory_order_relaxed);
+        windowStartNs = now;
+        windowFrames = 0;
+    }
+}
+
+FrameDecision FrameScheduler::decide(float visualChangePx, uint64_t physicsLateNs, uint64_t outputLagNs) {
+    // Timing-critical output always wins over visuals
+    if (physicsLateNs > PHYSICS_LATE_LIMIT_NS || outputLagNs > OUTPUT_LAG_LIMIT_NS) {
+        skippedPressure.fetch_add(1, std::memory_order_relaxed);
+        return FRAME_SKIP_PRESSURE;
+    }
+
+    bool idleDue = latencyNowNs() - lastRenderNs >= idleIntervalNs;
+    if (visualChangePx < DISPLAY_MIN_CHANGE_PX && !idleDue) {
+        skippedStatic.fetch_add(1, std::memory_order_relaxed);
+        return FRAME_SKIP_STATIC;
+    }
+
+    return FRAME_RENDER;
+}
+
+void FrameScheduler::frameRendered() {
+    lastRenderNs = latencyNowNs();
+    windowFrames++;
+    framesRendered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameScheduler::report(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "=== Dryer render rate ===\n";
+    out << "effective: " << std::fixed << std::setprecision(1) << effectiveHz()
+        << " Hz (max " << maxHz << ")\n";
+    out.flags(flags);
+    out.precision(precision);
+    out << "frames: " << framesRendered.load(std::memory_order_relaxed)
+        << " drawn, " << skippedStatic.load(std::memory_order_relaxed) << " skipped static, "
+        << skippedPressure.load(std::memory_order_relaxed) << " skipped under load\n";
+}
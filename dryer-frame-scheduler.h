@@ -0,0 +1,64 @@
+#ifndef DRYER_FRAME_SCHEDULER_H
+#define DRYER_FRAME_SCHEDULER_H
+
+#include "pins.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// ============================================================================
+// DRYER FRAME SCHEDULER - Adaptive render rate for the main loop
+// Ticks at DISPLAY_FPS and decides per tick whether a frame is worth drawing:
+//   - skipped when physics or output deadlines are at risk (always wins)
+//   - skipped when the scene moved less than DISPLAY_MIN_CHANGE_PX,
+//     but never below DISPLAY_IDLE_FPS
+// ============================================================================
+
+enum FrameDecision {
+    FRAME_RENDER,
+    FRAME_SKIP_STATIC,      // nothing visible changed
+    FRAME_SKIP_PRESSURE     // timing-critical threads are late
+};
+
+class FrameScheduler {
+public:
+    // Physics woke this late, or output dispatched an event this late:
+    // leave the CPU to them
+    static constexpr uint64_t PHYSICS_LATE_LIMIT_NS = 1000000000ULL / PHYSICS_RATE_HZ / 2;
+    static constexpr uint64_t OUTPUT_LAG_LIMIT_NS = 1000000;
+
+    FrameScheduler(int maxHz = DISPLAY_FPS, int idleHz = DISPLAY_IDLE_FPS);
+
+    // Sleep until the next tick (no-op if the last frame ran long)
+    void waitForTick();
+
+    // Lateness arguments are the worst seen since the previous tick
+    FrameDecision decide(float visualChangePx, uint64_t physicsLateNs, uint64_t outputLagNs);
+
+    // Call after the frame has been presented
+    void frameRendered();
+
+    // Frames actually drawn per second, over the last second.
+    // Safe to read from any thread.
+    float effectiveHz() const { return measuredHz.load(std::memory_order_relaxed); }
+
+    void report(std::ostream& out) const;
+
+private:
+    int maxHz;
+    uint64_t tickNs;
+    uint64_t idleIntervalNs;
+    uint64_t nextTickNs;
+    uint64_t lastRenderNs;
+
+    // Effective rate window
+    uint64_t windowStartNs;
+    int windowFrames;
+    std::atomic<float> measuredHz;
+
+    std::atomic<uint64_t> framesRendered;
+    std::atomic<uint64_t> skippedStatic;
+    std::atomic<uint64_t> skippedPressure;
+};
+
+#endif // DRYER_FRAME_SCHEDULER_H
@@ -0,0 +1,407 @@
+#include "dryer-framebuffer.h"
+#include <algorithm>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/fb.h>
+
+#ifdef DRYER_HAVE_DRM
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#endif
+
+// ============================================================================
+// MemoryFramebufferTarget
+// ============================================================================
+
+MemoryFramebufferTarget::MemoryFramebufferTarget()
+    : width(0)
+    , height(0)
+    , front(0)
+{
+}
+
+bool MemoryFramebufferTarget::open(int width, int height) {
+    this->width = width;
+    this->height = height;
+    for (auto& buffer : buffers) {
+        buffer.assign(static_cast<size_t>(width) * height, 0xFF000000);
+    }
+    front = 0;
+    return true;
+}
+
+void MemoryFramebufferTarget::close() {
+    for (auto& buffer : buffers) {
+        buffer.clear();
+        buffer.shrink_to_fit();
+    }
+}
+
+Framebuffer MemoryFramebufferTarget::backBuffer() {
+    Framebuffer fb = {buffers[1 - front].data(), width, height, width};
+    return fb;
+}
+
+Framebuffer MemoryFramebufferTarget::frontBuffer() {
+    Framebuffer fb = {buffers[front].data(), width, height, width};
+    return fb;
+}
+
+bool MemoryFramebufferTarget::flip() {
+    front = 1 - front;
+    return true;
+}
+
+// ============================================================================
+// FbdevFramebufferTarget
+// ============================================================================
+
+FbdevFramebufferTarget::FbdevFramebufferTarget(const char* device)
+    : device(device)
+    , fd(-1)
+    , mapping(nullptr)
+    , mappingSize(0)
+{
+    std::memset(&drawable, 0, sizeof(drawable));
+}
+
+FbdevFramebufferTarget::~FbdevFramebufferTarget() {
+    close();
+}
+
+bool FbdevFramebufferTarget::open(int width, int height) {
+    fd = ::open(device, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "fbdev: cannot open " << device << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    fb_var_screeninfo var;
+    fb_fix_screeninfo fix;
+    if (ioctl(fd, FBIOGET_VSCREENINFO, &var) < 0 || ioctl(fd, FBIOGET_FSCREENINFO, &fix) < 0) {
+        std::cerr << "fbdev: screen info query failed" << std::endl;
+        close();
+        return false;
+    }
+
+    if (var.bits_per_pixel != 32) {
+        std::cerr << "fbdev: " << var.bits_per_pixel << "bpp not supported (need 32)" << std::endl;
+        close();
+        return false;
+    }
+    if (var.red.offset != 16 || var.blue.offset != 0) {
+        std::cerr << "fbdev: WARNING: not XRGB8888, colours will be swapped" << std::endl;
+    }
+
+    mappingSize = static_cast<size_t>(fix.line_length) * var.yres_virtual;
+    void* map = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "fbdev: mmap failed: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapping = static_cast<uint8_t*>(map);
+
+    // Centre the drawable area on the visible screen
+    int drawWidth = std::min<int>(width, var.xres);
+    int drawHeight = std::min<int>(height, var.yres);
+    int offsetX = (static_cast<int>(var.xres) - drawWidth) / 2 + var.xoffset;
+    int offsetY = (static_cast<int>(var.yres) - drawHeight) / 2 + var.yoffset;
+
+    drawable.stride = fix.line_length / 4;
+    drawable.pixels = reinterpret_cast<uint32_t*>(mapping) + offsetY * drawable.stride + offsetX;
+    drawable.width = drawWidth;
+    drawable.height = drawHeight;
+
+    std::cout << "fbdev: " << var.xres << "x" << var.yres << " on " << device << std::endl;
+    return true;
+}
+
+void FbdevFramebufferTarget::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+Framebuffer FbdevFramebufferTarget::backBuffer() {
+    return drawable;
+}
+
+// ============================================================================
+// DrmFramebufferTarget
+// ============================================================================
+
+DrmFramebufferTarget::DrmFramebufferTarget(const char* device)
+    : device(device)
+    , fd(-1)
+    , connectorId(0)
+    , crtcId(0)
+    , mode(nullptr)
+    , savedCrtc(nullptr)
+    , back(1)
+    , flipPending(false)
+    , opened(false)
+    , drawWidth(0)
+    , drawHeight(0)
+{
+    std::memset(buffers, 0, sizeof(buffers));
+}
+
+DrmFramebufferTarget::~DrmFramebufferTarget() {
+    close();
+}
+
+#ifdef DRYER_HAVE_DRM
+
+bool DrmFramebufferTarget::open(int width, int height) {
+    fd = ::open(device, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "drm: cannot open " << device << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    drmModeRes* resources = drmModeGetResources(fd);
+    if (!resources) {
+        std::cerr << "drm: no KMS resources on " << device << std::endl;
+        close();
+        return false;
+    }
+
+    // First connected connector with a usable mode
+    drmModeConnector* connector = nullptr;
+    for (int i = 0; i < resources->count_connectors && !connector; i++) {
+        drmModeConnector* candidate = drmModeGetConnector(fd, resources->connectors[i]);
+        if (candidate && candidate->connection == DRM_MODE_CONNECTED && candidate->count_modes > 0) {
+            connector = candidate;
+        } else if (candidate) {
+            drmModeFreeConnector(candidate);
+        }
+    }
+
+    if (!connector) {
+        std::cerr << "drm: no connected display" << std::endl;
+        drmModeFreeResources(resources);
+        close();
+        return false;
+    }
+
+    // Preferred mode, else the first one
+    drmModeModeInfo* chosen = &connector->modes[0];
+    for (int i = 0; i < connector->count_modes; i++) {
+        if (connector->modes[i].type & DRM_MODE_TYPE_PREFERRED) {
+            chosen = &connector->modes[i];
+            break;
+        }
+    }
+    mode = new drmModeModeInfo(*chosen);
+    connectorId = connector->connector_id;
+
+    // CRTC currently driving the connector, else the first CRTC
+    crtcId = resources->crtcs[0];
+    if (connector->encoder_id) {
+        drmModeEncoder* encoder = drmModeGetEncoder(fd, connector->encoder_id);
+        if (encoder) {
+            if (encoder->crtc_id) crtcId = encoder->crtc_id;
+            drmModeFreeEncoder(encoder);
+        }
+    }
+
+    drmModeFreeConnector(connector);
+    drmModeFreeResources(resources);
+
+    const drmModeModeInfo* info = static_cast<drmModeModeInfo*>(mode);
+    for (auto& buffer : buffers) {
+        if (!createBuffer(buffer, info->hdisplay, info->vdisplay)) {
+            close();
+            return false;
+        }
+        std::memset(buffer.map, 0, buffer.size);
+    }
+
+    drawWidth = std::min<int>(width, info->hdisplay);
+    drawHeight = std::min<int>(height, info->vdisplay);
+
+    savedCrtc = drmModeGetCrtc(fd, crtcId);
+    if (drmModeSetCrtc(fd, crtcId, buffers[0].fbId, 0, 0, &connectorId, 1,
+                       static_cast<drmModeModeInfo*>(mode)) != 0) {
+        std::cerr << "drm: modeset failed: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    back = 1;
+    opened = true;
+    std::cout << "drm: " << info->hdisplay << "x" << info->vdisplay << "@" << info->vrefresh
+              << " on " << device << std::endl;
+    return true;
+}
+
+void DrmFramebufferTarget::close() {
+    if (fd < 0) return;
+
+    if (opened) {
+        waitForFlip();
+    }
+
+    if (savedCrtc) {
+        drmModeCrtc* crtc = static_cast<drmModeCrtc*>(savedCrtc);
+        drmModeSetCrtc(fd, crtc->crtc_id, crtc->buffer_id, crtc->x, crtc->y,
+                       &connectorId, 1, &crtc->mode);
+        drmModeFreeCrtc(crtc);
+        savedCrtc = nullptr;
+    }
+
+    for (auto& buffer : buffers) {
+        destroyBuffer(buffer);
+    }
+
+    delete static_cast<drmModeModeInfo*>(mode);
+    mode = nullptr;
+
+    ::close(fd);
+    fd = -1;
+    opened = false;
+}
+
+bool DrmFramebufferTarget::createBuffer(DumbBuffer& buffer, int width, int height) {
+    drm_mode_create_dumb create;
+    std::memset(&create, 0, sizeof(create));
+    create.width = width;
+    create.height = height;
+    create.bpp = 32;
+    if (drmIoctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) < 0) {
+        std::cerr << "drm: create dumb buffer failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    buffer.handle = create.handle;
+    buffer.pitch = create.pitch;
+    buffer.size = create.size;
+
+    if (drmModeAddFB(fd, width, height, 24, 32, buffer.pitch, buffer.handle, &buffer.fbId) != 0) {
+        std::cerr << "drm: add framebuffer failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    drm_mode_map_dumb map;
+    std::memset(&map, 0, sizeof(map));
+    map.handle = buffer.handle;
+    if (drmIoctl(fd, DRM_IOCTL_MODE_MAP_DUMB, &map) < 0) {
+        std::cerr << "drm: map dumb buffer failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, buffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map.offset);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "drm: mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    buffer.map = static_cast<uint8_t*>(mapped);
+    return true;
+}
+
+void DrmFramebufferTarget::destroyBuffer(DumbBuffer& buffer) {
+    if (buffer.map) {
+        munmap(buffer.map, buffer.size);
+        buffer.map = nullptr;
+    }
+    if (buffer.fbId) {
+        drmModeRmFB(fd, buffer.fbId);
+        buffer.fbId = 0;
+    }
+    if (buffer.handle) {
+        drm_mode_destroy_dumb destroy;
+        std::memset(&destroy, 0, sizeof(destroy));
+        destroy.handle = buffer.handle;
+        drmIoctl(fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+        buffer.handle = 0;
+    }
+}
+
+void DrmFramebufferTarget::onPageFlip(int, unsigned int, unsigned int, unsigned int, void* data) {
+    *static_cast<bool*>(data) = false;
+}
+
+void DrmFramebufferTarget::waitForFlip() {
+    drmEventContext context;
+    std::memset(&context, 0, sizeof(context));
+    context.version = DRM_EVENT_CONTEXT_VERSION;
+    context.page_flip_handler = &DrmFramebufferTarget::onPageFlip;
+
+    while (flipPending) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) {
+            // Lost event (e.g. display unplugged): don't hang the renderer
+            flipPending = false;
+            break;
+        }
+        drmHandleEvent(fd, &context);
+    }
+}
+
+Framebuffer DrmFramebufferTarget::backBuffer() {
+    // The old front becomes our back buffer only once the flip has landed.
+    // Normally it has by the time the next frame starts.
+    waitForFlip();
+
+    const drmModeModeInfo* info = static_cast<drmModeModeInfo*>(mode);
+    DumbBuffer& buffer = buffers[back];
+    int stride = buffer.pitch / 4;
+    int offsetX = (info->hdisplay - drawWidth) / 2;
+    int offsetY = (info->vdisplay - drawHeight) / 2;
+
+    Framebuffer fb;
+    fb.pixels = reinterpret_cast<uint32_t*>(buffer.map) + offsetY * stride + offsetX;
+    fb.width = drawWidth;
+    fb.height = drawHeight;
+    fb.stride = stride;
+    return fb;
+}
+
+bool DrmFramebufferTarget::flip() {
+    if (drmModePageFlip(fd, crtcId, buffers[back].fbId, DRM_MODE_PAGE_FLIP_EVENT, &flipPending) != 0) {
+        return false;
+    }
+    flipPending = true;
+    back = 1 - back;
+    return true;
+}
+
+#else // !DRYER_HAVE_DRM
+
+bool DrmFramebufferTarget::open(int, int) {
+    std::cerr << "drm: built without libdrm" << std::endl;
+    return false;
+}
+
+void DrmFramebufferTarget::close() {}
+bool DrmFramebufferTarget::createBuffer(DumbBuffer&, int, int) { return false; }
+void DrmFramebufferTarget::destroyBuffer(DumbBuffer&) {}
+void DrmFramebufferTarget::onPageFlip(int, unsigned int, unsigned int, unsigned int, void*) {}
+void DrmFramebufferTarget::waitForFlip() {}
+
+Framebuffer DrmFramebufferTarget::backBuffer() {
+    Framebuffer fb = {nullptr, 0, 0, 0};
+    return fb;
+}
+
+bool DrmFramebufferTarget::flip() { return false; }
+
+#endif // DRYER_HAVE_DRM
+
+FramebufferTarget* createFramebufferTarget(const char* kind) {
+    if (std::strcmp(kind, "memory") == 0) return new MemoryFramebufferTarget();
+    if (std::strcmp(kind, "fbdev") == 0) return new FbdevFramebufferTarget();
+    if (std::strcmp(kind, "drm") == 0) return new DrmFramebufferTarget();
+    return nullptr;
+}
@@ -0,0 +1,131 @@
+#ifndef DRYER_FRAMEBUFFER_H
+#define DRYER_FRAMEBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// DRYER FRAMEBUFFER - Raw 32bpp scanout targets for the software renderer
+//   memory  - heap buffers, no display (headless runs, golden images)
+//   fbdev   - mmap of /dev/fb0
+//   drm     - two DRM dumb buffers with non-blocking page flips
+//             (needs libdrm at build time: DRYER_HAVE_DRM)
+// Pixels are XRGB8888 (0xFFRRGGBB).
+// ============================================================================
+
+struct Framebuffer {
+    uint32_t* pixels;       // top-left of the drawable area
+    int width;
+    int height;
+    int stride;             // pixels per row
+};
+
+class FramebufferTarget {
+public:
+    virtual ~FramebufferTarget() = default;
+
+    // Drawable area of width x height (centred if the display is larger)
+    virtual bool open(int width, int height) = 0;
+    virtual void close() = 0;
+
+    // Buffer to draw the next frame into. May wait for a pending flip.
+    virtual Framebuffer backBuffer() = 0;
+
+    // Show the back buffer. Does not wait for vblank.
+    virtual bool flip() = 0;
+
+    // Frames a back buffer lags behind the screen (1 = single buffered);
+    // the renderer repaints dirty regions of that many frames
+    virtual int bufferCount() const = 0;
+
+    virtual const char* name() const = 0;
+};
+
+// In-memory double buffer. frontBuffer() is what would be on screen.
+class MemoryFramebufferTarget : public FramebufferTarget {
+public:
+    MemoryFramebufferTarget();
+
+    bool open(int width, int height) override;
+    void close() override;
+    Framebuffer backBuffer() override;
+    bool flip() override;
+    int bufferCount() const override { return 2; }
+    const char* name() const override { return "memory"; }
+
+    Framebuffer frontBuffer();
+
+private:
+    std::vector<uint32_t> buffers[2];
+    int width;
+    int height;
+    int front;
+};
+
+// Linux fbdev (/dev/fb0), single buffered
+class FbdevFramebufferTarget : public FramebufferTarget {
+public:
+    explicit FbdevFramebufferTarget(const char* device = "/dev/fb0");
+    ~FbdevFramebufferTarget() override;
+
+    bool open(int width, int height) override;
+    void close() override;
+    Framebuffer backBuffer() override;
+    bool flip() override { return true; }
+    int bufferCount() const override { return 1; }
+    const char* name() const override { return "fbdev"; }
+
+private:
+    const char* device;
+    int fd;
+    uint8_t* mapping;
+    size_t mappingSize;
+    Framebuffer drawable;
+};
+
+// DRM/KMS dumb buffers, double buffered
+class DrmFramebufferTarget : public FramebufferTarget {
+public:
+    explicit DrmFramebufferTarget(const char* device = "/dev/dri/card0");
+    ~DrmFramebufferTarget() override;
+
+    bool open(int width, int height) override;
+    void close() override;
+    Framebuffer backBuffer() override;
+    bool flip() override;
+    int bufferCount() const override { return 2; }
+    const char* name() const override { return "drm"; }
+
+private:
+    struct DumbBuffer {
+        uint32_t handle;
+        uint32_t fbId;
+        uint32_t pitch;
+        uint64_t size;
+        uint8_t* map;
+    };
+
+    const char* device;
+    int fd;
+    uint32_t connectorId;
+    uint32_t crtcId;
+    void* mode;             // drmModeModeInfo (kept opaque here)
+    void* savedCrtc;        // drmModeCrtc to restore on close
+    DumbBuffer buffers[2];
+    int back;
+    bool flipPending;
+    bool opened;
+    int drawWidth;
+    int drawHeight;
+
+    bool createBuffer(DumbBuffer& buffer, int width, int height);
+    void destroyBuffer(DumbBuffer& buffer);
+    void waitForFlip();
+    static void onPageFlip(int fd, unsigned int frame, unsigned int sec, unsigned int usec, void* data);
+};
+
+// "memory", "fbdev" or "drm"; nullptr if unknown
+FramebufferTarget* createFramebufferTarget(const char* kind);
+
+#endif // DRYER_FRAMEBUFFER_H
@@ -0,0 +1,163 @@
+#include "dryer-geometry.h"
+#include <cmath>
+
+// Width of the fade-out ring around every edge (pixels)
+static const float FEATHER = 1.0f;
+
+static SDL_Color transparent(SDL_Color color) {
+    color.a = 0;
+    return color;
+}
+
+GeometryBuilder::GeometryBuilder() {
+    vertices.reserve(RESERVED_VERTICES);
+    indices.reserve(RESERVED_INDICES);
+    shapeStarts.reserve(RESERVED_SHAPES);
+}
+
+void GeometryBuilder::clear() {
+    vertices.clear();
+    indices.clear();
+    shapeStarts.clear();
+}
+
+int GeometryBuilder::addVertex(float x, float y, SDL_Color color) {
+    SDL_Vertex vertex;
+    vertex.position.x = x;
+    vertex.position.y = y;
+    vertex.color = color;
+    vertex.tex_coord.x = 0.0f;
+    vertex.tex_coord.y = 0.0f;
+    vertices.push_back(vertex);
+    return static_cast<int>(vertices.size()) - 1;
+}
+
+void GeometryBuilder::addQuad(int a, int b, int c, int d) {
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+    indices.push_back(a);
+    indices.push_back(c);
+    indices.push_back(d);
+}
+
+void GeometryBuilder::addStrokeSection(float x, float y, float nx, float ny, float halfWidth,
+                                       SDL_Color color) {
+    float fringe = halfWidth + FEATHER;
+    addVertex(x + nx * fringe, y + ny * fringe, transparent(color));
+    addVertex(x + nx * halfWidth, y + ny * halfWidth, color);
+    addVertex(x - nx * halfWidth, y - ny * halfWidth, color);
+    addVertex(x - nx * fringe, y - ny * fringe, transparent(color));
+}
+
+void GeometryBuilder::joinStrokeSections(int previous, int current) {
+    for (int k = 0; k < 3; k++) {
+        addQuad(previous + k, previous + k + 1, current + k + 1, current + k);
+    }
+}
+
+void GeometryBuilder::addArc(float cx, float cy, float radius, float startAngle, float endAngle,
+                             float thickness, SDL_Color color, int segments) {
+    shapeStarts.push_back(vertices.size());
+    float halfWidth = thickness * 0.5f;
+    int previous = -1;
+
+    for (int j = 0; j <= segments; j++) {
+        float angle = startAngle + (endAngle - startAngle) * j / segments;
+        float nx = std::cos(angle);
+        float ny = std::sin(angle);
+
+        int current = static_cast<int>(vertices.size());
+        addStrokeSection(cx + radius * nx, cy + radius * ny, nx, ny, halfWidth, color);
+
+        if (previous >= 0) {
+            joinStrokeSections(previous, current);
+        }
+        previous = current;
+    }
+}
+
+void GeometryBuilder::addLine(float x1, float y1, float x2, float y2, float thickness,
+                              SDL_Color color) {
+    shapeStarts.push_back(vertices.size());
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len < 0.001f) return;
+
+    float nx = -dy / len;
+    float ny = dx / len;
+    float halfWidth = thickness * 0.5f;
+
+    int start = static_cast<int>(vertices.size());
+    addStrokeSection(x1, y1, nx, ny, halfWidth, color);
+    int end = static_cast<int>(vertices.size());
+    addStrokeSection(x2, y2, nx, ny, halfWidth, color);
+    joinStrokeSections(start, end);
+}
+
+void GeometryBuilder::addDisc(float cx, float cy, float radius, SDL_Color centerColor,
+                              SDL_Color rimColor, int segments) {
+    shapeStarts.push_back(vertices.size());
+    int center = addVertex(cx, cy, centerColor);
+    int firstRim = static_cast<int>(vertices.size());
+
+    // Rim and feather rings, interleaved: rim i at firstRim + 2i
+    for (int j = 0; j < segments; j++) {
+        float angle = 2.0f * static_cast<float>(M_PI) * j / segments;
+        float nx = std::cos(angle);
+        float ny = std::sin(angle);
+        addVertex(cx + nx * radius, cy + ny * radius, rimColor);
+        addVertex(cx + nx * (radius + FEATHER), cy + ny * (radius + FEATHER), transparent(rimColor));
+    }
+
+    for (int j = 0; j < segments; j++) {
+        int rim = firstRim + 2 * j;
+        int nextRim = firstRim + 2 * ((j + 1) % segments);
+
+        indices.push_back(center);
+        indices.push_back(rim);
+        indices.push_back(nextRim);
+
+        addQuad(rim, rim + 1, nextRim + 1, nextRim);
+    }
+}
+
+void GeometryBuilder::addCircleMask(float cx, float cy, float radius, float halfSize,
+                                    SDL_Color color, int segments) {
+    shapeStarts.push_back(vertices.size());
+
+    // Outer ring reaches past the square's corners; the viewport clips it
+    float outerRadius = halfSize * 1.5f + FEATHER;
+    int first = static_cast<int>(vertices.size());
+
+    // Per sample: feather (alpha 0), circle edge, outer edge
+    for (int j = 0; j < segments; j++) {
+        float angle = 2.0f * static_cast<float>(M_PI) * j / segments;
+        float nx = std::cos(angle);
+        float ny = std::sin(angle);
+        addVertex(cx + nx * (radius - FEATHER), cy + ny * (radius - FEATHER), transparent(color));
+        addVertex(cx + nx * radius, cy + ny * radius, color);
+        addVertex(cx + nx * outerRadius, cy + ny * outerRadius, color);
+    }
+
+    for (int j = 0; j < segments; j++) {
+        int a = first + 3 * j;
+        int b = first + 3 * ((j + 1) % segments);
+        addQuad(a, a + 1, b + 1, b);
+        addQuad(a + 1, a + 2, b + 2, b + 1);
+    }
+}
+
+bool GeometryBuilder::submit(SDL_Renderer* renderer) const {
+    if (indices.empty()) return true;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    return SDL_RenderGeometry(renderer, nullptr,
+                              vertices.data(), static_cast<int>(vertices.size()),
+                              indices.data(), static_cast<int>(indices.size())) == 0;
+#else
+    (void)renderer;
+    return false;
+#endif
+}
@@ -0,0 +1,74 @@
+#ifndef DRYER_GEOMETRY_H
+#define DRYER_GEOMETRY_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+// ============================================================================
+// DRYER GEOMETRY - Triangle batch builder for SDL_RenderGeometry
+// Tessellates strokes, arcs and discs into one vertex/index buffer per frame.
+// Every edge gets a 1px feather ring fading to alpha 0, which reads as
+// anti-aliasing on the GLES2 driver without MSAA.
+// ============================================================================
+
+class GeometryBuilder {
+public:
+    GeometryBuilder();
+
+    void clear();
+
+    // Stroke along a circular arc (screen angles, radians, y down)
+    void addArc(float cx, float cy, float radius, float startAngle, float endAngle,
+                float thickness, SDL_Color color, int segments);
+
+    // Straight stroke with square ends
+    void addLine(float x1, float y1, float x2, float y2, float thickness, SDL_Color color);
+
+    // Filled disc with a radial gradient from centre to rim
+    void addDisc(float cx, float cy, float radius, SDL_Color centerColor, SDL_Color rimColor,
+                 int segments);
+
+    // Opaque fill between a circle and the enclosing square (round display mask)
+    void addCircleMask(float cx, float cy, float radius, float halfSize, SDL_Color color,
+                       int segments);
+
+    // One SDL_RenderGeometry call for everything added since clear()
+    bool submit(SDL_Renderer* renderer) const;
+
+    size_t vertexCount() const { return vertices.size(); }
+    size_t indexCount() const { return indices.size(); }
+
+    // Raw batch for the software rasterizer
+    const SDL_Vertex* vertexData() const { return vertices.data(); }
+    const int* indexData() const { return indices.data(); }
+
+    // Every add*() call is one shape. The software renderer compares
+    // shapes between frames to find what moved.
+    size_t shapeCount() const { return shapeStarts.size(); }
+    size_t shapeBegin(size_t shape) const { return shapeStarts[shape]; }
+    size_t shapeEnd(size_t shape) const {
+        return shape + 1 < shapeStarts.size() ? shapeStarts[shape + 1] : vertices.size();
+    }
+
+private:
+    // Capacity reserved up front; clear() keeps it, so steady state is
+    // allocation-free
+    static constexpr size_t RESERVED_VERTICES = 8192;
+    static constexpr size_t RESERVED_INDICES = 24576;
+    static constexpr size_t RESERVED_SHAPES = 256;
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    std::vector<size_t> shapeStarts;    // first vertex of each shape
+
+    int addVertex(float x, float y, SDL_Color color);
+    void addQuad(int a, int b, int c, int d);   // a-b on one edge, d-c on the other
+
+    // Cross section of a feathered stroke at one sample point:
+    // outer fringe, outer edge, inner edge, inner fringe
+    void addStrokeSection(float x, float y, float nx, float ny, float halfWidth, SDL_Color color);
+    void joinStrokeSections(int previous, int current);
+};
+
+#endif // DRYER_GEOMETRY_H
@@ -0,0 +1,270 @@
+#include "dryer-hardware-backend.h"
+#include "dryer-sim.h"
+#include "pins.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <gpiod.hpp>
+#include <iostream>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+static const int SWITCH_PINS[3] = {GPIO_BALL_TYPE, GPIO_LINT_TRAP, GPIO_MOON_GRAVITY};
+
+bool HardwareBackend::exchangeADC(uint16_t nextConfig, uint16_t& conversion) {
+    return readADCRegister(0, conversion) && writeADCRegister(1, nextConfig);
+}
+
+PiHardwareBackend::PiHardwareBackend()
+    : i2cHandle(-1)
+    , gpioChip(nullptr)
+    , clockEdgeBuffer(nullptr)
+    , readyEdgeBuffer(nullptr)
+{
+}
+
+PiHardwareBackend::~PiHardwareBackend() {
+    close();
+}
+
+bool PiHardwareBackend::openGPIO(const int* triggerPins, int triggerCount) {
+    try {
+        // Open GPIO chip (gpiochip0 for Raspberry Pi)
+        gpioChip = new gpiod::chip("gpiochip0");
+
+        // Configure input pins (switches) with pull-down
+        inputLines.resize(3);
+        for (int i = 0; i < 3; i++) {
+            inputLines[i] = gpioChip->prepare_request()
+                .set_consumer("dryer")
+                .add_line_settings(SWITCH_PINS[i],
+                    gpiod::line_settings()
+                        .set_direction(gpiod::line::direction::INPUT)
+                        .set_bias(gpiod::line::bias::PULL_DOWN))
+                .do_request();
+        }
+
+        // Configure output pins (triggers) initially low
+        outputLines.resize(triggerCount);
+        outputPins.assign(triggerPins, triggerPins + triggerCount);
+        for (int i = 0; i < triggerCount; i++) {
+            outputLines[i] = gpioChip->prepare_request()
+                .set_consumer("dryer")
+                .add_line_settings(triggerPins[i],
+                    gpiod::line_settings()
+                        .set_direction(gpiod::line::direction::OUTPUT)
+                        .set_output_value(gpiod::line::value::INACTIVE))
+                .do_request();
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "GPIO initialization error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool PiHardwareBackend::openADC() {
+    // Open I2C bus
+    i2cHandle = open("/dev/i2c-1", O_RDWR);
+    if (i2cHandle < 0) {
+        return false;
+    }
+
+    // Set I2C slave address
+    if (ioctl(i2cHandle, I2C_SLAVE, ADS1115_ADDRESS) < 0) {
+        ::close(i2cHandle);
+        i2cHandle = -1;
+        return false;
+    }
+    return true;
+}
+
+void PiHardwareBackend::close() {
+    // Close I2C
+    if (i2cHandle >= 0) {
+        ::close(i2cHandle);
+        i2cHandle = -1;
+    }
+
+    // Clear GPIO vectors (line_request destructor handles cleanup)
+    inputLines.clear();
+    outputLines.clear();
+    outputPins.clear();
+    clockLines.clear();
+    delete clockEdgeBuffer;
+    clockEdgeBuffer = nullptr;
+    readyLines.clear();
+    delete readyEdgeBuffer;
+    readyEdgeBuffer = nullptr;
+
+    // Close GPIO chip
+    delete gpioChip;
+    gpioChip = nullptr;
+}
+
+bool PiHardwareBackend::writeADCRegister(uint8_t reg, uint16_t value) {
+    uint8_t buffer[3] = {reg, static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value & 0xFF)};
+    return i2cHandle >= 0 && write(i2cHandle, buffer, 3) == 3;
+}
+
+bool PiHardwareBackend::readADCRegister(uint8_t reg, uint16_t& value) {
+    if (i2cHandle < 0) return false;
+
+    // Pointer write and read with a repeated start: one ioctl, no gap
+    uint8_t buffer[2];
+    i2c_msg messages[2] = {
+        {ADS1115_ADDRESS, 0, 1, &reg},
+        {ADS1115_ADDRESS, I2C_M_RD, 2, buffer},
+    };
+    i2c_rdwr_ioctl_data transfer = {messages, 2};
+    if (ioctl(i2cHandle, I2C_RDWR, &transfer) != 2) {
+        return false;
+    }
+    value = static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+    return true;
+}
+
+bool PiHardwareBackend::exchangeADC(uint16_t nextConfig, uint16_t& conversion) {
+    if (i2cHandle < 0) return false;
+
+    // Read the finished conversion and start the next one in one
+    // transaction: pointer, 2-byte read, config write
+    uint8_t pointer = 0;
+    uint8_t buffer[2];
+    uint8_t config[3] = {1, static_cast<uint8_t>(nextConfig >> 8), static_cast<uint8_t>(nextConfig & 0xFF)};
+    i2c_msg messages[3] = {
+        {ADS1115_ADDRESS, 0, 1, &pointer},
+        {ADS1115_ADDRESS, I2C_M_RD, 2, buffer},
+        {ADS1115_ADDRESS, 0, 3, config},
+    };
+    i2c_rdwr_ioctl_data transfer = {messages, 3};
+    if (ioctl(i2cHandle, I2C_RDWR, &transfer) != 3) {
+        return false;
+    }
+    conversion = static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+    return true;
+}
+
+bool PiHardwareBackend::enableADCReady(int pin) {
+    if (!gpioChip) return false;
+    if (!readyLines.empty()) return true;
+
+    try {
+        // Open drain, active low: pull it up
+        readyLines.push_back(gpioChip->prepare_request()
+            .set_consumer("dryer")
+            .add_line_settings(pin,
+                gpiod::line_settings()
+                    .set_direction(gpiod::line::direction::INPUT)
+                    .set_bias(gpiod::line::bias::PULL_UP)
+                    .set_edge_detection(gpiod::line::edge::FALLING)
+                    .set_event_clock(gpiod::line::clock::MONOTONIC))
+            .do_request());
+        readyEdgeBuffer = new gpiod::edge_event_buffer(4);
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "ADC ready input initialization error: " << e.what() << std::endl;
+        readyLines.clear();
+        return false;
+    }
+}
+
+int PiHardwareBackend::waitADCReady(int timeoutUs) {
+    if (readyLines.empty()) return -1;
+
+    try {
+        gpiod::line_request& request = readyLines[0];
+        if (!request.wait_edge_events(std::chrono::microseconds(timeoutUs))) {
+            return 0;
+        }
+        request.read_edge_events(*readyEdgeBuffer);
+        return 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "ADC ready input read error: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+bool PiHardwareBackend::readSwitch(int pin) {
+    try {
+        for (int i = 0; i < 3; i++) {
+            if (SWITCH_PINS[i] == pin && i < static_cast<int>(inputLines.size())) {
+                return inputLines[i].get_value(pin) == gpiod::line::value::ACTIVE;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "GPIO read error: " << e.what() << std::endl;
+    }
+    return false;
+}
+
+void PiHardwareBackend::writeTrigger(int pin, bool value) {
+    try {
+        for (size_t i = 0; i < outputPins.size(); i++) {
+            if (outputPins[i] == pin) {
+                outputLines[i].set_value(pin, value ? gpiod::line::value::ACTIVE : gpiod::line::value::INACTIVE);
+                return;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "GPIO write error: " << e.what() << std::endl;
+    }
+}
+
+bool PiHardwareBackend::enableClockInput() {
+    if (!gpioChip) return false;
+    if (!clockLines.empty()) return true;
+
+    try {
+        clockLines.push_back(gpioChip->prepare_request()
+            .set_consumer("dryer")
+            .add_line_settings(GPIO_CLOCK_IN,
+                gpiod::line_settings()
+                    .set_direction(gpiod::line::direction::INPUT)
+                    .set_bias(gpiod::line::bias::PULL_DOWN)
+                    .set_edge_detection(gpiod::line::edge::RISING)
+                    .set_event_clock(gpiod::line::clock::MONOTONIC))
+            .do_request());
+        clockEdgeBuffer = new gpiod::edge_event_buffer(16);
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Clock input initialization error: " << e.what() << std::endl;
+        clockLines.clear();
+        return false;
+    }
+}
+
+int PiHardwareBackend::readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) {
+    if (clockLines.empty()) return -1;
+
+    try {
+        gpiod::line_request& request = clockLines[0];
+        if (!request.wait_edge_events(std::chrono::milliseconds(timeoutMs))) {
+            return 0;
+        }
+
+        request.read_edge_events(*clockEdgeBuffer, maxEdges);
+        int count = 0;
+        for (const auto& event : *clockEdgeBuffer) {
+            if (count >= maxEdges) break;
+            timestampsNs[count++] = static_cast<uint64_t>(event.timestamp_ns());
+        }
+        return count;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Clock input read error: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+HardwareBackend* createHardwareBackend(const char* spec) {
+    if (std::strcmp(spec, "pi") == 0) return new PiHardwareBackend();
+    if (std::strcmp(spec, "sim") == 0) return new SimHardwareBackend();
+    return nullptr;
+}
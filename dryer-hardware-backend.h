@@ -0,0 +1,98 @@
+#ifndef DRYER_HARDWARE_BACKEND_H
+#define DRYER_HARDWARE_BACKEND_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Forward declare libgpiod C++ types
+namespace gpiod {
+    class chip;
+    class line_request;
+    class edge_event_buffer;
+}
+
+// ============================================================================
+// DRYER HARDWARE BACKEND - The I/O underneath DryerHardware
+//   pi    ADS1115 on /dev/i2c-1, switches/triggers/clock on gpiochip0
+//         (default)
+//   sim   scripted pots and switches, simulated ADS1115 timing, recorded
+//         gates (see dryer-sim.h)
+// DRYER_HARDWARE picks one. MIDI goes through MidiPort (DRYER_MIDI_OUT).
+// ============================================================================
+
+class HardwareBackend {
+public:
+    virtual ~HardwareBackend() = default;
+
+    // Claims the switches and the given trigger outputs
+    virtual bool openGPIO(const int* triggerPins, int triggerCount) = 0;
+    virtual bool openADC() = 0;
+    virtual void close() = 0;
+
+    // ADS1115 register access, one I2C transaction each
+    virtual bool writeADCRegister(uint8_t reg, uint16_t value) = 0;
+    virtual bool readADCRegister(uint8_t reg, uint16_t& value) = 0;
+
+    // Reads the conversion register, then writes nextConfig; one combined
+    // transaction where the bus allows it
+    virtual bool exchangeADC(uint16_t nextConfig, uint16_t& conversion);
+
+    // ADS1115 ALERT/RDY on a GPIO (falling edge at the end of a conversion).
+    // waitADCReady returns 1 on an edge, 0 on timeout, -1 if not enabled.
+    virtual bool enableADCReady(int pin) = 0;
+    virtual int waitADCReady(int timeoutUs) = 0;
+
+    virtual bool readSwitch(int pin) = 0;
+    virtual void writeTrigger(int pin, bool value) = 0;
+
+    // Rising edges on GPIO_CLOCK_IN, stamped on the latencyNowNs() clock
+    virtual bool enableClockInput() = 0;
+    virtual int readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) = 0;
+
+    // Simulated seconds per real second; 1 on real hardware
+    virtual double timeScale() const { return 1.0; }
+
+    // True once a scripted run has reached its end
+    virtual bool finished() const { return false; }
+
+    virtual void report(std::ostream&) const {}
+    virtual const char* name() const = 0;
+};
+
+// Raspberry Pi: I2C and libgpiod (the original hardware path)
+class PiHardwareBackend : public HardwareBackend {
+public:
+    PiHardwareBackend();
+    ~PiHardwareBackend() override;
+
+    bool openGPIO(const int* triggerPins, int triggerCount) override;
+    bool openADC() override;
+    void close() override;
+    bool writeADCRegister(uint8_t reg, uint16_t value) override;
+    bool readADCRegister(uint8_t reg, uint16_t& value) override;
+    bool exchangeADC(uint16_t nextConfig, uint16_t& conversion) override;
+    bool enableADCReady(int pin) override;
+    int waitADCReady(int timeoutUs) override;
+    bool readSwitch(int pin) override;
+    void writeTrigger(int pin, bool value) override;
+    bool enableClockInput() override;
+    int readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) override;
+    const char* name() const override { return "pi"; }
+
+private:
+    int i2cHandle;
+    gpiod::chip* gpioChip;
+    std::vector<gpiod::line_request> inputLines;    // 3 switches
+    std::vector<gpiod::line_request> outputLines;   // one per trigger
+    std::vector<int> outputPins;
+    std::vector<gpiod::line_request> clockLines;    // clock input, if enabled
+    gpiod::edge_event_buffer* clockEdgeBuffer;
+    std::vector<gpiod::line_request> readyLines;    // ALERT/RDY, if enabled
+    gpiod::edge_event_buffer* readyEdgeBuffer;
+};
+
+// "pi" or "sim"; nullptr if unknown
+HardwareBackend* createHardwareBackend(const char* spec);
+
+#endif // DRYER_HARDWARE_BACKEND_H
@@ -1,14 +1,13 @@
 #include "dryer-hardware.h"
+#include "dryer-sim.h"
 #include <iostream>
 #include <unistd.h>
-#include <fcntl.h>
-#include <sys/ioctl.h>
-#include <linux/i2c-dev.h>
-#include <termios.h>
 #include <chrono>
 #include <thread>
-#include <gpiod.hpp>
 #include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
 
 // ADS1115 Register addresses
 #define ADS1115_REG_CONVERSION  0x00
@@ -24,25 +23,43 @@
 #define ADS1115_MODE_SINGLE     0x0100
 #define ADS1115_DR_128SPS       0x0080
 
+// Data rate (samples/s) by DR bits; conversion-ready thresholds for ALERT/RDY
+static const int ADS1115_DATA_RATES[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+#define ADS1115_REG_LO_THRESH   0x02
+#define ADS1115_REG_HI_THRESH   0x03
+
+static const int TRIGGER_PINS[TRIGGER_OUTPUT_COUNT] = {
+    GPIO_TRIGGER_OUT_1, GPIO_TRIGGER_OUT_2, GPIO_TRIGGER_OUT_3, GPIO_TRIGGER_OUT_4
+};
+
 DryerHardware::DryerHardware() 
-    : i2cHandle(-1)
-    , uartHandle(-1)
+    : backend(nullptr)
+    , midiInput(nullptr)
     , initialized(false)
     , ads1115Available(false)
     , midiAvailable(false)
-    , gpioChip(nullptr)
+    , triggerCount(2)
 {
-    trigger1State.active = false;
-    trigger2State.active = false;
+    for (auto& state : triggerStates) {
+        state.active = false;
+        state.endTime = 0;
+    }
 }
 
 DryerHardware::~DryerHardware() {
     shutdown();
 }
 
-bool DryerHardware::initialize() {
+bool DryerHardware::initialize(int triggerCount) {
     std::cout << "Initializing Dryer hardware..." << std::endl;
     
+    this->triggerCount = std::max(1, std::min(triggerCount, TRIGGER_OUTPUT_COUNT));
+    
+    // Pi hardware or the simulator (DRYER_HARDWARE)
+    if (!createBackend()) {
+        return false;
+    }
+    
     // Initialize components
     bool gpioOk = initGPIO();
     bool adsOk = initADS1115();
@@ -57,14 +74,18 @@ bool DryerHardware::initialize() {
     }
     
     if (!midiOk) {
-        std::cerr << "WARNING: MIDI UART not available" << std::endl;
+        std::cerr << "WARNING: no MIDI port available" << std::endl;
     }
     
     initialized = true;
-    std::cout << "Hardware initialization complete" << std::endl;
+    std::cout << "Hardware initialization complete (" << backend->name() << ")" << std::endl;
     std::cout << "  GPIO: " << (gpioOk ? "OK" : "FAILED") << std::endl;
     std::cout << "  ADS1115: " << (adsOk ? "OK" : "NOT FOUND") << std::endl;
-    std::cout << "  MIDI: " << (midiOk ? "OK" : "NOT AVAILABLE") << std::endl;
+    std::cout << "  MIDI:";
+    for (MidiPort* port : midiPorts) {
+        std::cout << " " << port->name();
+    }
+    std::cout << (midiOk ? "" : " NOT AVAILABLE") << std::endl;
     
     return gpioOk;
 }
@@ -72,132 +93,88 @@ bool DryerHardware::initialize() {
 void DryerHardware::shutdown() {
     if (!initialized) return;
     
-    // Close I2C
-    if (i2cHandle >= 0) {
-        close(i2cHandle);
-        i2cHandle = -1;
+    // Sim runs: write out what was sent (DRYER_SIM_RECORD)
+    if (SimHardwareBackend* sim = dynamic_cast<SimHardwareBackend*>(backend)) {
+        sim->writeRecording(midiPorts);
     }
     
-    // Close UART
-    if (uartHandle >= 0) {
-        close(uartHandle);
-        uartHandle = -1;
+    // Close MIDI ports
+    for (MidiPort* port : midiPorts) {
+        port->close();
+        delete port;
     }
-    
-    // Clear GPIO vectors (line_request destructor handles cleanup)
-    gpioInputLines.clear();
-    gpioOutputLines.clear();
-    
-    // Close GPIO chip
-    if (gpioChip) {
-        delete gpioChip;
-        gpioChip = nullptr;
+    midiPorts.clear();
+    midiInput = nullptr;
+    midiAvailable = false;
+    
+    // Close I2C and GPIO
+    if (backend) {
+        backend->close();
+        delete backend;
+        backend = nullptr;
     }
     
     initialized = false;
     std::cout << "Hardware shutdown complete" << std::endl;
 }
 
-bool DryerHardware::initGPIO() {
-    try {
-        // Open GPIO chip (gpiochip0 for Raspberry Pi)
-        gpioChip = new gpiod::chip("gpiochip0");
-        
-        // Resize vectors to hold line requests
-        gpioInputLines.resize(3);
-        gpioOutputLines.resize(2);
-        
-        // Configure input pins (switches) with pull-down
-        const int inputPins[] = {GPIO_BALL_TYPE, GPIO_LINT_TRAP, GPIO_MOON_GRAVITY};
-        
-        for (int i = 0; i < 3; i++) {
-            gpioInputLines[i] = gpioChip->prepare_request()
-                .set_consumer("dryer")
-                .add_line_settings(inputPins[i], 
-                    gpiod::line_settings()
-                        .set_direction(gpiod::line::direction::INPUT)
-                        .set_bias(gpiod::line::bias::PULL_DOWN))
-                .do_request();
-        }
-        
-        // Configure output pins (triggers) initially low
-        const int outputPins[] = {GPIO_TRIGGER_OUT_1, GPIO_TRIGGER_OUT_2};
-        
-        for (int i = 0; i < 2; i++) {
-            gpioOutputLines[i] = gpioChip->prepare_request()
-                .set_consumer("dryer")
-                .add_line_settings(outputPins[i],
-                    gpiod::line_settings()
-                        .set_direction(gpiod::line::direction::OUTPUT)
-                        .set_output_value(gpiod::line::value::INACTIVE))
-                .do_request();
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "GPIO initialization error: " << e.what() << std::endl;
+bool DryerHardware::createBackend() {
+    const char* value = std::getenv("DRYER_HARDWARE");
+    const char* spec = value && value[0] ? value : "pi";
+    
+    backend = createHardwareBackend(spec);
+    if (!backend) {
+        std::cerr << "Unknown DRYER_HARDWARE=" << spec << std::endl;
         return false;
     }
+    if (SimHardwareBackend* sim = dynamic_cast<SimHardwareBackend*>(backend)) {
+        sim->loadFromEnvironment();
+    }
+    return true;
+}
+
+bool DryerHardware::initGPIO() {
+    return backend->openGPIO(TRIGGER_PINS, triggerCount);
 }
 
 bool DryerHardware::initADS1115() {
-    // Open I2C bus
-    i2cHandle = open("/dev/i2c-1", O_RDWR);
-    if (i2cHandle < 0) {
-        return false;
-    }
-    
-    // Set I2C slave address
-    if (ioctl(i2cHandle, I2C_SLAVE, ADS1115_ADDRESS) < 0) {
-        close(i2cHandle);
-        i2cHandle = -1;
-        return false;
-    }
-    
-    ads1115Available = true;
-    return true;
+    ads1115Available = backend->openADC();
+    return ads1115Available;
 }
 
 bool DryerHardware::initMIDI() {
-    // Open UART device
-    uartHandle = open(UART_DEVICE, O_WRONLY | O_NOCTTY);
-    if (uartHandle < 0) {
-        return false;
-    }
-    
-    // Configure UART for MIDI (31.25 kbaud, 8N1)
-    struct termios tty;
-    if (tcgetattr(uartHandle, &tty) != 0) {
-        close(uartHandle);
-        uartHandle = -1;
-        return false;
+    // DRYER_MIDI_OUT: one or more ports, all fed the same messages.
+    // The sim records to a fake port unless told otherwise.
+    const char* value = std::getenv("DRYER_MIDI_OUT");
+    bool simulated = std::strcmp(backend->name(), "sim") == 0;
+    std::string specs = value && value[0] ? value : (simulated ? "fake:65536" : "uart");
+    
+    size_t begin = 0;
+    while (begin <= specs.size()) {
+        size_t end = specs.find(',', begin);
+        if (end == std::string::npos) end = specs.size();
+        std::string spec = specs.substr(begin, end - begin);
+        begin = end + 1;
+        if (spec.empty()) continue;
+        
+        MidiPort* port = createMidiPort(spec.c_str());
+        if (!port) {
+            std::cerr << "WARNING: unknown MIDI port " << spec << std::endl;
+            continue;
+        }
+        if (!port->open()) {
+            std::cerr << "WARNING: MIDI port " << spec << " not available" << std::endl;
+            delete port;
+            continue;
+        }
+        midiPorts.push_back(port);
     }
     
-    // Set baud rate to 38400 (closest to 31250)
-    cfsetospeed(&tty, B38400);
-    
-    // 8N1 mode
-    tty.c_cflag &= ~PARENB;
-    tty.c_cflag &= ~CSTOPB;
-    tty.c_cflag &= ~CSIZE;
-    tty.c_cflag |= CS8;
-    tty.c_cflag &= ~CRTSCTS;
-    tty.c_cflag |= CLOCAL | CREAD;
-    
-    // Raw mode
-    tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
-    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
-    tty.c_oflag &= ~OPOST;
-    
-    if (tcsetattr(uartHandle, TCSANOW, &tty) != 0) {
-        close(uartHandle);
-        uartHandle = -1;
-        return false;
-    }
+    // MIDI clock is read from the first port listed
+    midiInput = midiPorts.empty() ? nullptr : midiPorts.front();
     
-    midiAvailable = true;
-    return true;
+    midiAvailable = !midiPorts.empty();
+    return midiAvailable;
 }
 
 uint16_t DryerHardware::readADC(uint8_t channel) {
@@ -220,78 +197,92 @@ uint16_t DryerHardware::readADC(uint8_t channel) {
     }
     
     // Write config register
-    uint8_t writeBuffer[3] = {
-        ADS1115_REG_CONFIG,
-        static_cast<uint8_t>(config >> 8),
-        static_cast<uint8_t>(config & 0xFF)
-    };
-    
-    if (write(i2cHandle, writeBuffer, 3) != 3) {
+    if (!backend->writeADCRegister(ADS1115_REG_CONFIG, config)) {
         return 0;
     }
     
-    // Wait for conversion
-    usleep(10000);
+    // Wait for conversion (a sped-up sim converts faster too)
+    usleep(static_cast<useconds_t>(10000 / timeScale()));
     
     // Read conversion register
-    uint8_t reg = ADS1115_REG_CONVERSION;
-    if (write(i2cHandle, &reg, 1) != 1) {
-        return 0;
-    }
-    
-    uint8_t readBuffer[2];
-    if (read(i2cHandle, readBuffer, 2) != 2) {
+    uint16_t value = 0;
+    if (!backend->readADCRegister(ADS1115_REG_CONVERSION, value)) {
         return 0;
     }
     
-    uint16_t value = (readBuffer[0] << 8) | readBuffer[1];
-    
     // Clip negative values
     if (value > 32768) value = 0;
     
     return value;
 }
 
-bool DryerHardware::readGPIO(int pin) {
-    try {
-        const int inputPins[] = {GPIO_BALL_TYPE, GPIO_LINT_TRAP, GPIO_MOON_GRAVITY};
-        
-        for (int i = 0; i < 3; i++) {
-            if (inputPins[i] == pin && i < (int)gpioInputLines.size()) {
-                auto value = gpioInputLines[i].get_value(inputPins[i]);
-                return value == gpiod::line::value::ACTIVE;
-            }
+bool DryerHardware::exchangeADC(int channel, int samplesPerSecond, uint16_t& previous) {
+    if (!ads1115Available || channel < 0 || channel > 3) return false;
+    
+    // Slowest rate at least as fast as asked for
+    int rateBits = 7;
+    for (int i = 0; i < 8; i++) {
+        if (ADS1115_DATA_RATES[i] >= samplesPerSecond) {
+            rateBits = i;
+            break;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "GPIO read error: " << e.what() << std::endl;
     }
-    return false;
+    
+    // Single shot. COMP_QUE stays 00 so ALERT/RDY is driven; it marks the
+    // end of a conversion once the thresholds select conversion-ready mode
+    uint16_t config = ADS1115_OS_SINGLE |
+                      static_cast<uint16_t>(ADS1115_MUX_AIN0 + (channel << 12)) |
+                      ADS1115_PGA_4_096V |
+                      ADS1115_MODE_SINGLE |
+                      static_cast<uint16_t>(rateBits << 5);
+    
+    if (!backend->exchangeADC(config, previous)) {
+        return false;
+    }
+    
+    // Clip negative values
+    if (previous > 32768) previous = 0;
+    return true;
+}
+
+bool DryerHardware::enableADCReady() {
+    if (!ads1115Available) return false;
+    
+    // Hi_thresh MSB = 1, Lo_thresh MSB = 0: ALERT/RDY pulses when a
+    // conversion is done
+    if (!backend->writeADCRegister(ADS1115_REG_LO_THRESH, 0x0000) ||
+        !backend->writeADCRegister(ADS1115_REG_HI_THRESH, 0x8000)) {
+        return false;
+    }
+    return backend->enableADCReady(GPIO_ADC_READY);
+}
+
+int DryerHardware::waitADCReady(int timeoutUs) {
+    if (!backend) return -1;
+    return backend->waitADCReady(timeoutUs);
+}
+
+bool DryerHardware::readGPIO(int pin) {
+    return backend->readSwitch(pin);
 }
 
 void DryerHardware::writeGPIO(int pin, bool value) {
-    try {
-        const int outputPins[] = {GPIO_TRIGGER_OUT_1, GPIO_TRIGGER_OUT_2};
-        
-        for (int i = 0; i < 2; i++) {
-            if (outputPins[i] == pin && i < (int)gpioOutputLines.size()) {
-                gpioOutputLines[i].set_value(outputPins[i], 
-                    value ? gpiod::line::value::ACTIVE : gpiod::line::value::INACTIVE);
-                return;
-            }
+    for (int i = 0; i < triggerCount; i++) {
+        if (TRIGGER_PINS[i] == pin) {
+            backend->writeTrigger(pin, value);
+            return;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "GPIO write error: " << e.what() << std::endl;
     }
 }
 
-HardwareParameters DryerHardware::readParameters() {
+HardwareParameters DryerHardware::readParameters(const uint16_t* adcValues) {
     HardwareParameters params;
     
-    // Read ADC values and map to parameter ranges
-    uint16_t rpmADC = readADC(ADC_CHAN_RPM);
-    uint16_t drumADC = readADC(ADC_CHAN_DRUM_SIZE);
-    uint16_t vanesADC = readADC(ADC_CHAN_VANES);
-    uint16_t heightADC = readADC(ADC_CHAN_VANE_HEIGHT);
+    // Read ADC values (or take the scheduler's) and map to parameter ranges
+    uint16_t rpmADC = adcValues ? adcValues[ADC_CHAN_RPM] : readADC(ADC_CHAN_RPM);
+    uint16_t drumADC = adcValues ? adcValues[ADC_CHAN_DRUM_SIZE] : readADC(ADC_CHAN_DRUM_SIZE);
+    uint16_t vanesADC = adcValues ? adcValues[ADC_CHAN_VANES] : readADC(ADC_CHAN_VANES);
+    uint16_t heightADC = adcValues ? adcValues[ADC_CHAN_VANE_HEIGHT] : readADC(ADC_CHAN_VANE_HEIGHT);
     
     params.rpm = mapADCToRange(rpmADC, ParamRanges::RPM_MIN, ParamRanges::RPM_MAX);
     params.drumSize = mapADCToRange(drumADC, ParamRanges::DRUM_SIZE_MIN, ParamRanges::DRUM_SIZE_MAX);
@@ -310,28 +301,80 @@ HardwareParameters DryerHardware::readParameters() {
     return params;
 }
 
-void DryerHardware::sendMIDIByte(uint8_t byte) {
-    if (midiAvailable && uartHandle >= 0) {
-        write(uartHandle, &byte, 1);
+void DryerHardware::sendMIDIMessage(const uint8_t* bytes, int count) {
+    // Same message to every port, in the output thread's order
+    for (MidiPort* port : midiPorts) {
+        port->send(bytes, count);
+    }
+}
+
+double DryerHardware::midiBytesPerSecond() const {
+    // The slowest port sets the pace (0 = none of them is a bottleneck)
+    double slowest = 0.0;
+    for (MidiPort* port : midiPorts) {
+        double rate = port->bytesPerSecond();
+        if (rate > 0.0 && (slowest == 0.0 || rate < slowest)) {
+            slowest = rate;
+        }
     }
+    return slowest;
 }
 
 void DryerHardware::sendMIDINoteOn(uint8_t noteNumber, uint8_t velocity, uint8_t channel) {
     if (!midiAvailable) return;
     
-    uint8_t statusByte = 0x90 | (channel & 0x0F);
-    sendMIDIByte(statusByte);
-    sendMIDIByte(noteNumber & 0x7F);
-    sendMIDIByte(velocity & 0x7F);
+    uint8_t message[3] = {static_cast<uint8_t>(0x90 | (channel & 0x0F)),
+                          static_cast<uint8_t>(noteNumber & 0x7F),
+                          static_cast<uint8_t>(velocity & 0x7F)};
+    sendMIDIMessage(message, 3);
 }
 
 void DryerHardware::sendMIDINoteOff(uint8_t noteNumber, uint8_t channel) {
     if (!midiAvailable) return;
     
-    uint8_t statusByte = 0x80 | (channel & 0x0F);
-    sendMIDIByte(statusByte);
-    sendMIDIByte(noteNumber & 0x7F);
-    sendMIDIByte(0);
+    uint8_t message[3] = {static_cast<uint8_t>(0x80 | (channel & 0x0F)),
+                          static_cast<uint8_t>(noteNumber & 0x7F), 0};
+    sendMIDIMessage(message, 3);
+}
+
+void DryerHardware::sendMIDIControlChange(uint8_t controller, uint8_t value, uint8_t channel) {
+    if (!midiAvailable) return;
+    
+    uint8_t message[3] = {static_cast<uint8_t>(0xB0 | (channel & 0x0F)),
+                          static_cast<uint8_t>(controller & 0x7F),
+                          static_cast<uint8_t>(value & 0x7F)};
+    sendMIDIMessage(message, 3);
+}
+
+void DryerHardware::sendMIDIPitchBend(int value, uint8_t channel) {
+    if (!midiAvailable) return;
+    
+    // 14 bits, centre 0x2000, LSB first
+    int raw = std::max(0, std::min(16383, value + 8192));
+    uint8_t message[3] = {static_cast<uint8_t>(0xE0 | (channel & 0x0F)),
+                          static_cast<uint8_t>(raw & 0x7F),
+                          static_cast<uint8_t>((raw >> 7) & 0x7F)};
+    sendMIDIMessage(message, 3);
+}
+
+int DryerHardware::readMIDIInput(uint8_t* buffer, int size, int timeoutMs) {
+    if (!midiInput) return -1;
+    return midiInput->receive(buffer, size, timeoutMs);
+}
+
+bool DryerHardware::enableClockInput() {
+    return backend && backend->enableClockInput();
+}
+
+int DryerHardware::readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) {
+    if (!backend) return -1;
+    return backend->readClockEdges(timestampsNs, maxEdges, timeoutMs);
+}
+
+void DryerHardware::report(std::ostream& out) const {
+    if (backend) {
+        backend->report(out);
+    }
 }
 
 void DryerHardware::triggerPulse(int triggerPin, int durationMs) {
@@ -343,31 +386,29 @@ void DryerHardware::triggerPulse(int triggerPin, int durationMs) {
     auto endTime = now + std::chrono::milliseconds(durationMs);
     
     // Store state
-    if (triggerPin == GPIO_TRIGGER_OUT_1) {
-        trigger1State.active = true;
-        trigger1State.endTime = std::chrono::duration_cast<std::chrono::microseconds>(
-            endTime.time_since_epoch()).count();
-    } else if (triggerPin == GPIO_TRIGGER_OUT_2) {
-        trigger2State.active = true;
-        trigger2State.endTime = std::chrono::duration_cast<std::chrono::microseconds>(
-            endTime.time_since_epoch()).count();
+    for (int i = 0; i < triggerCount; i++) {
+        if (TRIGGER_PINS[i] == triggerPin) {
+            triggerStates[i].active = true;
+            triggerStates[i].endTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                endTime.time_since_epoch()).count();
+        }
     }
 }
 
+int DryerHardware::triggerPin(int output) {
+    return (output >= 0 && output < TRIGGER_OUTPUT_COUNT) ? TRIGGER_PINS[output] : -1;
+}
+
 void DryerHardware::updateTriggers() {
     auto now = std::chrono::steady_clock::now();
     uint64_t nowMicros = std::chrono::duration_cast<std::chrono::microseconds>(
         now.time_since_epoch()).count();
     
-    // Check trigger 1
-    if (trigger1State.active && nowMicros >= trigger1State.endTime) {
-        writeGPIO(GPIO_TRIGGER_OUT_1, false);
-        trigger1State.active = false;
-    }
-    
-    // Check trigger 2
-    if (trigger2State.active && nowMicros >= trigger2State.endTime) {
-        writeGPIO(GPIO_TRIGGER_OUT_2, false);
-        trigger2State.active = false;
+    // End pulses that are due
+    for (int i = 0; i < triggerCount; i++) {
+        if (triggerStates[i].active && nowMicros >= triggerStates[i].endTime) {
+            writeGPIO(TRIGGER_PINS[i], false);
+            triggerStates[i].active = false;
+        }
     }
 }
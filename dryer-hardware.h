@@ -2,19 +2,17 @@
 #define DRYER_HARDWARE_H
 
 #include "pins.h"
+#include "dryer-hardware-backend.h"
+#include "dryer-midi-port.h"
 #include <cstdint>
 #include <functional>
+#include <ostream>
 #include <vector>
 
-// Forward declare libgpiod C++ types
-namespace gpiod { 
-    class chip; 
-    class line_request; 
-}
-
 // ============================================================================
 // DRYER HARDWARE INTERFACE
-// Handles: ADS1115 ADC, GPIO, MIDI UART, Trigger outputs
+// Handles: ADS1115 ADC, GPIO, MIDI ports (UART, ALSA), Trigger outputs,
+// on the Pi or simulated (DRYER_HARDWARE, see dryer-hardware-backend.h)
 // ============================================================================
 
 // Parameter structure read from hardware
@@ -34,41 +32,77 @@ public:
     DryerHardware();
     ~DryerHardware();
     
-    // Initialization
-    bool initialize();
+    // Initialization. Claims the first triggerCount trigger outputs:
+    // 2 normally, one per drum in polyrhythm mode.
+    bool initialize(int triggerCount = 2);
     void shutdown();
     
-    // Read parameters from pots and switches
-    HardwareParameters readParameters();
+    // Read parameters from pots and switches. With adcValues (raw codes by
+    // channel, e.g. from AdcScheduler) the ADC isn't touched.
+    HardwareParameters readParameters(const uint16_t* adcValues = nullptr);
+    
+    // ADC acquisition for AdcScheduler: reads the finished conversion and
+    // starts a single-shot one on channel, in one I2C transaction
+    bool hasADC() const { return ads1115Available; }
+    bool exchangeADC(int channel, int samplesPerSecond, uint16_t& previous);
+    
+    // ALERT/RDY on GPIO_ADC_READY: 1 = conversion done, 0 = timeout,
+    // -1 = not wired / not enabled
+    bool enableADCReady();
+    int waitADCReady(int timeoutUs);
     
     // MIDI output
     void sendMIDINoteOn(uint8_t noteNumber, uint8_t velocity, uint8_t channel = 0);
     void sendMIDINoteOff(uint8_t noteNumber, uint8_t channel = 0);
+    void sendMIDIControlChange(uint8_t controller, uint8_t value, uint8_t channel = 0);
+    void sendMIDIPitchBend(int value, uint8_t channel = 0);     // -8192..8191
+    
+    // Output budget: bytes/s of the slowest MIDI port, 0 = no slow port
+    double midiBytesPerSecond() const;
+    
+    // MIDI input (first port in DRYER_MIDI_OUT): waits up to timeoutMs,
+    // returns the bytes read, 0 on timeout, -1 without an input
+    int readMIDIInput(uint8_t* buffer, int size, int timeoutMs);
+    
+    // Clock/gate input on GPIO_CLOCK_IN (rising edges). Edge times are
+    // kernel timestamps on the same clock as latencyNowNs().
+    bool enableClockInput();
+    int readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs);
     
     // Trigger outputs (for eurorack CV/Gate)
     void triggerPulse(int triggerPin, int durationMs = GPIO_TRIG_PULSE_MS);
     
+    // GPIO of trigger output 0..TRIGGER_OUTPUT_COUNT-1
+    static int triggerPin(int output);
+    
     // Status
     bool isInitialized() const { return initialized; }
     
+    // Simulated seconds per real second (1 on the Pi), and whether a
+    // scripted sim run is over
+    double timeScale() const { return backend ? backend->timeScale() : 1.0; }
+    bool finished() const { return backend && backend->finished(); }
+    void report(std::ostream& out) const;
+    
 private:
+    // Pi or sim (DRYER_HARDWARE)
+    HardwareBackend* backend;
+    bool createBackend();
+    
     // I2C/ADC
-    int i2cHandle;
     uint16_t readADC(uint8_t channel);
     bool initADS1115();
     
-    // GPIO - libgpiod C++ API (v2)
-    gpiod::chip *gpioChip;
-    std::vector<gpiod::line_request> gpioInputLines;   // 3 switches
-    std::vector<gpiod::line_request> gpioOutputLines;  // 2 triggers
+    // GPIO
     bool initGPIO();
     bool readGPIO(int pin);
     void writeGPIO(int pin, bool value);
     
-    // MIDI UART
-    int uartHandle;
+    // MIDI ports (DRYER_MIDI_OUT, default the UART)
+    std::vector<MidiPort*> midiPorts;
+    MidiPort* midiInput;
     bool initMIDI();
-    void sendMIDIByte(uint8_t byte);
+    void sendMIDIMessage(const uint8_t* bytes, int count);
     
     // State
     bool initialized;
@@ -80,12 +114,13 @@ private:
         bool active;
         uint64_t endTime;
     };
-    TriggerState trigger1State;
-    TriggerState trigger2State;
+    TriggerState triggerStates[TRIGGER_OUTPUT_COUNT];
+    int triggerCount;
     
     // Update trigger outputs (call this regularly)
     void updateTriggers();
     friend class DryerApp;
+    friend class DryerOutput;
 };
 
 #endif // DRYER_HARDWARE_H
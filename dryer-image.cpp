@@ -0,0 +1,221 @@
+#include "dryer-image.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static bool hasExtension(const char* path, const char* extension) {
+    size_t pathLen = std::strlen(path);
+    size_t extLen = std::strlen(extension);
+    return pathLen >= extLen && std::strcmp(path + pathLen - extLen, extension) == 0;
+}
+
+bool writeImage(const char* path, const Framebuffer& frame) {
+    if (hasExtension(path, ".png")) return writePNG(path, frame);
+    if (hasExtension(path, ".ppm")) return writePPM(path, frame);
+    if (hasExtension(path, ".raw")) return writeRaw(path, frame);
+
+    std::cerr << "Unknown image format: " << path << " (use .png, .ppm or .raw)" << std::endl;
+    return false;
+}
+
+// ============================================================================
+// PNG
+// ============================================================================
+
+static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    putBE32(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    putBE32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool writePNG(const char* path, const Framebuffer& frame) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    putBE32(header, frame.width);
+    putBE32(header, frame.height);
+    header.push_back(8);     // bit depth
+    header.push_back(2);     // colour type: RGB
+    header.push_back(0);     // deflate
+    header.push_back(0);     // adaptive filtering
+    header.push_back(0);     // no interlace
+    writeChunk(file, "IHDR", header);
+
+    // Scanlines: filter type 0, then RGB
+    std::vector<uint8_t> raw;
+    raw.reserve(static_cast<size_t>(frame.height) * (frame.width * 3 + 1));
+    for (int y = 0; y < frame.height; y++) {
+        const uint32_t* row = frame.pixels + y * frame.stride;
+        raw.push_back(0);
+        for (int x = 0; x < frame.width; x++) {
+            raw.push_back((row[x] >> 16) & 0xFF);
+            raw.push_back((row[x] >> 8) & 0xFF);
+            raw.push_back(row[x] & 0xFF);
+        }
+    }
+
+    // zlib stream of stored (uncompressed) deflate blocks
+    std::vector<uint8_t> idat;
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    size_t offset = 0;
+    do {
+        size_t length = std::min<size_t>(raw.size() - offset, 65535);
+        bool last = offset + length == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(length & 0xFF);
+        idat.push_back(length >> 8);
+        idat.push_back(~length & 0xFF);
+        idat.push_back((~length >> 8) & 0xFF);
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(idat, (b << 16) | a);
+    writeChunk(file, "IDAT", idat);
+
+    writeChunk(file, "IEND", std::vector<uint8_t>());
+    return static_cast<bool>(file);
+}
+
+// ============================================================================
+// PPM / raw
+// ============================================================================
+
+bool writePPM(const char* path, const Framebuffer& frame) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << frame.width << " " << frame.height << "\n255\n";
+
+    std::vector<uint8_t> row(frame.width * 3);
+    for (int y = 0; y < frame.height; y++) {
+        const uint32_t* pixels = frame.pixels + y * frame.stride;
+        for (int x = 0; x < frame.width; x++) {
+            row[x * 3] = (pixels[x] >> 16) & 0xFF;
+            row[x * 3 + 1] = (pixels[x] >> 8) & 0xFF;
+            row[x * 3 + 2] = pixels[x] & 0xFF;
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    return static_cast<bool>(file);
+}
+
+bool writeRaw(const char* path, const Framebuffer& frame) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    for (int y = 0; y < frame.height; y++) {
+        file.write(reinterpret_cast<const char*>(frame.pixels + y * frame.stride),
+                   frame.width * sizeof(uint32_t));
+    }
+    return static_cast<bool>(file);
+}
+
+bool readPPM(const char* path, Image& image) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::string magic;
+    int maxValue = 0;
+    file >> magic >> image.width >> image.height >> maxValue;
+    file.get();  // single whitespace before the pixel data
+    if (!file || magic != "P6" || maxValue != 255 || image.width <= 0 || image.height <= 0) {
+        std::cerr << "Not a binary 8-bit PPM: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> rgb(static_cast<size_t>(image.width) * image.height * 3);
+    file.read(reinterpret_cast<char*>(rgb.data()), rgb.size());
+    if (!file) {
+        std::cerr << "Truncated PPM: " << path << std::endl;
+        return false;
+    }
+
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+    for (size_t i = 0; i < image.pixels.size(); i++) {
+        image.pixels[i] = 0xFF000000u | (rgb[i * 3] << 16) | (rgb[i * 3 + 1] << 8) | rgb[i * 3 + 2];
+    }
+    return true;
+}
+
+ImageDiff compareImages(const Framebuffer& frame, const Image& reference, int tolerance) {
+    ImageDiff diff = {0, 0};
+    if (frame.width != reference.width || frame.height != reference.height) {
+        diff.differentPixels = -1;
+        return diff;
+    }
+
+    for (int y = 0; y < frame.height; y++) {
+        const uint32_t* row = frame.pixels + y * frame.stride;
+        const uint32_t* expected = reference.pixels.data() + y * reference.width;
+        for (int x = 0; x < frame.width; x++) {
+            int worst = 0;
+            for (int shift = 0; shift <= 16; shift += 8) {
+                int delta = std::abs(static_cast<int>((row[x] >> shift) & 0xFF) -
+                                     static_cast<int>((expected[x] >> shift) & 0xFF));
+                worst = std::max(worst, delta);
+            }
+            diff.maxChannelDelta = std::max(diff.maxChannelDelta, worst);
+            if (worst > tolerance) {
+                diff.differentPixels++;
+            }
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,40 @@
+#ifndef DRYER_IMAGE_H
+#define DRYER_IMAGE_H
+
+#include "dryer-framebuffer.h"
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// DRYER IMAGE - Frame dumps for headless runs and golden-image checks
+//   .png  - RGB, uncompressed deflate (no zlib dependency), for viewing
+//   .ppm  - binary P6, read back for golden comparisons
+//   .raw  - XRGB8888 rows as in memory, no header
+// ============================================================================
+
+struct Image {
+    std::vector<uint32_t> pixels;   // 0xFFRRGGBB, tightly packed
+    int width;
+    int height;
+
+    Image() : width(0), height(0) {}
+};
+
+// Format chosen by file extension
+bool writeImage(const char* path, const Framebuffer& frame);
+
+bool writePNG(const char* path, const Framebuffer& frame);
+bool writePPM(const char* path, const Framebuffer& frame);
+bool writeRaw(const char* path, const Framebuffer& frame);
+
+bool readPPM(const char* path, Image& image);
+
+struct ImageDiff {
+    int differentPixels;    // pixels with any channel off by more than the tolerance
+    int maxChannelDelta;
+};
+
+// Sizes must match (differentPixels = -1 otherwise)
+ImageDiff compareImages(const Framebuffer& frame, const Image& reference, int tolerance);
+
+#endif // DRYER_IMAGE_H
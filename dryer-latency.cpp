@@ -0,0 +1,307 @@
+#include "dryer-latency.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static const char* STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+    "detect->queue",
+    "queue->dispatch",
+    "detect->midi",
+    "detect->gate",
+    "due->midi"
+};
+
+static const char* BOOT_NAMES[BOOT_MILESTONE_COUNT] = {
+    "hardware ready",
+    "physics running",
+    "display ready",
+    "first hit",
+    "first gate",
+    "first frame"
+};
+
+// When the kernel started this process, on the latencyNowNs() clock:
+// /proc/self/stat has it in clock ticks since boot. Now, if unreadable.
+static uint64_t processStartTimeNs() {
+    uint64_t nowNs = latencyNowNs();
+    FILE* file = std::fopen("/proc/self/stat", "r");
+    if (!file) return nowNs;
+
+    char line[1024];
+    bool read = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+
+    // Field 22; the command name (field 2) may hold spaces, so count
+    // from the closing parenthesis
+    const char* fields = read ? std::strrchr(line, ')') : nullptr;
+    unsigned long long startTicks = 0;
+    if (!fields || std::sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+                               &startTicks) != 1) {
+        return nowNs;
+    }
+
+    timespec boot;
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (ticksPerSecond <= 0 || clock_gettime(CLOCK_BOOTTIME, &boot) != 0) return nowNs;
+    uint64_t sinceBootNs = static_cast<uint64_t>(boot.tv_sec) * 1000000000ULL + boot.tv_nsec;
+    uint64_t startedNs = startTicks * (1000000000ULL / ticksPerSecond);
+    uint64_t ageNs = sinceBootNs > startedNs ? sinceBootNs - startedNs : 0;
+    return nowNs > ageNs ? nowNs - ageNs : 0;
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < LINEAR_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);      // >= 5
+    int shift = msb - 4;                        // keep 5 significant bits
+    int top = static_cast<int>(value >> shift); // in [16, 32)
+    return LINEAR_BUCKETS + (shift - 1) * SUB_BUCKETS + (top - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < LINEAR_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    int k = index - LINEAR_BUCKETS;
+    int shift = k / SUB_BUCKETS + 1;
+    uint64_t top = static_cast<uint64_t>(k % SUB_BUCKETS + SUB_BUCKETS);
+    return (top << shift) + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalSum.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t current = minValue.load(std::memory_order_relaxed);
+    while (valueNs < current &&
+           !minValue.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+
+    current = maxValue.load(std::memory_order_relaxed);
+    while (valueNs > current &&
+           !maxValue.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    totalCount.store(0, std::memory_order_relaxed);
+    totalSum.store(0, std::memory_order_relaxed);
+    minValue.store(UINT64_MAX, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::min() const {
+    uint64_t value = minValue.load(std::memory_order_relaxed);
+    return value == UINT64_MAX ? 0 : value;
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(totalSum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(p / 100.0 * n));
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max();
+}
+
+// ============================================================================
+// LatencyStats
+// ============================================================================
+
+LatencyStats::LatencyStats()
+    : droppedEvents(0)
+    , processStartNs(processStartTimeNs())
+{
+    for (auto& ns : bootNs) {
+        ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyStats::record(LatencyStage stage, uint64_t startNs, uint64_t endNs) {
+    histograms[stage].record(endNs > startNs ? endNs - startNs : 0);
+}
+
+void LatencyStats::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+    droppedEvents.store(0, std::memory_order_relaxed);
+}
+
+void LatencyStats::markBoot(BootMilestone milestone) {
+    if (bootNs[milestone].load(std::memory_order_relaxed) != 0) return;
+    uint64_t expected = 0;
+    uint64_t nowNs = latencyNowNs();
+    bootNs[milestone].compare_exchange_strong(expected, nowNs > processStartNs ? nowNs - processStartNs : 1,
+                                              std::memory_order_relaxed);
+}
+
+uint64_t LatencyStats::bootTimeNs(BootMilestone milestone) const {
+    return bootNs[milestone].load(std::memory_order_relaxed);
+}
+
+void LatencyStats::dump(std::ostream& out) const {
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "=== Dryer latency (us) ===\n";
+    out << std::left << std::setw(17) << "stage" << std::right
+        << std::setw(9) << "count"
+        << std::setw(9) << "min"
+        << std::setw(9) << "mean"
+        << std::setw(9) << "p50"
+        << std::setw(9) << "p90"
+        << std::setw(9) << "p99"
+        << std::setw(9) << "p99.9"
+        << std::setw(9) << "max" << "\n";
+
+    out << std::fixed << std::setprecision(1);
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        const LatencyHistogram& h = histograms[i];
+        out << std::left << std::setw(17) << STAGE_NAMES[i] << std::right
+            << std::setw(9) << h.count()
+            << std::setw(9) << us(h.min())
+            << std::setw(9) << h.mean() / 1000.0
+            << std::setw(9) << us(h.percentile(50.0))
+            << std::setw(9) << us(h.percentile(90.0))
+            << std::setw(9) << us(h.percentile(99.0))
+            << std::setw(9) << us(h.percentile(99.9))
+            << std::setw(9) << us(h.max()) << "\n";
+    }
+    out << "dropped events: " << droppedEvents.load(std::memory_order_relaxed) << "\n";
+
+    out << "boot (ms after process start):";
+    for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+        uint64_t ns = bootNs[i].load(std::memory_order_relaxed);
+        out << (i > 0 ? "," : "") << " " << BOOT_NAMES[i] << " ";
+        if (ns != 0) {
+            out << ns / 1e6;
+        } else {
+            out << "-";
+        }
+    }
+    out << "\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+// ============================================================================
+// LatencyStatsServer
+// ============================================================================
+
+LatencyStatsServer::LatencyStatsServer(const LatencyStats& stats)
+    : stats(stats)
+    , listenFd(-1)
+    , running(false)
+    , socketPath(nullptr)
+{
+}
+
+LatencyStatsServer::~LatencyStatsServer() {
+    stop();
+}
+
+bool LatencyStatsServer::start(const char* path) {
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        return false;
+    }
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    unlink(path);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, 2) < 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    socketPath = path;
+    running = true;
+    thread = std::thread(&LatencyStatsServer::serve, this);
+    return true;
+}
+
+void LatencyStatsServer::stop() {
+    if (!running) return;
+
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath);
+}
+
+void LatencyStatsServer::serve() {
+    while (running) {
+        // Poll so stop() is noticed without having to break accept()
+        pollfd pfd = {listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) {
+            continue;
+        }
+
+        int client = accept(listenFd, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+
+        std::ostringstream text;
+        stats.dump(text);
+        std::string payload = text.str();
+
+        const char* data = payload.data();
+        size_t remaining = payload.size();
+        while (remaining > 0) {
+            // A client gone early must not raise SIGPIPE
+            ssize_t written = send(client, data, remaining, MSG_NOSIGNAL);
+            if (written <= 0) break;
+            data += written;
+            remaining -= written;
+        }
+        close(client);
+    }
+}
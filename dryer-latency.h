@@ -0,0 +1,119 @@
+#ifndef DRYER_LATENCY_H
+#define DRYER_LATENCY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+// ============================================================================
+// DRYER LATENCY INSTRUMENTATION
+// Lock-free HDR-style histograms for collision -> MIDI/gate latency
+// ============================================================================
+
+// Local socket that prints the stats table to any client that connects
+#define STATS_SOCKET_PATH   "/run/dryer-stats.sock"
+
+// Monotonic timestamp used for every latency stamp (nanoseconds)
+inline uint64_t latencyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Log-linear histogram: exact below 32ns, then 16 sub-buckets per power
+// of two (~6% relative precision) up to the full 64-bit range.
+// record() is wait-free apart from the min/max CAS and safe from any thread.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t valueNs);
+    void reset();
+
+    uint64_t count() const { return totalCount.load(std::memory_order_relaxed); }
+    uint64_t min() const;
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+    double mean() const;
+    uint64_t percentile(double p) const;   // p in [0, 100]
+
+private:
+    static constexpr int LINEAR_BUCKETS = 32;
+    static constexpr int SUB_BUCKETS = 16;
+    static constexpr int BUCKET_COUNT = LINEAR_BUCKETS + 59 * SUB_BUCKETS;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> totalCount;
+    std::atomic<uint64_t> totalSum;
+    std::atomic<uint64_t> minValue;
+    std::atomic<uint64_t> maxValue;
+};
+
+// Pipeline stages measured for every collision
+enum LatencyStage {
+    LATENCY_DETECT_TO_QUEUE = 0,    // physics hit -> pushed to output queue
+    LATENCY_QUEUE_TO_DISPATCH,      // queued -> picked up by output thread
+    LATENCY_DETECT_TO_MIDI,         // physics hit -> MIDI write() returned
+    LATENCY_DETECT_TO_GATE,         // physics hit -> gate set_value() returned
+    LATENCY_DUE_TO_MIDI,            // quantized event due -> MIDI write() returned
+    LATENCY_STAGE_COUNT
+};
+
+// Startup milestones, timed from when the kernel started the process (so
+// the dynamic loader and static constructors count), to 10 ms
+enum BootMilestone {
+    BOOT_HARDWARE_READY = 0,        // GPIO, I2C, UART, ADC and output thread up
+    BOOT_PHYSICS_RUNNING,           // physics thread started
+    BOOT_DISPLAY_READY,             // renderer initialized
+    BOOT_FIRST_HIT,                 // first collision detected
+    BOOT_FIRST_GATE,                // first trigger pulse out
+    BOOT_FIRST_FRAME,               // first frame drawn
+    BOOT_MILESTONE_COUNT
+};
+
+class LatencyStats {
+public:
+    LatencyStats();
+
+    void record(LatencyStage stage, uint64_t startNs, uint64_t endNs);
+    void recordDrop() { droppedEvents.fetch_add(1, std::memory_order_relaxed); }
+    void reset();
+
+    // First call per milestone counts; any thread, cheap after that
+    void markBoot(BootMilestone milestone);
+    uint64_t bootTimeNs(BootMilestone milestone) const;    // since process start, 0 = not yet
+
+    // Human readable table, values in microseconds
+    void dump(std::ostream& out) const;
+
+private:
+    LatencyHistogram histograms[LATENCY_STAGE_COUNT];
+    std::atomic<uint64_t> droppedEvents;
+    uint64_t processStartNs;        // latencyNowNs() timebase
+    std::atomic<uint64_t> bootNs[BOOT_MILESTONE_COUNT];
+};
+
+// Serves LatencyStats::dump() on a Unix domain socket, e.g.
+//   socat - UNIX-CONNECT:/run/dryer-stats.sock
+class LatencyStatsServer {
+public:
+    explicit LatencyStatsServer(const LatencyStats& stats);
+    ~LatencyStatsServer();
+
+    bool start(const char* path = STATS_SOCKET_PATH);
+    void stop();
+
+private:
+    const LatencyStats& stats;
+    int listenFd;
+    std::atomic<bool> running;
+    std::thread thread;
+    const char* socketPath;
+
+    void serve();
+};
+
+#endif // DRYER_LATENCY_H
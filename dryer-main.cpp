@@ -1,10 +1,25 @@
 #include "dryer-physics.h"
+#include "dryer-drums.h"
+#include "dryer-clock.h"
+#include "dryer-quantize.h"
+#include "dryer-adc.h"
+#include "dryer-midi.h"
 #include "dryer-hardware.h"
 #include "dryer-renderer.h"
+#include "dryer-output.h"
+#include "dryer-latency.h"
+#include "dryer-realtime.h"
+#include "dryer-alloc.h"
+#include "dryer-frame-scheduler.h"
+#include "dryer-presets.h"
 #include <iostream>
+#include <atomic>
+#include <mutex>
 #include <chrono>
 #include <thread>
-#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <signal.h>
 
 // ============================================================================
@@ -15,16 +30,38 @@
 // Global flag for clean shutdown
 volatile bool g_running = true;
 
+// Set by SIGUSR1: print latency histograms from the main loop
+volatile bool g_dumpStats = false;
+
+// Set by SIGUSR2: recall the next preset from the control loop
+volatile bool g_nextPreset = false;
+
 void signalHandler(int signal) {
     std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
     g_running = false;
 }
 
+void statsSignalHandler(int) {
+    g_dumpStats = true;
+}
+
+void presetSignalHandler(int) {
+    g_nextPreset = true;
+}
+
 class DryerApp {
 public:
     DryerApp()
-        : running(false)
+        : output(hardware, latency)
+        , statsServer(latency)
+        , clockSync(hardware)
+        , adc(hardware)
+        , presetIndex(-1)
+        , running(false)
+        , physicsWorstLateNs(0)
         , baseNote(36)  // C2 - good bass range for percussion
+        , stepTimeNs(0)
+        , stepClock{}
     {
     }
     
@@ -33,21 +70,127 @@ public:
         std::cout << "   DRYER - Chaotic Percussion Gen   " << std::endl;
         std::cout << "=====================================" << std::endl;
         
-        // Initialize hardware
-        if (!hardware.initialize()) {
-            std::cerr << "Failed to initialize hardware" << std::endl;
-            return false;
+        // Scheduling / memory locking (DRYER_RT_* environment overrides)
+        realtime.loadFromEnvironment();
+        realtime.setupProcess();
+        
+        // Allocation check builds: abort on a steady-state allocation
+        const char* strictAlloc = std::getenv("DRYER_ALLOC_STRICT");
+        DryerAlloc::setStrict(strictAlloc && std::strcmp(strictAlloc, "1") == 0);
+        
+        // Polyrhythm mode (DRYER_DRUMS)
+        drums.loadFromEnvironment();
+        
+        // Ball presets for the ball type switch (DRYER_BALLS, DRYER_BALL)
+        balls.loadFromEnvironment();
+        
+        // Resting contact sleep (DRYER_CONTACT_SLEEP=0 turns it off)
+        const char* contactSleep = std::getenv("DRYER_CONTACT_SLEEP");
+        if (contactSleep && std::strcmp(contactSleep, "0") == 0) {
+            for (int i = 0; i < drums.size(); i++) {
+                drums.drum(i).setContactSleep(false);
+            }
         }
         
+        // Fixed-point physics (DRYER_FIXED_POINT=1, or =0 in a build where it
+        // is the default): identical hits on every machine
+        if (const char* fixedPoint = std::getenv("DRYER_FIXED_POINT")) {
+            bool enabled = std::strcmp(fixedPoint, "0") != 0;
+            for (int i = 0; i < drums.size(); i++) {
+                drums.drum(i).setFixedPoint(enabled);
+            }
+            std::cout << "Physics: " << (enabled ? "fixed point (Q16.16)" : "float") << std::endl;
+        }
+        
+        // Parameter changes morph over DRYER_MORPH_MS (0 = at once)
+        float morphMs = 100.0f;
+        if (const char* morph = std::getenv("DRYER_MORPH_MS")) {
+            morphMs = std::max(0.0f, static_cast<float>(std::atof(morph)));
+        }
+        for (int i = 0; i < drums.size(); i++) {
+            drums.drum(i).setMorphTime(morphMs / 1000.0f);
+        }
+        
+        // Stored drum settings (DRYER_PRESETS), recalled with kill -USR2
+        presets.loadFromEnvironment(drums);
+        
+        // Clock sync (DRYER_CLOCK): the clock, not the RPM knob, turns the drums
+        clockSync.loadFromEnvironment();
+        for (int i = 0; i < drums.size(); i++) {
+            drums.drum(i).setExternalRotation(clockSync.isEnabled());
+        }
+        
+        // Quantized output (DRYER_QUANTIZE): physics runs ahead of the outputs
+        quantizer.loadFromEnvironment();
+        
+        // CV inputs (DRYER_ADC): the ADS1115 sampled continuously
+        adc.loadFromEnvironment();
+        
+        // Hardware, output and physics come up on a helper thread while this
+        // one brings up the display: the two waits (I2C/UART probing, KMS
+        // modeset) overlap, and the drums are sounding before the first frame.
+        // The renderer stays on this thread, which goes on to draw with it.
+        bool hardwareReady = false;
+        std::thread hardwareThread([this, &hardwareReady] {
+            hardwareReady = initializeHardware();
+        });
+        
         // Initialize renderer
-        if (!renderer.initialize(true)) {  // true = fullscreen
+        bool displayReady = renderer.initialize(true, DryerRenderer::backendFromEnvironment());  // true = fullscreen
+        if (displayReady) {
+            latency.markBoot(BOOT_DISPLAY_READY);
+        } else {
             std::cerr << "Failed to initialize renderer" << std::endl;
+        }
+        hardwareThread.join();
+        
+        if (!hardwareReady || !displayReady) {
+            if (hardwareReady) {
+                stopSimulation();
+                statsServer.stop();
+                output.stop();
+                adc.stop();
+                hardware.shutdown();
+            }
+            if (displayReady) {
+                renderer.shutdown();
+            }
+            return false;
+        }
+        
+        std::cout << "Initialization complete!" << std::endl;
+        std::cout << "Press Ctrl+C to stop" << std::endl;
+        
+        return true;
+    }
+    
+    // Everything but the display: GPIO/I2C/UART, CV inputs, MIDI setup, the
+    // output thread, then the physics threads
+    bool initializeHardware() {
+        // Initialize hardware (one gate per drum with several drums)
+        if (!hardware.initialize(std::max(2, drums.size()))) {
+            std::cerr << "Failed to initialize hardware" << std::endl;
             return false;
         }
         
+        // Before the first parameter read, so it comes from the streams
+        adc.start(&realtime);
+        
+        // MIDI maps, CC streams, pitch bend, MPE (DRYER_MIDI_*)
+        midi.loadFromEnvironment();
+        midi.sendSetup(hardware);
+        
+        // Start output thread (MIDI, triggers, note-offs)
+        output.start(&realtime);
+        
+        // Latency stats on a local socket (optional)
+        if (!statsServer.start()) {
+            std::cerr << "WARNING: latency stats socket unavailable: " << STATS_SOCKET_PATH << std::endl;
+        }
+        
         // Set up collision callback
-        physics.onCollision([this](const Surface& surface, float velocity) {
-            this->onCollision(surface, velocity);
+        drums.onHit([this](int drum, const Surface& surface, float velocity, uint64_t detectNs) {
+            this->onCollision(drum, surface, velocity, detectNs);
         });
         
         // Initial parameter read
@@ -55,92 +198,364 @@ public:
         
         // Assign MIDI notes to surfaces
         assignMIDINotes();
+        latency.markBoot(BOOT_HARDWARE_READY);
         
-        std::cout << "Initialization complete!" << std::endl;
-        std::cout << "Press Ctrl+C to stop" << std::endl;
-        
+        startSimulation();
         return true;
     }
     
+    void startSimulation() {
+        running = true;
+        drums.start(&realtime);
+        clockSync.start(&realtime);
+        physicsThread = std::thread(&DryerApp::physicsLoop, this);
+        controlThread = std::thread(&DryerApp::controlLoop, this);
+        latency.markBoot(BOOT_PHYSICS_RUNNING);
+    }
+    
+    void stopSimulation() {
+        running = false;
+        if (physicsThread.joinable()) {
+            physicsThread.join();
+        }
+        if (controlThread.joinable()) {
+            controlThread.join();
+        }
+        clockSync.stop();
+        drums.stop();
+    }
+    
     void shutdown() {
         std::cout << "Shutting down..." << std::endl;
+        latency.dump(std::cout);
+        realtime.report(std::cout);
+        frameScheduler.report(std::cout);
+        DryerPhysics::reportContacts(std::cout, renderViews, drums.size());
+        if (clockSync.isEnabled()) {
+            clockSync.report(std::cout);
+        }
+        if (quantizer.isEnabled()) {
+            quantizer.report(std::cout);
+        }
+        if (adc.isEnabled()) {
+            adc.report(std::cout);
+        }
+        output.report(std::cout);
+        hardware.report(std::cout);
+        reportAllocations();
+        statsServer.stop();
+        output.stop();
+        adc.stop();
         renderer.shutdown();
         hardware.shutdown();
     }
     
     void run() {
-        running = true;
-        
-        auto lastTime = std::chrono::high_resolution_clock::now();
-        auto lastParamUpdate = lastTime;
+        // This (main) thread renders: SDL/KMS must stay on the thread that
+        // created the window. Physics and parameter reads have their own,
+        // already running since initialize().
+        realtime.enterThread(THREAD_RENDER);
         
-        const float targetDt = 1.0f / 60.0f;  // 60 FPS target
-        const int substeps = 4;               // Physics substeps for stability
-        const float substepDt = targetDt / substeps;
-        
-        // Parameter update rate (don't read ADC every frame)
-        const auto paramUpdateInterval = std::chrono::milliseconds(50);  // 20Hz
+        int frameCount = 0;
+        bool firstFrame = true;
+        bool warmedUp = false;
         
         while (running && g_running) {
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            auto elapsed = std::chrono::duration<float>(currentTime - lastTime).count();
-            lastTime = currentTime;
+            // Adaptive frame rate: ticks at DISPLAY_FPS, draws only when useful
+            frameScheduler.waitForTick();
             
-            // Limit delta time to prevent large jumps
-            float clampedDt = std::min(elapsed, 0.033f);  // Max 33ms
-            
-            // Update parameters periodically
-            if (currentTime - lastParamUpdate >= paramUpdateInterval) {
-                updateParameters();
-                lastParamUpdate = currentTime;
+            // Take a consistent copy of the simulation for this frame
+            // (every drum at the same tick)
+            const int drumCount = drums.size();
+            {
+                std::lock_guard<PiMutex> lock(stateMutex);
+                for (int i = 0; i < drumCount; i++) {
+                    renderViews[i] = drums.drum(i);
+                }
             }
             
-            // Update physics (with substeps)
-            for (int i = 0; i < substeps; i++) {
-                physics.step(substepDt);
+            // Stats dump requested (kill -USR1)
+            if (g_dumpStats) {
+                g_dumpStats = false;
+                
+                // On-demand diagnostics are allowed to allocate
+                DryerAlloc::disarmThread();
+                latency.dump(std::cout);
+                realtime.report(std::cout);
+                frameScheduler.report(std::cout);
+                DryerPhysics::reportContacts(std::cout, renderViews, drumCount);
+                if (clockSync.isEnabled()) {
+                    clockSync.report(std::cout);
+                }
+                if (quantizer.isEnabled()) {
+                    quantizer.report(std::cout);
+                }
+                if (adc.isEnabled()) {
+                    adc.report(std::cout);
+                }
+                output.report(std::cout);
+                hardware.report(std::cout);
+                reportAllocations();
+                std::cout.flush();
+                if (warmedUp) {
+                    DryerAlloc::armThread();
+                }
             }
             
-            // Update trigger outputs
-            hardware.updateTriggers();
+            // Render, unless nothing moved or physics/output are running late
+            FrameDecision decision = frameScheduler.decide(renderer.estimateChange(renderViews, drumCount),
+                                                           physicsWorstLateNs.exchange(0),
+                                                           output.takeDispatchLag());
+            if (decision == FRAME_RENDER) {
+                renderer.render(renderViews, drumCount);
+                frameScheduler.frameRendered();
+                
+                if (firstFrame) {
+                    firstFrame = false;
+                    latency.markBoot(BOOT_FIRST_FRAME);
+                    printBootTimes();
+                }
+            }
             
-            // Render
-            renderer.render(physics);
+            if (++frameCount >= DISPLAY_FPS) {
+                frameCount = 0;
+                realtime.sampleThread(THREAD_RENDER);
+                
+                // Warmed up: from here on the loop must not allocate
+                warmedUp = true;
+                DryerAlloc::armThread();
+            }
             
             // Handle events (for clean shutdown)
-            SDL_Event event;
-            while (SDL_PollEvent(&event)) {
-                if (event.type == SDL_QUIT) {
-                    running = false;
-                }
+            if (!renderer.processEvents()) {
+                running = false;
             }
             
-            // Sleep to maintain frame rate (VSync should handle this, but just in case)
-            // std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            // Scripted sim run over (DRYER_SIM_SECONDS)
+            if (hardware.finished()) {
+                running = false;
+            }
         }
+        
+        DryerAlloc::disarmThread();
+        stopSimulation();
     }
     
 private:
-    DryerPhysics physics;
+    DrumGroup drums;
     DryerHardware hardware;
     DryerRenderer renderer;
+    LatencyStats latency;
+    DryerOutput output;
+    LatencyStatsServer statsServer;
+    DryerRealtime realtime;
+    ClockSync clockSync;
+    AdcScheduler adc;
+    Quantizer quantizer;
+    MidiMapper midi;
+    BallLibrary balls;
+    ParameterPresets presets;
+    int presetIndex;        // last recalled, -1 = none
+    
+    // Physics is stepped on its own thread (plus one per extra drum); the
+    // render thread works from copies taken under stateMutex once per frame
+    std::thread physicsThread;
+    std::thread controlThread;
+    PiMutex stateMutex;
+    DryerPhysics renderViews[MAX_DRUMS];
+    FrameScheduler frameScheduler;
     
-    bool running;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> physicsWorstLateNs;   // since the render thread last looked
     int baseNote;
-    std::map<std::string, int> surfaceToNote;
+    int surfaceToNote[MAX_DRUMS][DryerPhysics::MAX_SURFACES];  // by drum, Surface::slot
+    
+    // The step being simulated (physics thread): the time it stands for,
+    // lookahead included, and the clock as it was then
+    uint64_t stepTimeNs;
+    ClockState stepClock;
+    
+    void physicsLoop() {
+        realtime.enterThread(THREAD_PHYSICS);
+        
+        // Fixed-rate stepping on an absolute schedule, independent of the
+        // display (previously 4 substeps per rendered frame). A sped-up sim
+        // takes the same steps closer together.
+        const float stepDt = 1.0f / PHYSICS_RATE_HZ;
+        const auto period = std::chrono::nanoseconds(
+            static_cast<int64_t>(1e9 / (PHYSICS_RATE_HZ * hardware.timeScale())));
+        const int maxCatchUpSteps = 8;
+        
+        // With quantize on, each step stands for a moment lookaheadNs in the
+        // future, so its hits are known before they are due
+        const uint64_t lookaheadNs = quantizer.getLookaheadNs();
+        
+        auto nextStep = std::chrono::steady_clock::now();
+        int sampleCounter = 0;
+        
+        while (running && g_running) {
+            stepTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                nextStep.time_since_epoch()).count() + lookaheadNs;
+            
+            // Steer the drums towards the external clock's beat phase
+            bool clocked = clockSync.isEnabled();
+            stepClock = clocked ? clockSync.snapshot() : ClockState{};
+            
+            // CV inputs at this step's time, interpolated between samples
+            float rpmCV = 0.0f;
+            float heightCV = 0.0f;
+            uint64_t nowNs = stepTimeNs - lookaheadNs;
+            bool modulated = adc.valueAt(ADC_CHAN_RPM, nowNs, rpmCV) &&
+                             adc.valueAt(ADC_CHAN_VANE_HEIGHT, nowNs, heightCV);
+            
+            {
+                std::lock_guard<PiMutex> lock(stateMutex);
+                
+                // Not while a recalled preset holds: turning the input releases
+                // it (control thread), and CV takes over again from there
+                if (modulated && !presets.isHolding()) {
+                    float rpm = mapADCToRange(static_cast<uint16_t>(rpmCV), ParamRanges::RPM_MIN, ParamRanges::RPM_MAX);
+                    float height = mapADCToRange(static_cast<uint16_t>(heightCV), ParamRanges::VANE_HEIGHT_MIN,
+                                                 ParamRanges::VANE_HEIGHT_MAX);
+                    for (int i = 0; i < drums.size(); i++) {
+                        drums.drum(i).modulate(rpm * drums.getConfig(i).rpmRatio, height);
+                    }
+                }
+                if (clocked) {
+                    for (int i = 0; i < drums.size(); i++) {
+                        DryerPhysics& drum = drums.drum(i);
+                        drum.setAngularVelocity(clockSync.drumVelocity(stepClock, drum, drums.getConfig(i).rpmRatio,
+                                                                       stepDt, stepTimeNs));
+                    }
+                }
+                drums.step(stepDt);
+            }
+            
+            // Ball state as CC streams; only what changed enough goes out
+            if (midi.hasControlStreams()) {
+                streamControls();
+            }
+            
+            if (++sampleCounter >= PHYSICS_RATE_HZ) {
+                sampleCounter = 0;
+                realtime.sampleThread(THREAD_PHYSICS);
+                
+                // Warmed up: from here on the loop must not allocate
+                DryerAlloc::armThread();
+            }
+            
+            // Resync rather than burst if we fell far behind (e.g. debugger)
+            nextStep += period;
+            auto now = std::chrono::steady_clock::now();
+            if (now - nextStep > period * maxCatchUpSteps) {
+                nextStep = now;
+            }
+            std::this_thread::sleep_until(nextStep);
+            
+            // Wake-up lateness, read (and reset) by the frame scheduler
+            int64_t lateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - nextStep).count();
+            if (lateNs > 0 && static_cast<uint64_t>(lateNs) > physicsWorstLateNs.load(std::memory_order_relaxed)) {
+                physicsWorstLateNs.store(lateNs, std::memory_order_relaxed);
+            }
+        }
+        
+        DryerAlloc::disarmThread();
+    }
+    
+    void streamControls() {
+        MidiControl controls[MIDI_STREAM_COUNT];
+        for (int drum = 0; drum < drums.size(); drum++) {
+            int count = midi.controlChanges(drum, drums.drum(drum), stepTimeNs, controls);
+            for (int i = 0; i < count; i++) {
+                OutputEvent event = {};
+                event.type = OUTPUT_CONTROL;
+                event.note = controls[i].controller;
+                event.velocity = controls[i].value;
+                event.channel = controls[i].channel;
+                event.triggerPin = -1;
+                event.dueNs = quantizer.isEnabled() ? stepTimeNs : 0;    // in step with the notes
+                event.detectNs = latencyNowNs();
+                output.post(event);
+            }
+        }
+    }
+    
+    // One line at the first frame: how long the box took to come up
+    void printBootTimes() {
+        auto ms = [this](BootMilestone milestone) { return latency.bootTimeNs(milestone) / 1000000; };
+        std::cout << "Boot: hardware " << ms(BOOT_HARDWARE_READY) << " ms, display " << ms(BOOT_DISPLAY_READY)
+                  << " ms, first frame " << ms(BOOT_FIRST_FRAME) << " ms";
+        if (latency.bootTimeNs(BOOT_FIRST_HIT) != 0) {
+            std::cout << ", first hit " << ms(BOOT_FIRST_HIT) << " ms";
+        }
+        std::cout << " (after process start)" << std::endl;
+    }
+    
+    void reportAllocations() {
+        if (!DryerAlloc::trackingEnabled()) return;
+        std::cout << "Allocations: " << DryerAlloc::allocationCount() << " total, "
+                  << DryerAlloc::violationCount() << " on realtime threads in steady state" << std::endl;
+    }
+    
+    void controlLoop() {
+        realtime.enterThread(THREAD_CONTROL);
+        
+        // Parameter update rate (don't read ADC every frame)
+        const auto paramUpdateInterval = std::chrono::microseconds(
+            static_cast<int64_t>(50000 / hardware.timeScale()));  // 20Hz (simulated)
+        int sampleCounter = 0;
+        
+        while (running && g_running) {
+            auto nextUpdate = std::chrono::steady_clock::now() + paramUpdateInterval;
+            
+            updateParameters();
+            
+            if (++sampleCounter >= 20) {
+                sampleCounter = 0;
+                realtime.sampleThread(THREAD_CONTROL);
+            }
+            
+            std::this_thread::sleep_until(nextUpdate);
+        }
+    }
     
     void updateParameters() {
-        auto params = hardware.readParameters();
+        // ADC conversions block for tens of ms, so read without the lock
+        // (with DRYER_ADC the scheduler's latest values are used instead)
+        uint16_t adcValues[4];
+        auto params = hardware.readParameters(adc.latestValues(adcValues));
+        
+        std::lock_guard<PiMutex> lock(stateMutex);
+        
+        // Preset recall requested (kill -USR2): the next one in the list
+        if (g_nextPreset) {
+            g_nextPreset = false;
+            if (presets.size() > 0) {
+                presetIndex = (presetIndex + 1) % presets.size();
+                presets.recall(presetIndex, drums, params);
+            }
+        }
         
-        // Update physics parameters
-        physics.setParameters(params.rpm, params.drumSize, params.vanes, params.vaneHeight);
+        // Update physics parameters, unless a recalled preset still holds;
+        // extra drums scale the RPM knob and may fix their vane count.
+        // Each drum swaps them in at its next step.
+        if (!presets.holding(params)) {
+            for (int i = 0; i < drums.size(); i++) {
+                const DrumConfig& config = drums.getConfig(i);
+                drums.drum(i).setParameters(params.rpm * config.rpmRatio, params.drumSize,
+                                            config.vanes > 0 ? config.vanes : params.vanes,
+                                            params.vaneHeight);
+            }
+        }
         
-        // Update ball type
-        static bool lastBallType = false;
-        if (params.ballTypeBalloon != lastBallType) {
-            if (params.ballTypeBalloon) {
-                physics.setBalloonBall();
-            } else {
-                physics.setTennisBall();
+        // Update ball type (first read included: the presets may not be
+        // tennis/balloon); under the lock, so it lands between steps
+        static int lastBallType = -1;
+        if (static_cast<int>(params.ballTypeBalloon) != lastBallType) {
+            const BallPreset& preset = balls.forSwitch(params.ballTypeBalloon);
+            for (int i = 0; i < drums.size(); i++) {
+                drums.drum(i).setBall(preset);
             }
             lastBallType = params.ballTypeBalloon;
         }
@@ -148,59 +563,75 @@ private:
         // Update features
         static bool lastLintTrap = false;
         if (params.lintTrapEnabled != lastLintTrap) {
-            physics.setLintTrap(params.lintTrapEnabled);
+            for (int i = 0; i < drums.size(); i++) {
+                drums.drum(i).setLintTrap(params.lintTrapEnabled);
+            }
             lastLintTrap = params.lintTrapEnabled;
         }
         
         static bool lastMoonGravity = false;
         if (params.moonGravityEnabled != lastMoonGravity) {
-            physics.setMoonGravity(params.moonGravityEnabled);
+            for (int i = 0; i < drums.size(); i++) {
+                drums.drum(i).setMoonGravity(params.moonGravityEnabled);
+            }
             lastMoonGravity = params.moonGravityEnabled;
         }
-        
-        // Reassign MIDI notes if surface count changed
-        assignMIDINotes();
     }
     
     void assignMIDINotes() {
-        surfaceToNote.clear();
-        
-        const auto& surfaces = physics.getSurfaces();
-        for (size_t i = 0; i < surfaces.size(); i++) {
-            int noteNumber = baseNote + static_cast<int>(i);
-            surfaceToNote[surfaces[i].id] = noteNumber;
+        // Same notes on every drum; the drums differ by MIDI channel. Every
+        // slot gets its note up front: a new vane count only changes the
+        // surfaces at the drum's next step.
+        for (int drum = 0; drum < drums.size(); drum++) {
+            for (int slot = 0; slot < DryerPhysics::MAX_SURFACES; slot++) {
+                surfaceToNote[drum][slot] = baseNote + slot;
+            }
         }
     }
     
-    void onCollision(const Surface& surface, float velocity) {
-        // Get MIDI note for this surface
-        auto it = surfaceToNote.find(surface.id);
-        if (it == surfaceToNote.end()) return;
+    void onCollision(int drum, const Surface& surface, float velocity, uint64_t detectNs) {
+        // Runs on the physics thread right after the step that found the
+        // hit; detectNs was taken inside that step
+        latency.markBoot(BOOT_FIRST_HIT);
         
-        int noteNumber = it->second;
-        
-        // Scale velocity to MIDI range (0-127)
-        int velocityMIDI = std::min(127, static_cast<int>(velocity * 300));
+        // Note, velocity, channel and bend for this surface (DRYER_MIDI_*)
+        MidiNote note;
+        if (!midi.mapHit(drum, surface, velocity, surfaceToNote[drum][surface.slot],
+                         drums.drum(drum), note)) {
+            return;
+        }
         
-        // Send MIDI note
-        hardware.sendMIDINoteOn(noteNumber, velocityMIDI);
+        // Queue MIDI note + trigger for the output thread
+        // (note-off is scheduled there after MIDI_NOTE_LENGTH_MS)
+        OutputEvent event;
+        event.type = OUTPUT_NOTE;
+        event.note = note.note;
+        event.velocity = note.velocity;
+        event.channel = note.channel;
+        event.hasPitchBend = note.hasPitchBend;
+        event.pitchBend = note.pitchBend;
+        event.triggerPin = -1;
+        event.dueNs = 0;
+        event.detectNs = detectNs;
         
-        // Schedule note off after 100ms
-        // (In a real implementation, you'd use a timer thread)
-        std::thread([this, noteNumber]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            hardware.sendMIDINoteOff(noteNumber);
-        }).detach();
+        // Quantize mode: play it on the grid, at the earliest right now
+        if (quantizer.isEnabled()) {
+            event.dueNs = quantizer.quantize(stepTimeNs, latencyNowNs(), stepClock);
+        }
         
-        // Trigger CV output
-        if (surface.type == "drum") {
-            hardware.triggerPulse(GPIO_TRIGGER_OUT_1);
-        } else if (surface.type == "vane_leading" || surface.type == "vane_trailing") {
-            hardware.triggerPulse(GPIO_TRIGGER_OUT_2);
+        // Trigger CV output: drum / vane with one drum, else one gate per drum
+        if (drums.size() > 1) {
+            event.triggerPin = DryerHardware::triggerPin(drum);
+        } else if (surface.type == SURFACE_DRUM) {
+            event.triggerPin = GPIO_TRIGGER_OUT_1;
+        } else if (surface.type == SURFACE_VANE_LEADING || surface.type == SURFACE_VANE_TRAILING) {
+            event.triggerPin = GPIO_TRIGGER_OUT_2;
         }
         
-        // Update visual feedback
-        renderer.highlightCollision(surface.id);
+        output.post(event);
+        
+        // Update visual feedback (lock-free hand-off to the render thread)
+        renderer.highlightCollision(surface.slot, drum);
         
         // Debug output
         // std::cout << "Collision: " << surface.id << " vel=" << velocity 
@@ -212,6 +643,11 @@ int main(int argc, char* argv[]) {
     // Set up signal handler for clean shutdown
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGUSR1, statsSignalHandler);
+    signal(SIGUSR2, presetSignalHandler);
+    
+    // A stats client hanging up mid-dump must not kill the module
+    signal(SIGPIPE, SIG_IGN);
     
     DryerApp app;
     
@@ -224,5 +660,11 @@ int main(int argc, char* argv[]) {
     app.shutdown();
     
     std::cout << "Goodbye!" << std::endl;
+    
+    // Allocation check builds: a steady-state allocation fails the run
+    // (make check-alloc, ctest)
+    if (DryerAlloc::violationCount() > 0) {
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,391 @@
+#include "dryer-midi-port.h"
+#include "dryer-latency.h"
+#include "pins.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifdef DRYER_HAVE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+int MidiPort::receive(uint8_t*, int, int) {
+    return -1;
+}
+
+// ============================================================================
+// UartMidiPort
+// ============================================================================
+
+UartMidiPort::UartMidiPort(const char* device)
+    : device(device)
+    , fd(-1)
+{
+}
+
+UartMidiPort::~UartMidiPort() {
+    close();
+}
+
+bool UartMidiPort::open() {
+    // Read/write: RX carries MIDI clock for clock sync
+    fd = ::open(device, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Configure UART for MIDI (31.25 kbaud, 8N1)
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        close();
+        return false;
+    }
+
+    // Set baud rate to 38400 (closest to 31250)
+    cfsetospeed(&tty, B38400);
+    cfsetispeed(&tty, B38400);
+
+    // 8N1 mode
+    tty.c_cflag &= ~PARENB;
+    tty.c_cflag &= ~CSTOPB;
+    tty.c_cflag &= ~CSIZE;
+    tty.c_cflag |= CS8;
+    tty.c_cflag &= ~CRTSCTS;
+    tty.c_cflag |= CLOCAL | CREAD;
+
+    // Raw mode
+    tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tty.c_oflag &= ~OPOST;
+    tty.c_iflag &= ~(ICRNL | INLCR | IGNCR | ISTRIP);
+
+    // Reads return whatever has arrived; receive() polls first
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UartMidiPort::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool UartMidiPort::send(const uint8_t* bytes, int count) {
+    // One write() per message, not per byte
+    return fd >= 0 && write(fd, bytes, count) == count;
+}
+
+int UartMidiPort::receive(uint8_t* buffer, int size, int timeoutMs) {
+    if (fd < 0) return -1;
+
+    pollfd pfd = {fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) return ready < 0 && errno != EINTR ? -1 : 0;
+
+    ssize_t count = read(fd, buffer, size);
+    return count < 0 ? 0 : static_cast<int>(count);
+}
+
+double UartMidiPort::bytesPerSecond() const {
+    return MIDI_BAUD_RATE / 10.0;   // 8N1: 10 bits a byte
+}
+
+#ifdef DRYER_HAVE_ALSA
+
+// ============================================================================
+// RawMidiPort
+// ============================================================================
+
+RawMidiPort::RawMidiPort(const char* device)
+    : input(nullptr)
+    , output(nullptr)
+{
+    std::strncpy(this->device, device, sizeof(this->device) - 1);
+    this->device[sizeof(this->device) - 1] = '\0';
+}
+
+RawMidiPort::~RawMidiPort() {
+    close();
+}
+
+bool RawMidiPort::open() {
+    snd_rawmidi_t* in = nullptr;
+    snd_rawmidi_t* out = nullptr;
+
+    // Both directions if the device has an input, else output only
+    int err = snd_rawmidi_open(&in, &out, device, SND_RAWMIDI_NONBLOCK);
+    if (err < 0) {
+        in = nullptr;
+        err = snd_rawmidi_open(nullptr, &out, device, SND_RAWMIDI_NONBLOCK);
+    }
+    if (err < 0) {
+        std::cerr << "rawmidi: can't open " << device << ": " << snd_strerror(err) << std::endl;
+        return false;
+    }
+
+    input = in;
+    output = out;
+    return true;
+}
+
+void RawMidiPort::close() {
+    if (input) {
+        snd_rawmidi_close(static_cast<snd_rawmidi_t*>(input));
+        input = nullptr;
+    }
+    if (output) {
+        snd_rawmidi_close(static_cast<snd_rawmidi_t*>(output));
+        output = nullptr;
+    }
+}
+
+bool RawMidiPort::send(const uint8_t* bytes, int count) {
+    if (!output) return false;
+    return snd_rawmidi_write(static_cast<snd_rawmidi_t*>(output), bytes, count) == count;
+}
+
+int RawMidiPort::receive(uint8_t* buffer, int size, int timeoutMs) {
+    if (!input) return -1;
+    snd_rawmidi_t* in = static_cast<snd_rawmidi_t*>(input);
+
+    pollfd pfds[4];
+    int count = std::min(snd_rawmidi_poll_descriptors_count(in), 4);
+    count = snd_rawmidi_poll_descriptors(in, pfds, count);
+    int ready = poll(pfds, count, timeoutMs);
+    if (ready <= 0) return ready < 0 && errno != EINTR ? -1 : 0;
+
+    ssize_t bytes = snd_rawmidi_read(in, buffer, size);
+    if (bytes == -EAGAIN) return 0;
+    return bytes < 0 ? -1 : static_cast<int>(bytes);
+}
+
+// ============================================================================
+// SeqMidiPort
+// ============================================================================
+
+SeqMidiPort::SeqMidiPort(const char* connectTo)
+    : seq(nullptr)
+    , encoder(nullptr)
+    , decoder(nullptr)
+    , port(-1)
+{
+    std::strncpy(this->connectTo, connectTo, sizeof(this->connectTo) - 1);
+    this->connectTo[sizeof(this->connectTo) - 1] = '\0';
+}
+
+SeqMidiPort::~SeqMidiPort() {
+    close();
+}
+
+bool SeqMidiPort::open() {
+    snd_seq_t* handle = nullptr;
+    int err = snd_seq_open(&handle, "default", SND_SEQ_OPEN_DUPLEX, SND_SEQ_NONBLOCK);
+    if (err < 0) {
+        std::cerr << "seq: can't open the ALSA sequencer: " << snd_strerror(err) << std::endl;
+        return false;
+    }
+    seq = handle;
+
+    snd_seq_set_client_name(handle, "Dryer");
+    port = snd_seq_create_simple_port(handle, "Dryer MIDI",
+                                      SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ |
+                                      SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE,
+                                      SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+    if (port < 0) {
+        std::cerr << "seq: can't create a port: " << snd_strerror(port) << std::endl;
+        close();
+        return false;
+    }
+
+    snd_midi_event_t* encode = nullptr;
+    snd_midi_event_t* decode = nullptr;
+    if (snd_midi_event_new(16, &encode) < 0 || snd_midi_event_new(16, &decode) < 0) {
+        if (encode) snd_midi_event_free(encode);
+        close();
+        return false;
+    }
+    snd_midi_event_no_status(decode, 1);    // a status byte on every decoded message
+    encoder = encode;
+    decoder = decode;
+
+    // Otherwise the DAW / aconnect subscribes to us
+    if (connectTo[0]) {
+        snd_seq_addr_t address;
+        if (snd_seq_parse_address(handle, &address, connectTo) < 0 ||
+            snd_seq_connect_to(handle, port, address.client, address.port) < 0) {
+            std::cerr << "seq: can't connect to " << connectTo << std::endl;
+        } else {
+            snd_seq_connect_from(handle, port, address.client, address.port);
+        }
+    }
+    return true;
+}
+
+void SeqMidiPort::close() {
+    if (encoder) {
+        snd_midi_event_free(static_cast<snd_midi_event_t*>(encoder));
+        encoder = nullptr;
+    }
+    if (decoder) {
+        snd_midi_event_free(static_cast<snd_midi_event_t*>(decoder));
+        decoder = nullptr;
+    }
+    if (seq) {
+        snd_seq_close(static_cast<snd_seq_t*>(seq));
+        seq = nullptr;
+    }
+    port = -1;
+}
+
+bool SeqMidiPort::send(const uint8_t* bytes, int count) {
+    if (!seq) return false;
+
+    snd_seq_event_t event;
+    snd_seq_ev_clear(&event);
+    snd_midi_event_t* encode = static_cast<snd_midi_event_t*>(encoder);
+    snd_midi_event_reset_encode(encode);
+    if (snd_midi_event_encode(encode, bytes, count, &event) <= 0 ||
+        event.type == SND_SEQ_EVENT_NONE) {
+        return false;
+    }
+
+    // Straight to the subscribers, no sequencer queue
+    snd_seq_ev_set_source(&event, port);
+    snd_seq_ev_set_subs(&event);
+    snd_seq_ev_set_direct(&event);
+    return snd_seq_event_output_direct(static_cast<snd_seq_t*>(seq), &event) >= 0;
+}
+
+int SeqMidiPort::receive(uint8_t* buffer, int size, int timeoutMs) {
+    if (!seq) return -1;
+    snd_seq_t* handle = static_cast<snd_seq_t*>(seq);
+
+    pollfd pfds[4];
+    int count = std::min(snd_seq_poll_descriptors_count(handle, POLLIN), 4);
+    count = snd_seq_poll_descriptors(handle, pfds, count, POLLIN);
+    int ready = poll(pfds, count, timeoutMs);
+    if (ready <= 0) return ready < 0 && errno != EINTR ? -1 : 0;
+
+    // Back to bytes, so clock sync parses them like UART input
+    int total = 0;
+    snd_seq_event_t* event = nullptr;
+    while (total + 3 <= size && snd_seq_event_input(handle, &event) >= 0 && event) {
+        long bytes = snd_midi_event_decode(static_cast<snd_midi_event_t*>(decoder),
+                                           buffer + total, size - total, event);
+        if (bytes > 0) {
+            total += static_cast<int>(bytes);
+        }
+    }
+    return total;
+}
+
+#else // !DRYER_HAVE_ALSA
+
+RawMidiPort::RawMidiPort(const char*) : input(nullptr), output(nullptr) { device[0] = '\0'; }
+RawMidiPort::~RawMidiPort() {}
+bool RawMidiPort::open() {
+    std::cerr << "rawmidi: built without ALSA" << std::endl;
+    return false;
+}
+void RawMidiPort::close() {}
+bool RawMidiPort::send(const uint8_t*, int) { return false; }
+int RawMidiPort::receive(uint8_t*, int, int) { return -1; }
+
+SeqMidiPort::SeqMidiPort(const char*) : seq(nullptr), encoder(nullptr), decoder(nullptr), port(-1) {
+    connectTo[0] = '\0';
+}
+SeqMidiPort::~SeqMidiPort() {}
+bool SeqMidiPort::open() {
+    std::cerr << "seq: built without ALSA" << std::endl;
+    return false;
+}
+void SeqMidiPort::close() {}
+bool SeqMidiPort::send(const uint8_t*, int) { return false; }
+int SeqMidiPort::receive(uint8_t*, int, int) { return -1; }
+
+#endif // DRYER_HAVE_ALSA
+
+// ============================================================================
+// FakeMidiPort
+// ============================================================================
+
+FakeMidiPort::FakeMidiPort(size_t capacity)
+    : ring(std::max<size_t>(capacity, 1))
+    , sent(0)
+{
+}
+
+bool FakeMidiPort::send(const uint8_t* bytes, int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Message& message = ring[sent % ring.size()];
+    message.timeNs = latencyNowNs();
+    message.count = std::min(count, 3);
+    std::memcpy(message.bytes, bytes, message.count);
+    sent++;
+    return true;
+}
+
+int FakeMidiPort::receive(uint8_t* buffer, int size, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex);
+    inputCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this]() { return !pendingInput.empty(); });
+
+    int count = std::min(size, static_cast<int>(pendingInput.size()));
+    std::copy(pendingInput.begin(), pendingInput.begin() + count, buffer);
+    pendingInput.erase(pendingInput.begin(), pendingInput.begin() + count);
+    return count;
+}
+
+void FakeMidiPort::inject(const uint8_t* bytes, int count) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingInput.insert(pendingInput.end(), bytes, bytes + count);
+    }
+    inputCondition.notify_one();
+}
+
+std::vector<FakeMidiPort::Message> FakeMidiPort::messages() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Message> ordered;
+    uint64_t kept = std::min<uint64_t>(sent, ring.size());
+    for (uint64_t i = sent - kept; i < sent; i++) {
+        ordered.push_back(ring[i % ring.size()]);
+    }
+    return ordered;
+}
+
+uint64_t FakeMidiPort::messageCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sent;
+}
+
+MidiPort* createMidiPort(const char* spec) {
+    // kind[:argument]
+    const char* colon = std::strchr(spec, ':');
+    size_t kindLength = colon ? static_cast<size_t>(colon - spec) : std::strlen(spec);
+    const char* argument = colon ? colon + 1 : "";
+
+    auto is = [spec, kindLength](const char* kind) {
+        return std::strlen(kind) == kindLength && std::strncmp(spec, kind, kindLength) == 0;
+    };
+
+    if (is("uart")) return new UartMidiPort(UART_DEVICE);
+    if (is("rawmidi")) return new RawMidiPort(argument[0] ? argument : "virtual");
+    if (is("seq")) return new SeqMidiPort(argument);
+    if (is("fake")) return new FakeMidiPort(argument[0] ? std::strtoul(argument, nullptr, 10) : 1024);
+    return nullptr;
+}
@@ -0,0 +1,136 @@
+#ifndef DRYER_MIDI_PORT_H
+#define DRYER_MIDI_PORT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// DRYER MIDI PORT - Where MIDI bytes go (and clock bytes come from)
+//   uart               /dev/serial0 at 31.25 kbaud (default)
+//   rawmidi[:device]   ALSA rawmidi, e.g. rawmidi:hw:1,0,0 for a USB
+//                      interface or the USB gadget, "virtual" by default
+//   seq[:client:port]  ALSA sequencer client "Dryer", optionally connected
+//                      to a DAW or synth port (e.g. seq:128:0)
+//   fake[:capacity]    in-process, keeps the last messages (no hardware)
+// rawmidi and seq need ALSA at build time (DRYER_HAVE_ALSA).
+//
+// DRYER_MIDI_OUT lists one or more, e.g. "uart,seq": every port gets the
+// same messages from the output thread, in the same order.
+// ============================================================================
+
+class MidiPort {
+public:
+    virtual ~MidiPort() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    // One complete message; doesn't wait for the wire
+    virtual bool send(const uint8_t* bytes, int count) = 0;
+
+    // Incoming bytes: waits up to timeoutMs, returns the bytes read,
+    // 0 on timeout, -1 if this port has no input
+    virtual int receive(uint8_t* buffer, int size, int timeoutMs);
+
+    // Wire speed for the output budget; 0 = fast enough not to matter
+    virtual double bytesPerSecond() const { return 0.0; }
+
+    virtual const char* name() const = 0;
+};
+
+// Hardware UART (the original MIDI path)
+class UartMidiPort : public MidiPort {
+public:
+    explicit UartMidiPort(const char* device);
+    ~UartMidiPort() override;
+
+    bool open() override;
+    void close() override;
+    bool send(const uint8_t* bytes, int count) override;
+    int receive(uint8_t* buffer, int size, int timeoutMs) override;
+    double bytesPerSecond() const override;
+    const char* name() const override { return "uart"; }
+
+private:
+    const char* device;
+    int fd;
+};
+
+// ALSA rawmidi: byte stream to a card, USB-MIDI at USB speed
+class RawMidiPort : public MidiPort {
+public:
+    explicit RawMidiPort(const char* device);
+    ~RawMidiPort() override;
+
+    bool open() override;
+    void close() override;
+    bool send(const uint8_t* bytes, int count) override;
+    int receive(uint8_t* buffer, int size, int timeoutMs) override;
+    const char* name() const override { return "rawmidi"; }
+
+private:
+    char device[64];
+    void* input;            // snd_rawmidi_t (kept opaque here)
+    void* output;
+};
+
+// ALSA sequencer: a client other programs can subscribe to
+class SeqMidiPort : public MidiPort {
+public:
+    explicit SeqMidiPort(const char* connectTo);
+    ~SeqMidiPort() override;
+
+    bool open() override;
+    void close() override;
+    bool send(const uint8_t* bytes, int count) override;
+    int receive(uint8_t* buffer, int size, int timeoutMs) override;
+    const char* name() const override { return "seq"; }
+
+private:
+    char connectTo[64];     // "client:port", empty = wait for subscribers
+    void* seq;              // snd_seq_t
+    void* encoder;          // snd_midi_event_t, bytes -> events
+    void* decoder;          // events -> bytes
+    int port;
+};
+
+// In-process stand-in for checking what would have been sent
+class FakeMidiPort : public MidiPort {
+public:
+    struct Message {
+        uint64_t timeNs;    // latencyNowNs() at send()
+        uint8_t bytes[3];
+        int count;
+    };
+
+    explicit FakeMidiPort(size_t capacity = 1024);
+
+    bool open() override { return true; }
+    void close() override {}
+    bool send(const uint8_t* bytes, int count) override;
+    int receive(uint8_t* buffer, int size, int timeoutMs) override;
+    const char* name() const override { return "fake"; }
+
+    // Bytes for receive(), e.g. a MIDI clock to lock to
+    void inject(const uint8_t* bytes, int count);
+
+    // Oldest first; the ring keeps the last capacity messages
+    std::vector<Message> messages() const;
+    uint64_t messageCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable inputCondition;
+    std::vector<Message> ring;
+    uint64_t sent;
+    std::vector<uint8_t> pendingInput;
+};
+
+// "uart", "rawmidi[:device]", "seq[:client:port]" or "fake[:capacity]";
+// nullptr if unknown
+MidiPort* createMidiPort(const char* spec);
+
+#endif // DRYER_MIDI_PORT_H
@@ -0,0 +1,220 @@
+#include "dryer-midi.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static const float VELOCITY_SCALE = 300.0f;             // hit speed (m/s) -> MIDI velocity
+static const float SPEED_FULL_SCALE = 3.0f;             // m/s at CC value 127
+static const uint64_t CONTROL_MIN_INTERVAL_NS = 10000000ULL;   // 100 Hz per stream
+static const int DEFAULT_THRESHOLD = 2;
+static const int DEFAULT_CONTROLLERS[MIDI_STREAM_COUNT] = {20, 21, 22};
+static const char* STREAM_NAMES[MIDI_STREAM_COUNT] = {"radius", "angle", "speed"};
+static const char* KIND_NAMES[3] = {"drum", "lead", "trail"};
+
+MidiMapper::MidiMapper()
+    : threshold(DEFAULT_THRESHOLD)
+    , bendDepth(0.0f)
+    , mpeChannels(0)
+    , nextMpeChannel(0)
+{
+    for (KindMap& kind : kinds) {
+        kind = KindMap{-1, 0};
+    }
+    for (int i = 0; i < MIDI_STREAM_COUNT; i++) {
+        streamController[i] = -1;
+    }
+    for (int drum = 0; drum < MAX_DRUMS; drum++) {
+        for (int i = 0; i < MIDI_STREAM_COUNT; i++) {
+            lastValue[drum][i] = -1;
+            lastSentNs[drum][i] = 0;
+        }
+    }
+}
+
+void MidiMapper::loadFromEnvironment() {
+    if (const char* value = std::getenv("DRYER_MIDI_MAP")) {
+        parseMap(value);
+    }
+    if (const char* value = std::getenv("DRYER_MIDI_CC")) {
+        parseStreams(value);
+    }
+    if (const char* value = std::getenv("DRYER_MIDI_CC_THRESHOLD")) {
+        threshold = std::max(1, std::atoi(value));
+    }
+    if (const char* value = std::getenv("DRYER_MIDI_BEND")) {
+        bendDepth = std::clamp(static_cast<float>(std::atof(value)), 0.0f, 1.0f);
+    }
+    if (const char* value = std::getenv("DRYER_MIDI_MPE")) {
+        mpeChannels = std::clamp(std::atoi(value), 0, 15);
+    }
+
+    if (mpeChannels > 0) {
+        std::cout << "MIDI: MPE lower zone, " << mpeChannels << " member channels" << std::endl;
+    }
+    if (hasControlStreams()) {
+        std::cout << "MIDI: CC streams";
+        for (int i = 0; i < MIDI_STREAM_COUNT; i++) {
+            if (streamController[i] >= 0) {
+                std::cout << " " << STREAM_NAMES[i] << "=" << streamController[i];
+            }
+        }
+        std::cout << ", threshold " << threshold << std::endl;
+    }
+}
+
+void MidiMapper::parseMap(const char* value) {
+    const char* entry = value;
+    while (entry && *entry) {
+        // kind=channel:base-note
+        char name[16];
+        int channel = 0;
+        int baseNote = 0;
+        if (std::sscanf(entry, "%15[^=]=%d:%d", name, &channel, &baseNote) != 3 ||
+            channel < 1 || channel > 16 || baseNote < 0 || baseNote > 127) {
+            std::cerr << "WARNING: ignoring DRYER_MIDI_MAP entry " << entry << std::endl;
+        } else {
+            bool found = false;
+            for (int kind = 0; kind < 3; kind++) {
+                if (std::strcmp(name, KIND_NAMES[kind]) == 0) {
+                    kinds[kind] = KindMap{channel - 1, baseNote};
+                    found = true;
+                }
+            }
+            if (!found) {
+                std::cerr << "WARNING: unknown surface kind in DRYER_MIDI_MAP: " << name << std::endl;
+            }
+        }
+
+        entry = std::strchr(entry, ',');
+        if (entry) entry++;
+    }
+}
+
+void MidiMapper::parseStreams(const char* value) {
+    if (std::strcmp(value, "1") == 0) {
+        std::copy(DEFAULT_CONTROLLERS, DEFAULT_CONTROLLERS + MIDI_STREAM_COUNT, streamController);
+        return;
+    }
+
+    const char* entry = value;
+    while (entry && *entry) {
+        // stream=controller
+        char name[16];
+        int controller = 0;
+        if (std::sscanf(entry, "%15[^=]=%d", name, &controller) == 2 && controller >= 0 && controller < 120) {
+            for (int i = 0; i < MIDI_STREAM_COUNT; i++) {
+                if (std::strcmp(name, STREAM_NAMES[i]) == 0) {
+                    streamController[i] = controller;
+                }
+            }
+        } else {
+            std::cerr << "WARNING: ignoring DRYER_MIDI_CC entry " << entry << std::endl;
+        }
+
+        entry = std::strchr(entry, ',');
+        if (entry) entry++;
+    }
+}
+
+bool MidiMapper::hasControlStreams() const {
+    for (int controller : streamController) {
+        if (controller >= 0) return true;
+    }
+    return false;
+}
+
+void MidiMapper::sendSetup(DryerHardware& hardware) const {
+    if (mpeChannels == 0) return;
+
+    // MPE Configuration Message: RPN 6 on the master channel (channel 1)
+    hardware.sendMIDIControlChange(101, 0, 0);
+    hardware.sendMIDIControlChange(100, 6, 0);
+    hardware.sendMIDIControlChange(6, static_cast<uint8_t>(mpeChannels), 0);
+}
+
+bool MidiMapper::mapHit(int drum, const Surface& surface, float velocity, int defaultNote,
+                        const DryerPhysics& physics, MidiNote& note) {
+    const KindMap& kind = kinds[surface.type];
+    int noteNumber = defaultNote;
+    int channel = drum;                 // one MIDI channel per drum
+    if (kind.channel >= 0) {
+        noteNumber = kind.baseNote + surface.index;
+        channel = kind.channel;
+    }
+    if (noteNumber < 0 || noteNumber > 127) return false;
+
+    if (mpeChannels > 0) {
+        channel = 1 + nextMpeChannel;
+        nextMpeChannel = (nextMpeChannel + 1) % mpeChannels;
+    }
+
+    // Scale velocity to MIDI range (1-127: velocity 0 would be a note-off)
+    int velocityMIDI = std::clamp(static_cast<int>(velocity * VELOCITY_SCALE), 1, 127);
+
+    note.note = static_cast<uint8_t>(noteNumber);
+    note.velocity = static_cast<uint8_t>(velocityMIDI);
+    note.channel = static_cast<uint8_t>(channel);
+    note.hasPitchBend = bendDepth > 0.0f;
+    note.pitchBend = note.hasPitchBend ? pitchBendFor(surface, velocity, physics.getBall()) : 0;
+    return true;
+}
+
+int16_t MidiMapper::pitchBendFor(const Surface& surface, float velocity, const Ball& ball) const {
+    float distance = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    if (distance <= 0.0f || velocity <= 0.0f) return 0;
+
+    // Glancing speed along the surface: around the drum for the wall, along
+    // the (radial) vane for a vane. The reflection keeps it, so the ball's
+    // velocity after the hit still has it.
+    float tangential;
+    if (surface.type == SURFACE_DRUM) {
+        tangential = (-ball.y * ball.vx + ball.x * ball.vy) / distance;
+    } else {
+        tangential = (ball.x * ball.vx + ball.y * ball.vy) / distance;
+    }
+
+    // Head-on = no bend, grazing = full bend, signed by direction
+    float angle = std::atan2(tangential, velocity);
+    float bend = angle / static_cast<float>(M_PI / 2.0) * 8191.0f * bendDepth;
+    return static_cast<int16_t>(std::clamp(std::lround(bend), -8192L, 8191L));
+}
+
+int MidiMapper::controlChanges(int drum, const DryerPhysics& physics, uint64_t nowNs, MidiControl* controls) {
+    const Ball& ball = physics.getBall();
+    float distance = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+
+    float values[MIDI_STREAM_COUNT];
+    values[MIDI_STREAM_RADIUS] = distance / physics.getDrumRadius();
+
+    // Screen angle: the rotating-frame angle turned by the drum
+    float angle = std::atan2(ball.y, ball.x) + physics.getDrumAngle();
+    angle = std::fmod(angle, static_cast<float>(2.0 * M_PI));
+    if (angle < 0.0f) angle += static_cast<float>(2.0 * M_PI);
+    values[MIDI_STREAM_ANGLE] = angle / static_cast<float>(2.0 * M_PI);
+
+    values[MIDI_STREAM_SPEED] = physics.getDebugInfo().totalVelocity / SPEED_FULL_SCALE;
+
+    // CCs of all member notes go on the MPE master channel
+    uint8_t channel = static_cast<uint8_t>(mpeChannels > 0 ? 0 : drum);
+
+    int count = 0;
+    for (int i = 0; i < MIDI_STREAM_COUNT; i++) {
+        if (streamController[i] < 0) continue;
+
+        int value = std::clamp(static_cast<int>(values[i] * 127.0f + 0.5f), 0, 127);
+        int last = lastValue[drum][i];
+        if (last >= 0 && (std::abs(value - last) < threshold ||
+                          nowNs - lastSentNs[drum][i] < CONTROL_MIN_INTERVAL_NS)) {
+            continue;
+        }
+
+        lastValue[drum][i] = value;
+        lastSentNs[drum][i] = nowNs;
+        controls[count++] = MidiControl{static_cast<uint8_t>(streamController[i]),
+                                        static_cast<uint8_t>(value), channel};
+    }
+    return count;
+}
@@ -0,0 +1,87 @@
+#ifndef DRYER_MIDI_H
+#define DRYER_MIDI_H
+
+#include "dryer-hardware.h"
+#include "dryer-physics.h"
+#include "pins.h"
+#include <cstdint>
+
+// ============================================================================
+// DRYER MIDI - What hits and ball motion turn into on the MIDI link
+//   DRYER_MIDI_MAP=drum=1:36,lead=2:48,trail=2:60
+//                              channel:base-note per surface kind; a kind
+//                              left out keeps the default (channel = drum,
+//                              chromatic from C2 in surface order)
+//   DRYER_MIDI_CC=1            stream ball radius/angle/speed as CC 20/21/22,
+//                              or pick them: DRYER_MIDI_CC=radius=74,speed=1
+//   DRYER_MIDI_CC_THRESHOLD=2  smallest change that is worth resending
+//   DRYER_MIDI_BEND=1.0        pitch bend from the impact angle (depth 0..1)
+//   DRYER_MIDI_MPE=15          MPE lower zone: every note on its own member
+//                              channel (2..N+1) so its bend is its own
+//
+// Runs on the physics thread; the link budget is enforced by DryerOutput.
+// ============================================================================
+
+enum MidiStream {
+    MIDI_STREAM_RADIUS = 0,     // ball distance from the centre, 0 = centre
+    MIDI_STREAM_ANGLE,          // ball position around the drum, on screen
+    MIDI_STREAM_SPEED,          // ball speed in the drum
+    MIDI_STREAM_COUNT
+};
+
+struct MidiNote {
+    uint8_t note;
+    uint8_t velocity;
+    uint8_t channel;
+    bool hasPitchBend;
+    int16_t pitchBend;          // -8192..8191, sent just before the note-on
+};
+
+struct MidiControl {
+    uint8_t controller;
+    uint8_t value;
+    uint8_t channel;
+};
+
+class MidiMapper {
+public:
+    MidiMapper();
+
+    void loadFromEnvironment();
+    bool hasControlStreams() const;
+
+    // MPE configuration message; call before the output thread starts
+    void sendSetup(DryerHardware& hardware) const;
+
+    // Note for a hit. defaultNote is the chromatic note of the surface,
+    // used unless DRYER_MIDI_MAP covers its kind. False if there is none.
+    bool mapHit(int drum, const Surface& surface, float velocity, int defaultNote,
+                const DryerPhysics& physics, MidiNote& note);
+
+    // CC values of one drum's ball that moved past the threshold since
+    // they were last sent; fills up to MIDI_STREAM_COUNT, returns how many
+    int controlChanges(int drum, const DryerPhysics& physics, uint64_t nowNs, MidiControl* controls);
+
+private:
+    struct KindMap {
+        int channel;            // 0-based, -1 = default
+        int baseNote;
+    };
+
+    KindMap kinds[3];           // by SurfaceType
+    int streamController[MIDI_STREAM_COUNT];    // -1 = off
+    int threshold;
+    float bendDepth;            // 0 = no pitch bend
+    int mpeChannels;            // 0 = MPE off
+    int nextMpeChannel;
+
+    // Last value sent per drum and stream (-1 = never)
+    int lastValue[MAX_DRUMS][MIDI_STREAM_COUNT];
+    uint64_t lastSentNs[MAX_DRUMS][MIDI_STREAM_COUNT];
+
+    void parseMap(const char* value);
+    void parseStreams(const char* value);
+    int16_t pitchBendFor(const Surface& surface, float velocity, const Ball& ball) const;
+};
+
+#endif // DRYER_MIDI_H
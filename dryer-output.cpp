@@ -0,0 +1,317 @@
+#include "dryer-output.h"
+#include "dryer-alloc.h"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+// Output thread wakes at least this often to end trigger pulses
+static const auto OUTPUT_TICK = std::chrono::milliseconds(1);
+
+// MIDI link budget
+static const double MIDI_BURST_BYTES = 32.0;        // what the budget can save up
+static const double NOTE_RESERVE_BYTES = 6.0;       // CCs leave room for a bent note
+
+// Heap order for scheduled events: earliest due time on top
+static bool dueLater(const OutputEvent& a, const OutputEvent& b) {
+    return a.dueNs > b.dueNs;
+}
+
+DryerOutput::DryerOutput(DryerHardware& hardware, LatencyStats& latency)
+    : hardware(hardware)
+    , latency(latency)
+    , realtime(nullptr)
+    , running(false)
+    , worstDispatchLagNs(0)
+    , pendingNoteOffs(0)
+    , midiBudgetBytes(MIDI_BURST_BYTES)
+    , midiBudgetNs(0)
+    , midiBytesPerSecond(0.0)
+    , midiBytesSent(0)
+    , controlsSent(0)
+    , controlsCoalesced(0)
+    , bendsSkipped(0)
+    , startNs(0)
+{
+    std::memset(noteOffDueNs, 0, sizeof(noteOffDueNs));
+    std::memset(controlValue, -1, sizeof(controlValue));
+}
+
+DryerOutput::~DryerOutput() {
+    stop();
+}
+
+bool DryerOutput::start(DryerRealtime* realtime) {
+    if (running) return true;
+
+    this->realtime = realtime;
+    startNs = latencyNowNs();
+    midiBudgetNs = startNs;
+    midiBytesPerSecond = hardware.midiBytesPerSecond();
+    running = true;
+    thread = std::thread(&DryerOutput::run, this);
+    return true;
+}
+
+void DryerOutput::stop() {
+    if (!running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wakeCondition.notify_one();
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool DryerOutput::post(OutputEvent event) {
+    event.queueNs = latencyNowNs();
+    if (event.type == OUTPUT_NOTE) {
+        latency.record(LATENCY_DETECT_TO_QUEUE, event.detectNs, event.queueNs);
+    }
+
+    if (!queue.push(event)) {
+        latency.recordDrop();
+        return false;
+    }
+
+    // No lock here: wakeMutex has no priority inheritance, and this runs on
+    // the SCHED_FIFO physics thread. A wakeup lost between the consumer's
+    // empty() check and its wait costs at most one OUTPUT_TICK.
+    wakeCondition.notify_one();
+    return true;
+}
+
+void DryerOutput::run() {
+    if (realtime) {
+        realtime->enterThread(THREAD_OUTPUT);
+    }
+
+    auto lastSample = std::chrono::steady_clock::now();
+
+    while (true) {
+        // Sleep until the next scheduled event if that is sooner than a tick
+        auto timeout = std::chrono::nanoseconds(OUTPUT_TICK);
+        if (!scheduled.empty()) {
+            uint64_t nowNs = latencyNowNs();
+            uint64_t untilDue = scheduled[0].dueNs > nowNs ? scheduled[0].dueNs - nowNs : 0;
+            timeout = std::min(timeout, std::chrono::nanoseconds(untilDue));
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, timeout, [this]() {
+                return !running || !queue.empty();
+            });
+            if (!running) break;
+        }
+
+        OutputEvent event;
+        while (queue.pop(event)) {
+            schedule(event, latencyNowNs());
+        }
+        dispatchDue(latencyNowNs());
+
+        serviceNoteOffs(latencyNowNs(), false);
+        serviceControls(latencyNowNs());
+        hardware.updateTriggers();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSample >= std::chrono::seconds(1)) {
+            if (realtime) {
+                realtime->sampleThread(THREAD_OUTPUT);
+            }
+            lastSample = now;
+            
+            // Warmed up: from here on the loop must not allocate
+            DryerAlloc::armThread();
+        }
+    }
+
+    DryerAlloc::disarmThread();
+
+    // Drop whatever was scheduled for later, release held notes
+    scheduled.clear();
+    serviceNoteOffs(0, true);
+}
+
+void DryerOutput::schedule(const OutputEvent& event, uint64_t nowNs) {
+    if (event.dueNs <= nowNs) {
+        dispatch(event);
+        return;
+    }
+    if (!scheduled.push_back(event)) {
+        latency.recordDrop();
+        return;
+    }
+    std::push_heap(scheduled.begin(), scheduled.end(), dueLater);
+}
+
+void DryerOutput::dispatchDue(uint64_t nowNs) {
+    while (!scheduled.empty() && scheduled[0].dueNs <= nowNs) {
+        std::pop_heap(scheduled.begin(), scheduled.end(), dueLater);
+        dispatch(scheduled.back());
+        scheduled.pop_back();
+    }
+}
+
+void DryerOutput::dispatch(const OutputEvent& event) {
+    if (event.type == OUTPUT_CONTROL) {
+        queueControl(event);
+        return;
+    }
+
+    uint64_t dispatchNs = latencyNowNs();
+    refillBudget(dispatchNs);
+
+    // A scheduled event only counts as late from its due time on
+    uint64_t readyNs = std::max(event.queueNs, event.dueNs);
+    if (event.dueNs == 0) {
+        latency.record(LATENCY_QUEUE_TO_DISPATCH, event.queueNs, dispatchNs);
+    }
+
+    // Single writer; takeDispatchLag() resets it
+    uint64_t lag = dispatchNs > readyNs ? dispatchNs - readyNs : 0;
+    if (lag > worstDispatchLagNs.load(std::memory_order_relaxed)) {
+        worstDispatchLagNs.store(lag, std::memory_order_relaxed);
+    }
+
+    uint8_t channel = event.channel & 0x0F;
+    uint8_t note = event.note & 0x7F;
+
+    // The bend has to land before the note; skip it rather than delay the
+    // note when the link is saturated
+    if (event.hasPitchBend) {
+        if (midiBudgetBytes >= NOTE_RESERVE_BYTES) {
+            hardware.sendMIDIPitchBend(event.pitchBend, channel);
+            spendBudget(3);
+        } else {
+            bendsSkipped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Detection latency is meaningless for a deliberately delayed event;
+    // what matters there is how close to its due time it went out
+    hardware.sendMIDINoteOn(note, event.velocity, channel);
+    spendBudget(3);
+    if (event.dueNs == 0) {
+        latency.record(LATENCY_DETECT_TO_MIDI, event.detectNs, latencyNowNs());
+    } else {
+        latency.record(LATENCY_DUE_TO_MIDI, event.dueNs, latencyNowNs());
+    }
+
+    if (event.triggerPin >= 0) {
+        hardware.triggerPulse(event.triggerPin);
+        latency.markBoot(BOOT_FIRST_GATE);
+        if (event.dueNs == 0) {
+            latency.record(LATENCY_DETECT_TO_GATE, event.detectNs, latencyNowNs());
+        }
+    }
+
+    // (Re)arm the note-off; a retrigger extends the note
+    if (noteOffDueNs[channel][note] == 0) {
+        pendingNoteOffs++;
+    }
+    noteOffDueNs[channel][note] = dispatchNs + MIDI_NOTE_LENGTH_MS * 1000000ULL;
+}
+
+void DryerOutput::serviceNoteOffs(uint64_t nowNs, bool flushAll) {
+    if (pendingNoteOffs == 0) return;
+
+    for (int channel = 0; channel < 16; channel++) {
+        for (int note = 0; note < 128; note++) {
+            uint64_t due = noteOffDueNs[channel][note];
+            if (due != 0 && (flushAll || nowNs >= due)) {
+                hardware.sendMIDINoteOff(note, channel);
+                spendBudget(3);
+                noteOffDueNs[channel][note] = 0;
+                pendingNoteOffs--;
+            }
+        }
+    }
+}
+
+void DryerOutput::queueControl(const OutputEvent& event) {
+    uint8_t channel = event.channel & 0x0F;
+    uint8_t controller = event.note & 0x7F;
+
+    // Still waiting: the newer value replaces it
+    if (controlValue[channel][controller] >= 0) {
+        controlsCoalesced.fetch_add(1, std::memory_order_relaxed);
+    } else if (!pendingControls.push_back(static_cast<uint16_t>(channel << 7 | controller))) {
+        latency.recordDrop();
+        return;
+    }
+    controlValue[channel][controller] = static_cast<int8_t>(event.velocity & 0x7F);
+}
+
+void DryerOutput::serviceControls(uint64_t nowNs) {
+    if (pendingControls.empty()) return;
+
+    refillBudget(nowNs);
+
+    // Oldest change first, only from what the notes don't need
+    size_t sent = 0;
+    while (sent < pendingControls.size() && midiBudgetBytes >= 3.0 + NOTE_RESERVE_BYTES) {
+        uint16_t key = pendingControls[sent++];
+        uint8_t channel = key >> 7;
+        uint8_t controller = key & 0x7F;
+
+        hardware.sendMIDIControlChange(controller, controlValue[channel][controller], channel);
+        controlValue[channel][controller] = -1;
+        spendBudget(3);
+        controlsSent.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Keep the rest in order
+    size_t remaining = 0;
+    for (size_t i = sent; i < pendingControls.size(); i++) {
+        pendingControls[remaining++] = pendingControls[i];
+    }
+    while (pendingControls.size() > remaining) {
+        pendingControls.pop_back();
+    }
+}
+
+void DryerOutput::refillBudget(uint64_t nowNs) {
+    // No slow port (USB / sequencer only): the budget is always full
+    if (midiBytesPerSecond <= 0.0) {
+        midiBudgetBytes = MIDI_BURST_BYTES;
+    } else if (nowNs > midiBudgetNs) {
+        midiBudgetBytes = std::min(MIDI_BURST_BYTES,
+                                   midiBudgetBytes + (nowNs - midiBudgetNs) * 1e-9 * midiBytesPerSecond);
+    }
+    midiBudgetNs = nowNs;
+}
+
+void DryerOutput::spendBudget(int bytes) {
+    // May go negative: notes are never held back, CCs wait for it to recover
+    if (midiBytesPerSecond > 0.0) {
+        midiBudgetBytes -= bytes;
+    }
+    midiBytesSent.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void DryerOutput::report(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    uint64_t bytes = midiBytesSent.load(std::memory_order_relaxed);
+    double seconds = (latencyNowNs() - startNs) * 1e-9;
+    out << "=== Dryer MIDI ===\n";
+    out << "link: " << bytes << " bytes";
+    if (midiBytesPerSecond > 0.0 && seconds > 0.0) {
+        out << ", " << std::fixed << std::setprecision(1)
+            << 100.0 * bytes / (seconds * midiBytesPerSecond) << "% of the slowest port";
+    }
+    out << "\n";
+    out.flags(flags);
+    out.precision(precision);
+    out << "controls: " << controlsSent.load(std::memory_order_relaxed) << " sent, "
+        << controlsCoalesced.load(std::memory_order_relaxed) << " coalesced; pitch bends skipped: "
+        << bendsSkipped.load(std::memory_order_relaxed) << "\n";
+}
@@ -0,0 +1,116 @@
+#ifndef DRYER_OUTPUT_H
+#define DRYER_OUTPUT_H
+
+#include "dryer-fixed-vector.h"
+#include "dryer-hardware.h"
+#include "dryer-latency.h"
+#include "dryer-queue.h"
+#include "dryer-realtime.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+// ============================================================================
+// DRYER OUTPUT - Collision events -> MIDI / trigger outputs
+// Owns the output thread so the physics loop never blocks on UART or GPIO.
+// Events with a due time (quantize mode) wait on the output thread until
+// then, in a bounded queue ordered by due time.
+//
+// Every MIDI byte goes through one budget at the rate of the slowest port
+// (the UART: 31.25 kbaud = 3125 bytes/s). Notes and note-offs always go out; a pitch bend in front
+// of a note is left out when the link is saturated; CC values are kept
+// per controller, newest wins, and sent only while the budget has room
+// to spare for the next note.
+// ============================================================================
+
+enum OutputEventType : uint8_t {
+    OUTPUT_NOTE,            // note-on (+ optional bend) + trigger, note-off later
+    OUTPUT_CONTROL          // CC: note = controller, velocity = value
+};
+
+struct OutputEvent {
+    OutputEventType type;
+    uint8_t note;
+    uint8_t velocity;
+    uint8_t channel;
+    bool hasPitchBend;
+    int16_t pitchBend;      // -8192..8191, sent on the channel before the note
+    int triggerPin;         // GPIO_TRIGGER_OUT_x, or -1 for MIDI only
+    uint64_t dueNs;         // play at this time (latencyNowNs), 0 = at once
+
+    // Latency stamps (latencyNowNs)
+    uint64_t detectNs;      // collision detected by physics
+    uint64_t queueNs;       // pushed to the output queue (set by post())
+};
+
+class DryerOutput {
+public:
+    DryerOutput(DryerHardware& hardware, LatencyStats& latency);
+    ~DryerOutput();
+
+    // Realtime settings for the output thread are applied if given
+    bool start(DryerRealtime* realtime = nullptr);
+    void stop();
+
+    // Called from the physics loop. Never blocks; drops if the queue is full.
+    bool post(OutputEvent event);
+
+    // Worst queue -> dispatch delay since the last call (render scheduler)
+    uint64_t takeDispatchLag() { return worstDispatchLagNs.exchange(0, std::memory_order_relaxed); }
+
+    // MIDI link usage
+    void report(std::ostream& out) const;
+
+private:
+    DryerHardware& hardware;
+    LatencyStats& latency;
+    DryerRealtime* realtime;
+
+    SpscQueue<OutputEvent, 256> queue;
+
+    // Events waiting for their due time: min-heap on dueNs (output thread)
+    static const int MAX_SCHEDULED_EVENTS = 128;
+    FixedVector<OutputEvent, MAX_SCHEDULED_EVENTS> scheduled;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> worstDispatchLagNs;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    // Pending MIDI note-offs, indexed [channel][note] (0 = none)
+    uint64_t noteOffDueNs[16][128];
+    int pendingNoteOffs;
+
+    // MIDI byte budget (output thread)
+    double midiBudgetBytes;
+    uint64_t midiBudgetNs;
+    double midiBytesPerSecond;      // 0 = unlimited
+
+    // Latest unsent CC value per [channel][controller] (-1 = none), and the
+    // order they changed in
+    static const int MAX_PENDING_CONTROLS = 64;
+    int8_t controlValue[16][128];
+    FixedVector<uint16_t, MAX_PENDING_CONTROLS> pendingControls;
+
+    std::atomic<uint64_t> midiBytesSent;
+    std::atomic<uint64_t> controlsSent;
+    std::atomic<uint64_t> controlsCoalesced;
+    std::atomic<uint64_t> bendsSkipped;
+    uint64_t startNs;
+
+    void run();
+    void schedule(const OutputEvent& event, uint64_t nowNs);
+    void dispatchDue(uint64_t nowNs);
+    void dispatch(const OutputEvent& event);
+    void serviceNoteOffs(uint64_t nowNs, bool flushAll);
+    void queueControl(const OutputEvent& event);
+    void serviceControls(uint64_t nowNs);
+    void refillBudget(uint64_t nowNs);
+    void spendBudget(int bytes);
+};
+
+#endif // DRYER_OUTPUT_H
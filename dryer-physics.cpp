@@ -2,6 +2,8 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <cstdio>
+#include <iomanip>
 
 // Color palette
 static const uint32_t SURFACE_COLORS[] = {
@@ -10,38 +12,75 @@ static const uint32_t SURFACE_COLORS[] = {
     0xdcedc1, 0xa8d8ea, 0xffccf9, 0xb4f8c8
 };
 
+// Fixed-point step thresholds (Q16.16)
+static const Fixed FIXED_CENTER = 7;            // 0.0001 m: no centrifugal closer in
+static const Fixed FIXED_DRAG_SPEED = 66;       // 0.001 m/s: no drag below
+static const Fixed FIXED_RESTING_SPEED = 9830;  // 0.15 m/s: RESTING_SPEED
+static const int64_t PHASE_PER_RADIAN = 683565276;  // 2^32 / 2π
+
+// Surface ids for every possible surface, built once so that regenerating
+// surfaces never formats strings
+static const char* surfaceId(int vane, SurfaceType type) {
+    static char ids[DryerPhysics::MAX_VANES][DryerPhysics::SURFACES_PER_VANE][16];
+    static bool built = [] {
+        for (int i = 0; i < DryerPhysics::MAX_VANES; i++) {
+            std::snprintf(ids[i][SURFACE_DRUM], sizeof(ids[i][0]), "drum_%d", i);
+            std::snprintf(ids[i][SURFACE_VANE_LEADING], sizeof(ids[i][0]), "vane_%d_lead", i);
+            std::snprintf(ids[i][SURFACE_VANE_TRAILING], sizeof(ids[i][0]), "vane_%d_trail", i);
+        }
+        return true;
+    }();
+    (void)built;
+    return ids[vane][type];
+}
+
 DryerPhysics::DryerPhysics() {
-    // Initialize parameters
-    rpm = 20.0f;
-    drumRadius = 0.80f;     // 80cm default
-    vaneCount = 5;
-    vaneHeight = 0.30f;     // 30% of radius
+    // Initialize parameters (80cm drum, 5 vanes at 30% of radius)
+    parameterBuffers[0] = Parameters::make(20.0f, 80.0f, 5, 30.0f);
+    parameterBuffers[1] = parameterBuffers[0];
+    activeParameters = 0;
+    parametersPending = false;
+    parametersApplied = false;
+    morphTime = 0.0f;
+    morphRemaining = 0.0f;
+    rpm = parameterBuffers[0].rpm;
+    drumRadius = parameterBuffers[0].drumRadius;
+    vaneCount = parameterBuffers[0].vaneCount;
+    vaneHeight = parameterBuffers[0].vaneHeight;
+    morphFromRpm = rpm;
+    morphFromRadius = drumRadius;
+    morphFromHeight = vaneHeight;
+    requestedRpm = 0.0f;
+    requestedDrumSize = 0.0f;
+    requestedHeight = 0.0f;
+    requestedVanes = -1;
     
     // Initialize ball properties
     ball.x = 0.0f;
     ball.y = 0.0f;
     ball.vx = 0.0f;
     ball.vy = 0.0f;
-    ball.radius = 0.035f;   // Tennis ball: 3.5cm
-    ball.mass = 0.058f;     // Tennis ball: 58g
-    ball.restitution = 0.75f;
-    ball.dragCoeff = 0.55f;
+    applyBall(*builtinBallPreset("tennis"));    // also sets useQuadraticDrag
     
     // Physical constants
     gravity = 9.81f;
     earthGravity = 9.81f;
     moonGravity = 1.635f;
-    airDensity = 1.225f;
     
     // Feature toggles
     lintTrapEnabled = false;
     lintTrapThreshold = 0.15f;
     moonGravityEnabled = false;
-    useQuadraticDrag = false;
+    linearDragDt = 0.0f;
+    linearDamping = 1.0f;
     
     // Drum rotation
-    drumAngle = 0.0f;
+    drumPhase = 0;
+    stepDelta = 0.0f;
+    stepCos = 1.0f;
+    stepSin = 0.0f;
     drumAngularVelocity = 0.0f;
+    externalRotation = false;
     
     // Physics toggles (Coriolis ON by default - fixes "wind" effect)
     enableCoriolis = true;
@@ -49,43 +88,178 @@ DryerPhysics::DryerPhysics() {
     enableAirDrag = true;
     coriolisSignFlip = 1;
     
+    lastCollisionSlot = -1;
+    
+    // Resting contact
+    contactSleepEnabled = true;
+    contactState = CONTACT_FREE;
+    contactSegment = 0;
+    restingSteps = 0;
+    contactStats = ContactStats();
+    
+    // Specialized step for the toggles above
+    specializedStep = true;
+#ifdef DRYER_FIXED_POINT
+    fixedPoint = true;
+#else
+    fixedPoint = false;
+#endif
+    selectStepKernel();
+    
     // Initialize
     reset();
     updateSurfaces();
 }
 
+DryerPhysics::Parameters DryerPhysics::Parameters::make(float rpm, float drumSizeCm, int vaneCount,
+                                                      float vaneHeightPercent) {
+    Parameters parameters;
+    parameters.rpm = rpm;
+    parameters.drumRadius = drumSizeCm / 100.0f;  // cm to meters
+    parameters.vaneCount = std::max(1, std::min(vaneCount, MAX_VANES));
+    parameters.vaneHeight = vaneHeightPercent / 100.0f;
+    
+    // The angles exactly as the steps used to work them out per vane
+    for (int i = 0; i <= parameters.vaneCount; i++) {
+        float vaneAngle = (static_cast<float>(i) / parameters.vaneCount) * 2.0f * M_PI;
+        parameters.vaneCos[i] = std::cos(vaneAngle);
+        parameters.vaneSin[i] = std::sin(vaneAngle);
+    }
+    for (int i = 0; i < parameters.vaneCount; i++) {
+        uint32_t phase = static_cast<uint32_t>((static_cast<uint64_t>(i) << 32) / parameters.vaneCount);
+        fixedSinCos(phase, parameters.fixedVaneCos[i], parameters.fixedVaneSin[i]);
+    }
+    return parameters;
+}
+
 void DryerPhysics::setParameters(float rpm, float drumSizeCm, int vaneCount, float vaneHeightPercent) {
+    // Called at the knob read rate; only a change builds a snapshot
+    if (rpm == requestedRpm && drumSizeCm == requestedDrumSize && vaneCount == requestedVanes &&
+        vaneHeightPercent == requestedHeight) {
+        return;
+    }
+    requestedRpm = rpm;
+    requestedDrumSize = drumSizeCm;
+    requestedVanes = vaneCount;
+    requestedHeight = vaneHeightPercent;
+    
+    parameterBuffers[1 - activeParameters] = Parameters::make(rpm, drumSizeCm, vaneCount, vaneHeightPercent);
+    parametersPending = true;
+}
+
+void DryerPhysics::setParameters(const Parameters& parameters) {
+    requestedVanes = -1;
+    parameterBuffers[1 - activeParameters] = parameters;
+    parametersPending = true;
+}
+
+const DryerPhysics::Parameters& DryerPhysics::getParameters() const {
+    return parameterBuffers[parametersPending ? 1 - activeParameters : activeParameters];
+}
+
+// At a step boundary: swap in pending parameters, then move the continuous
+// ones along the morph
+void DryerPhysics::applyParameters(float dt, bool morph) {
+    if (parametersPending) {
+        const Parameters& next = parameterBuffers[1 - activeParameters];
+        
+        // A resting ball's arc and segment go with the geometry
+        if (next.drumRadius != drumRadius || next.vaneCount != vaneCount) {
+            wake(CONTACT_WAKE_RESET);
+        }
+        
+        // From wherever a running morph has got to
+        morphFromRpm = rpm;
+        morphFromRadius = drumRadius;
+        morphFromHeight = vaneHeight;
+        morphRemaining = morph && parametersApplied ? morphTime : 0.0f;
+        activeParameters = 1 - activeParameters;
+        parametersPending = false;
+        parametersApplied = true;
+        
+        // The vane count cannot morph
+        vaneCount = next.vaneCount;
+        updateSurfaces();
+    }
+    
+    const Parameters& target = activeGeometry();
+    morphRemaining = morph ? std::max(morphRemaining - dt, 0.0f) : 0.0f;
+    if (morphRemaining > 0.0f) {
+        float t = 1.0f - morphRemaining / morphTime;
+        rpm = morphFromRpm + (target.rpm - morphFromRpm) * t;
+        drumRadius = morphFromRadius + (target.drumRadius - morphFromRadius) * t;
+        vaneHeight = morphFromHeight + (target.vaneHeight - morphFromHeight) * t;
+    } else {
+        rpm = target.rpm;
+        drumRadius = target.drumRadius;
+        vaneHeight = target.vaneHeight;
+    }
+    
+    // Update angular velocity (rad/s)
+    if (!externalRotation) {
+        drumAngularVelocity = (rpm * 2.0f * M_PI) / 60.0f;
+    }
+    
+    // A smaller drum carries the ball in with its wall, without a hit;
+    // what it had of outward speed goes
+    float limit = drumRadius - ball.radius;
+    float dist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    if (dist > limit && dist > 0.0f) {
+        float ux = ball.x / dist;
+        float uy = ball.y / dist;
+        ball.x = ux * limit;
+        ball.y = uy * limit;
+        float outward = ball.vx * ux + ball.vy * uy;
+        if (outward > 0.0f) {
+            ball.vx -= outward * ux;
+            ball.vy -= outward * uy;
+        }
+    }
+}
+
+void DryerPhysics::modulate(float rpm, float vaneHeightPercent) {
     this->rpm = rpm;
-    this->drumRadius = drumSizeCm / 100.0f;  // cm to meters
-    this->vaneCount = vaneCount;
     this->vaneHeight = vaneHeightPercent / 100.0f;
     
-    // Update angular velocity (rad/s)
-    this->drumAngularVelocity = (rpm * 2.0f * M_PI) / 60.0f;
+    // Into both snapshots and the morph start, so neither a swap nor a
+    // morph undoes it before the step
+    for (Parameters& parameters : parameterBuffers) {
+        parameters.rpm = rpm;
+        parameters.vaneHeight = this->vaneHeight;
+    }
+    morphFromRpm = rpm;
+    morphFromHeight = this->vaneHeight;
     
-    // Regenerate surfaces
-    updateSurfaces();
+    if (!externalRotation) {
+        this->drumAngularVelocity = (rpm * 2.0f * M_PI) / 60.0f;
+    }
 }
 
 void DryerPhysics::setBallProperties(float radius, float mass, float restitution, float dragCoeff) {
-    ball.radius = radius;
-    ball.mass = mass;
-    ball.restitution = restitution;
-    ball.dragCoeff = dragCoeff;
+    setBall(BallPreset::make("custom", radius, mass, restitution, dragCoeff, useQuadraticDrag));
 }
 
-void DryerPhysics::setTennisBall() {
-    setBallProperties(0.035f, 0.058f, 0.75f, 0.55f);
-    std::cout << "🎾 Tennis ball selected" << std::endl;
+void DryerPhysics::setBall(const BallPreset& preset) {
+    wake(CONTACT_WAKE_RESET);
+    applyBall(preset);
+    selectStepKernel();
+    std::cout << "🎾 Ball: " << preset.name << (preset.quadraticDrag ? " (quadratic drag)" : "") << std::endl;
 }
 
-void DryerPhysics::setBalloonBall() {
-    setBallProperties(0.075f, 0.001f, 0.10f, 0.47f);
-    std::cout << "🎈 Balloon ball selected" << std::endl;
+void DryerPhysics::applyBall(const BallPreset& preset) {
+    ball.radius = preset.radius;
+    ball.mass = preset.mass;
+    ball.restitution = preset.restitution;
+    ball.dragCoeff = preset.dragCoeff;
+    ball.inverseMass = preset.inverseMass;
+    ball.bounce = preset.bounce;
+    ball.dragFactor = preset.dragFactor;
+    useQuadraticDrag = preset.quadraticDrag;
 }
 
 void DryerPhysics::setLintTrap(bool enabled) {
     lintTrapEnabled = enabled;
+    selectStepKernel();
     std::cout << "🧺 Lint trap: " << (enabled ? "ON" : "OFF") << std::endl;
 }
 
@@ -96,30 +270,39 @@ void DryerPhysics::setMoonGravity(bool enabled) {
 }
 
 void DryerPhysics::updateSurfaces() {
+    // Called on every parameter update; skip if the layout is unchanged
+    if (static_cast<int>(surfaces.size()) == vaneCount * SURFACES_PER_VANE) {
+        return;
+    }
+    
     surfaces.clear();
     
+    // Slots follow surfaceSlot(), so lookups are direct indexing
     for (int i = 0; i < vaneCount; i++) {
         // Drum segment
         Surface drumSurf;
-        drumSurf.type = "drum";
-        drumSurf.id = "drum_" + std::to_string(i);
+        drumSurf.type = SURFACE_DRUM;
+        drumSurf.id = surfaceId(i, SURFACE_DRUM);
         drumSurf.index = i;
+        drumSurf.slot = static_cast<int>(surfaces.size());
         drumSurf.color = getSurfaceColor(i * 2);
         surfaces.push_back(drumSurf);
         
         // Vane leading edge
         Surface vaneLeading;
-        vaneLeading.type = "vane_leading";
-        vaneLeading.id = "vane_" + std::to_string(i) + "_lead";
+        vaneLeading.type = SURFACE_VANE_LEADING;
+        vaneLeading.id = surfaceId(i, SURFACE_VANE_LEADING);
         vaneLeading.index = i;
+        vaneLeading.slot = static_cast<int>(surfaces.size());
         vaneLeading.color = getSurfaceColor(i * 2 + 1);
         surfaces.push_back(vaneLeading);
         
         // Vane trailing edge
         Surface vaneTrailing;
-        vaneTrailing.type = "vane_trailing";
-        vaneTrailing.id = "vane_" + std::to_string(i) + "_trail";
+        vaneTrailing.type = SURFACE_VANE_TRAILING;
+        vaneTrailing.id = surfaceId(i, SURFACE_VANE_TRAILING);
         vaneTrailing.index = i;
+        vaneTrailing.slot = static_cast<int>(surfaces.size());
         vaneTrailing.color = getSurfaceColor(i * 2 + 1);
         surfaces.push_back(vaneTrailing);
     }
@@ -130,33 +313,96 @@ uint32_t DryerPhysics::getSurfaceColor(int index) const {
 }
 
 void DryerPhysics::reset() {
+    // A step boundary too: pending parameters apply, without a morph
+    if (parametersPending || morphRemaining > 0.0f) {
+        applyParameters(0.0f, false);
+    }
+    
     ball.x = drumRadius * 0.3f;
     ball.y = 0.0f;
     ball.vx = 0.0f;
     ball.vy = 0.0f;
-    drumAngle = 0.0f;
+    drumPhase = 0;
+    syncRotation();
+    wake(CONTACT_WAKE_RESET);
+}
+
+void DryerPhysics::syncRotation() {
+    float angle = getDrumAngle();
+    drumCos = std::cos(angle);
+    drumSin = std::sin(angle);
+    rotationSteps = 0;
+}
+
+void DryerPhysics::advanceRotation(float dt) {
+    // Exact phase: wraps modulo one revolution (unsigned arithmetic)
+    float delta = drumAngularVelocity * dt;
+    drumPhase += static_cast<uint32_t>(std::llround(delta / RADIANS_PER_PHASE));
+    
+    if (++rotationSteps >= ROTATION_RESYNC_STEPS) {
+        syncRotation();
+        return;
+    }
+    
+    // Per-step rotation, recomputed only when the speed changes; small
+    // angles (any sane RPM at the physics rate) need no trig call
+    if (delta != stepDelta) {
+        stepDelta = delta;
+        if (std::abs(delta) < 0.1f) {
+            float delta2 = delta * delta;
+            stepCos = 1.0f - delta2 * (0.5f - delta2 * (1.0f / 24.0f));
+            stepSin = delta * (1.0f - delta2 * ((1.0f / 6.0f) - delta2 * (1.0f / 120.0f)));
+        } else {
+            stepCos = std::cos(delta);
+            stepSin = std::sin(delta);
+        }
+    }
+    
+    float c = drumCos * stepCos - drumSin * stepSin;
+    float s = drumSin * stepCos + drumCos * stepSin;
+    
+    // Renormalize (first-order 1/|z|) so the magnitude cannot drift
+    float norm = 1.5f - 0.5f * (c * c + s * s);
+    drumCos = c * norm;
+    drumSin = s * norm;
 }
 
 void DryerPhysics::onCollision(CollisionCallback callback) {
     collisionCallbacks.push_back(callback);
 }
 
-void DryerPhysics::step(float dt) {
+// Whether a feature is on: a constant in specialized kernels, the current
+// toggle under runtime dispatch
+template<unsigned Features>
+bool DryerPhysics::hasFeature(unsigned feature) const {
+    if constexpr (Features == STEP_RUNTIME) {
+        return (stepFeatures & feature) != 0;
+    } else {
+        return (Features & feature) != 0;
+    }
+}
+
+template<unsigned Features>
+void DryerPhysics::stepKernelImpl(float dt) {
+    contactStats.steps++;
+    
     // Update drum rotation
-    drumAngle += drumAngularVelocity * dt;
+    advanceRotation(dt);
     
     // Gravitational force (transformed to rotating frame)
-    float cosAngle = std::cos(drumAngle);
-    float sinAngle = std::sin(drumAngle);
+    float gravityX = -gravity * drumSin;
+    float gravityY = -gravity * drumCos;
     
-    float gravityX = -gravity * sinAngle;
-    float gravityY = -gravity * cosAngle;
+    // Resting on the wall: constrained motion along the arc instead
+    if (contactState == CONTACT_ROLLING && stepRolling<Features>(dt, gravityX, gravityY)) {
+        return;
+    }
     
     // Centrifugal force
     float centrifugalX = 0.0f;
     float centrifugalY = 0.0f;
     
-    if (enableCentrifugal) {
+    if (hasFeature<Features>(STEP_CENTRIFUGAL)) {
         float distFromCenter = std::sqrt(ball.x * ball.x + ball.y * ball.y);
         if (distFromCenter > 0.0001f) {
             float centrifugalMagnitude = drumAngularVelocity * drumAngularVelocity * distFromCenter;
@@ -170,7 +416,7 @@ void DryerPhysics::step(float dt) {
     float coriolisX = 0.0f;
     float coriolisY = 0.0f;
     
-    if (enableCoriolis) {
+    if (hasFeature<Features>(STEP_CORIOLIS)) {
         float sign = static_cast<float>(coriolisSignFlip);
         coriolisX = sign * 2.0f * drumAngularVelocity * ball.vy;
         coriolisY = sign * -2.0f * drumAngularVelocity * ball.vx;
@@ -183,26 +429,25 @@ void DryerPhysics::step(float dt) {
     float dragX = 0.0f;
     float dragY = 0.0f;
     
-    if (enableAirDrag) {
+    if (hasFeature<Features>(STEP_AIR_DRAG)) {
         float speed = std::sqrt(ball.vx * ball.vx + ball.vy * ball.vy);
         
         if (speed > 0.001f) {
-            if (useQuadraticDrag) {
-                float dragForceMagnitude = 0.5f * airDensity * speed * speed * ball.dragCoeff * ball.area();
-                float dragAccelMagnitude = dragForceMagnitude / ball.mass;
+            if (hasFeature<Features>(STEP_QUADRATIC_DRAG)) {
+                // dragFactor·v², against the velocity
+                float dragPerSpeed = ball.dragFactor * speed;
                 
-                dragX = -(ball.vx / speed) * dragAccelMagnitude;
-                dragY = -(ball.vy / speed) * dragAccelMagnitude;
+                dragX = -ball.vx * dragPerSpeed;
+                dragY = -ball.vy * dragPerSpeed;
                 
-                debugInfo.dragMagnitude = dragAccelMagnitude;
+                debugInfo.dragMagnitude = dragPerSpeed * speed;
             } else {
                 // Linear drag (original)
-                float dragCoeff = 0.1f;
-                float dampingFactor = std::exp(-dragCoeff * dt);
+                float dampingFactor = linearDampingFor(dt);
                 ball.vx *= dampingFactor;
                 ball.vy *= dampingFactor;
                 
-                debugInfo.dragMagnitude = dragCoeff * speed;
+                debugInfo.dragMagnitude = LINEAR_DRAG * speed;
             }
         }
     }
@@ -211,7 +456,7 @@ void DryerPhysics::step(float dt) {
     float totalAccelX = gravityX + centrifugalX + coriolisX;
     float totalAccelY = gravityY + centrifugalY + coriolisY;
     
-    if (useQuadraticDrag) {
+    if (hasFeature<Features>(STEP_QUADRATIC_DRAG)) {
         totalAccelX += dragX;
         totalAccelY += dragY;
     }
@@ -227,11 +472,146 @@ void DryerPhysics::step(float dt) {
     ball.y += ball.vy * dt;
     
     // Check collisions
-    handleCollisions();
+    handleCollisions<Features>();
 }
 
+// Linear damping per step; the factor only changes with dt
+float DryerPhysics::linearDampingFor(float dt) {
+    if (dt != linearDragDt) {
+        linearDragDt = dt;
+        linearDamping = std::exp(-LINEAR_DRAG * dt);
+    }
+    return linearDamping;
+}
+
+// One step sliding along the drum wall. False (and awake again) if the wall
+// would have to pull the ball to keep it there; the caller then takes a
+// free step.
+template<unsigned Features>
+bool DryerPhysics::stepRolling(float dt, float gravityX, float gravityY) {
+    // Outward normal and tangent at the contact; the ball is kept at rc
+    float rc = drumRadius - ball.radius;
+    float ux = ball.x / rc;
+    float uy = ball.y / rc;
+    float tx = -uy;
+    float ty = ux;
+    float speed = ball.vx * tx + ball.vy * ty;  // signed, along the tangent
+    
+    // Outward push the wall has to hold. Coriolis on tangential motion is
+    // purely radial.
+    float outward = gravityX * ux + gravityY * uy + speed * speed / rc;
+    if (hasFeature<Features>(STEP_CENTRIFUGAL)) {
+        outward += drumAngularVelocity * drumAngularVelocity * rc;
+    }
+    if (hasFeature<Features>(STEP_CORIOLIS)) {
+        outward += static_cast<float>(coriolisSignFlip) * 2.0f * drumAngularVelocity * speed;
+    }
+    if (outward < 0.0f) {
+        wake(CONTACT_WAKE_LIFT_OFF);
+        return false;
+    }
+    
+    // Tangential forces: gravity and drag
+    float along = gravityX * tx + gravityY * ty;
+    if (hasFeature<Features>(STEP_AIR_DRAG) && std::abs(speed) > 0.001f) {
+        if (hasFeature<Features>(STEP_QUADRATIC_DRAG)) {
+            along -= ball.dragFactor * std::abs(speed) * speed;
+        } else {
+            speed *= linearDampingFor(dt);
+        }
+    }
+    speed += along * dt;
+    
+    // Along the tangent, then back onto the arc
+    float x = ball.x + speed * tx * dt;
+    float y = ball.y + speed * ty * dt;
+    float scale = rc / std::sqrt(x * x + y * y);
+    ball.x = x * scale;
+    ball.y = y * scale;
+    ball.vx = -ball.y / rc * speed;
+    ball.vy = ball.x / rc * speed;
+    
+    // It cannot leave its segment without meeting one of the two vanes
+    // either side. Slowly into one, it rests in the corner; faster, it
+    // wakes and bounces off.
+    float vaneInnerRadius = drumRadius * (1.0f - vaneHeight);
+    for (int side = 0; side < 2; side++) {
+        float dx = contactVaneX[side];
+        float dy = contactVaneY[side];
+        float sign = side == 0 ? 1.0f : -1.0f;
+        float inside = sign * (dx * ball.y - dy * ball.x);     // distance from the vane
+        if (dx * ball.x + dy * ball.y < vaneInnerRadius || inside >= ball.radius) continue;
+        
+        if (-sign * speed >= RESTING_SPEED) {
+            wake(CONTACT_WAKE_VANE);
+            int vane = side == 0 ? contactSegment : (contactSegment + 1) % vaneCount;
+            checkVaneCollision<Features>(vane);
+            return true;
+        }
+        
+        // Back out of the vane along the tangent, and stop against it
+        x = ball.x + sign * (ball.radius - inside) * (-ball.y / rc);
+        y = ball.y + sign * (ball.radius - inside) * (ball.x / rc);
+        scale = rc / std::sqrt(x * x + y * y);
+        ball.x = x * scale;
+        ball.y = y * scale;
+        if (-sign * speed > 0.0f) {
+            speed = 0.0f;
+        }
+        ball.vx = -ball.y / rc * speed;
+        ball.vy = ball.x / rc * speed;
+    }
+    
+    debugInfo.totalVelocity = std::abs(speed);
+    contactStats.rollingSteps++;
+    return true;
+}
+
+int DryerPhysics::wallSegment() const {
+    float ballAngle = std::atan2(ball.y, ball.x);
+    float anglePerSegment = (2.0f * M_PI) / vaneCount;
+    
+    // Normalize to [0, 2π)
+    float normalizedAngle = ballAngle;
+    if (normalizedAngle < 0.0f) normalizedAngle += 2.0f * M_PI;
+    
+    return static_cast<int>(std::floor(normalizedAngle / anglePerSegment)) % vaneCount;
+}
+
+void DryerPhysics::sleepOnWall() {
+    // Keep only the tangential velocity
+    float dist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    float ux = ball.x / dist;
+    float uy = ball.y / dist;
+    float vn = ball.vx * ux + ball.vy * uy;
+    ball.vx -= vn * ux;
+    ball.vy -= vn * uy;
+    
+    contactState = CONTACT_ROLLING;
+    contactSegment = wallSegment();
+    restingSteps = 0;
+    
+    // Directions of the vanes either side of the segment
+    const Parameters& geometry = activeGeometry();
+    for (int side = 0; side < 2; side++) {
+        contactVaneX[side] = geometry.vaneCos[contactSegment + side];
+        contactVaneY[side] = geometry.vaneSin[contactSegment + side];
+    }
+    contactStats.sleeps++;
+}
+
+void DryerPhysics::wake(ContactWake cause) {
+    restingSteps = 0;
+    if (contactState != CONTACT_ROLLING) return;
+    
+    contactState = CONTACT_FREE;
+    contactStats.wakes[cause]++;
+}
+
+template<unsigned Features>
 void DryerPhysics::handleCollisions() {
     float ballDist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    bool restingContact = false;
     
     // Drum wall collision
     if (ballDist + ball.radius > drumRadius) {
@@ -247,123 +627,131 @@ void DryerPhysics::handleCollisions() {
         
         // Relative velocity normal to surface
         float vn = ball.vx * nx + ball.vy * ny;
+        restingContact = std::abs(vn) < RESTING_SPEED;
         
         if (vn < 0.0f) {  // Moving into wall
             // Calculate segment before reflecting velocity
-            float ballAngle = std::atan2(ball.y, ball.x);
-            float anglePerSegment = (2.0f * M_PI) / vaneCount;
-            
-            // Normalize to [0, 2π)
-            float normalizedAngle = ballAngle;
-            if (normalizedAngle < 0.0f) normalizedAngle += 2.0f * M_PI;
-            
-            int segmentIndex = static_cast<int>(std::floor(normalizedAngle / anglePerSegment)) % vaneCount;
+            int segmentIndex = wallSegment();
             
             // Reflect velocity
-            ball.vx -= (1.0f + ball.restitution) * vn * nx;
-            ball.vy -= (1.0f + ball.restitution) * vn * ny;
+            ball.vx -= ball.bounce * vn * nx;
+            ball.vy -= ball.bounce * vn * ny;
             
             // Find surface
-            auto it = std::find_if(surfaces.begin(), surfaces.end(),
-                [segmentIndex](const Surface& s) {
-                    return s.type == "drum" && s.index == segmentIndex;
-                });
-            
-            if (it != surfaces.end()) {
-                triggerCollision(*it, std::abs(vn));
+            int slot = surfaceSlot(segmentIndex, SURFACE_DRUM);
+            if (segmentIndex >= 0 && slot < static_cast<int>(surfaces.size())) {
+                triggerCollision<Features>(surfaces[slot], std::abs(vn));
             }
         }
     }
     
     // Vane collisions
-    checkVaneCollisions();
+    float vaneSpeed = checkVaneCollisions<Features>();
+    
+    // Held against the wall (maybe in a corner with a vane) for a while:
+    // from the next step it slides along the arc instead of bouncing a
+    // little every step
+    restingSteps = restingContact && vaneSpeed < RESTING_SPEED ? restingSteps + 1 : 0;
+    if (contactSleepEnabled && restingSteps >= RESTING_STEPS) {
+        sleepOnWall();
+    }
+}
+
+// Fastest normal speed into any vane the ball touched, -1 if none
+template<unsigned Features>
+float DryerPhysics::checkVaneCollisions() {
+    float fastest = -1.0f;
+    for (int i = 0; i < vaneCount; i++) {
+        fastest = std::max(fastest, checkVaneCollision<Features>(i));
+    }
+    return fastest;
 }
 
-void DryerPhysics::checkVaneCollisions() {
+// Normal speed into vane i if the ball touched it (and was pushed off),
+// -1 if not
+template<unsigned Features>
+float DryerPhysics::checkVaneCollision(int i) {
     float vaneInnerRadius = drumRadius * (1.0f - vaneHeight);
+    float cosine = activeGeometry().vaneCos[i];
+    float sine = activeGeometry().vaneSin[i];
     
-    for (int i = 0; i < vaneCount; i++) {
-        float vaneAngle = (static_cast<float>(i) / vaneCount) * 2.0f * M_PI;
-        
-        // Vane endpoints
-        float vx1 = vaneInnerRadius * std::cos(vaneAngle);
-        float vy1 = vaneInnerRadius * std::sin(vaneAngle);
-        float vx2 = drumRadius * std::cos(vaneAngle);
-        float vy2 = drumRadius * std::sin(vaneAngle);
-        
-        // Vector from vane start to ball
-        float dx = ball.x - vx1;
-        float dy = ball.y - vy1;
-        
-        // Vane direction
-        float vdx = vx2 - vx1;
-        float vdy = vy2 - vy1;
-        float vaneLength = std::sqrt(vdx * vdx + vdy * vdy);
+    // Vane endpoints
+    float vx1 = vaneInnerRadius * cosine;
+    float vy1 = vaneInnerRadius * sine;
+    float vx2 = drumRadius * cosine;
+    float vy2 = drumRadius * sine;
+    
+    // Vector from vane start to ball
+    float dx = ball.x - vx1;
+    float dy = ball.y - vy1;
+    
+    // Vane direction
+    float vdx = vx2 - vx1;
+    float vdy = vy2 - vy1;
+    float vaneLength = std::sqrt(vdx * vdx + vdy * vdy);
+    
+    // Project ball onto vane
+    float t = (dx * vdx + dy * vdy) / (vaneLength * vaneLength);
+    
+    if (t >= 0.0f && t <= 1.0f) {
+        // Closest point on vane
+        float closestX = vx1 + t * vdx;
+        float closestY = vy1 + t * vdy;
         
-        // Project ball onto vane
-        float t = (dx * vdx + dy * vdy) / (vaneLength * vaneLength);
+        // Distance from ball to vane
+        float distX = ball.x - closestX;
+        float distY = ball.y - closestY;
+        float dist = std::sqrt(distX * distX + distY * distY);
         
-        if (t >= 0.0f && t <= 1.0f) {
-            // Closest point on vane
-            float closestX = vx1 + t * vdx;
-            float closestY = vy1 + t * vdy;
+        if (dist < ball.radius) {
+            float penetration = ball.radius - dist;
             
-            // Distance from ball to vane
-            float distX = ball.x - closestX;
-            float distY = ball.y - closestY;
-            float dist = std::sqrt(distX * distX + distY * distY);
+            // Normal vector
+            float nx = distX / dist;
+            float ny = distY / dist;
             
-            if (dist < ball.radius) {
-                float penetration = ball.radius - dist;
-                
-                // Normal vector
-                float nx = distX / dist;
-                float ny = distY / dist;
-                
-                // Move ball out
-                ball.x += nx * penetration;
-                ball.y += ny * penetration;
+            // Move ball out
+            ball.x += nx * penetration;
+            ball.y += ny * penetration;
+            
+            // Relative velocity
+            float vn = ball.vx * nx + ball.vy * ny;
+            
+            if (vn < 0.0f) {
+                // Reflect velocity
+                ball.vx -= ball.bounce * vn * nx;
+                ball.vy -= ball.bounce * vn * ny;
                 
-                // Relative velocity
-                float vn = ball.vx * nx + ball.vy * ny;
+                // Determine side
+                float perpX = -vdy / vaneLength;
+                float perpY = vdx / vaneLength;
+                SurfaceType side = (dx * perpX + dy * perpY) > 0.0f ? SURFACE_VANE_LEADING : SURFACE_VANE_TRAILING;
                 
-                if (vn < 0.0f) {
-                    // Reflect velocity
-                    ball.vx -= (1.0f + ball.restitution) * vn * nx;
-                    ball.vy -= (1.0f + ball.restitution) * vn * ny;
-                    
-                    // Determine side
-                    float perpX = -vdy / vaneLength;
-                    float perpY = vdx / vaneLength;
-                    std::string side = (dx * perpX + dy * perpY) > 0.0f ? "vane_leading" : "vane_trailing";
-                    
-                    // Find surface
-                    auto it = std::find_if(surfaces.begin(), surfaces.end(),
-                        [&side, i](const Surface& s) {
-                            return s.type == side && s.index == i;
-                        });
-                    
-                    if (it != surfaces.end()) {
-                        triggerCollision(*it, std::abs(vn));
-                    }
+                // Find surface
+                int slot = surfaceSlot(i, side);
+                if (slot < static_cast<int>(surfaces.size())) {
+                    triggerCollision<Features>(surfaces[slot], std::abs(vn));
                 }
             }
+            return std::abs(vn);
         }
     }
+    return -1.0f;
 }
 
+template<unsigned Features>
 void DryerPhysics::triggerCollision(const Surface& surface, float velocity) {
     // Lint trap filter
-    if (lintTrapEnabled && velocity < lintTrapThreshold) {
+    if (hasFeature<Features>(STEP_LINT_TRAP) && velocity < lintTrapThreshold) {
         return;
     }
     
     // Debounce
-    if (lastCollisionSurface == surface.id) {
+    if (lastCollisionSlot == surface.slot) {
         return;
     }
     
-    lastCollisionSurface = surface.id;
+    lastCollisionSlot = surface.slot;
     
     // Notify all listeners
     for (auto& callback : collisionCallbacks) {
@@ -371,16 +759,368 @@ void DryerPhysics::triggerCollision(const Surface& surface, float velocity) {
     }
 }
 
+// Every feature mask's kernel, indexed by mask
+template<unsigned... Masks>
+const DryerPhysics::StepKernel* DryerPhysics::stepKernelTable(std::integer_sequence<unsigned, Masks...>) {
+    static const StepKernel table[] = {&DryerPhysics::stepKernelImpl<Masks>...};
+    return table;
+}
+
+void DryerPhysics::selectStepKernel() {
+    stepFeatures = (enableCentrifugal ? STEP_CENTRIFUGAL : 0u) |
+                   (enableCoriolis ? STEP_CORIOLIS : 0u) |
+                   (enableAirDrag ? STEP_AIR_DRAG : 0u) |
+                   (useQuadraticDrag ? STEP_QUADRATIC_DRAG : 0u) |
+                   (lintTrapEnabled ? STEP_LINT_TRAP : 0u);
+    
+    if (fixedPoint) {
+        stepKernel = &DryerPhysics::stepFixed;
+        return;
+    }
+    
+    if (!specializedStep) {
+        stepKernel = &DryerPhysics::stepKernelImpl<STEP_RUNTIME>;
+        return;
+    }
+    
+    static const StepKernel* kernels = stepKernelTable(std::make_integer_sequence<unsigned, STEP_FEATURE_COUNT>());
+    stepKernel = kernels[stepFeatures];
+}
+
+// exp(-k) to third order
+static Fixed fixedDamping(Fixed k) {
+    Fixed k2 = fixedMul(k, k);
+    return FIXED_ONE - k + k2 / 2 - fixedMul(k2, k) / 6;
+}
+
+// The float kernel's forces, collisions and resting contact in Q16.16
+// integers. The ball stays stored as float between steps: Q16.16 values of
+// its size convert exactly both ways, so setters and the renderer see no
+// difference. Toggles are read at runtime.
+void DryerPhysics::stepFixed(float dt) {
+    contactStats.steps++;
+    
+    const Fixed dtFixed = fixedFromFloat(dt);
+    const Fixed omega = fixedFromFloat(drumAngularVelocity);
+    
+    // Rotation: radians (Q32.32) to phase, and cos/sin straight from it
+    int64_t radians = static_cast<int64_t>(omega) * dtFixed;
+    drumPhase += static_cast<uint32_t>(((radians >> 8) * PHASE_PER_RADIAN) >> 24);
+    int32_t cosine, sine;
+    fixedSinCos(drumPhase, cosine, sine);
+    drumCos = static_cast<float>(cosine) / (1 << TRIG_SHIFT);
+    drumSin = static_cast<float>(sine) / (1 << TRIG_SHIFT);
+    rotationSteps = 0;
+    
+    FixedBall b = {fixedFromFloat(ball.x), fixedFromFloat(ball.y), fixedFromFloat(ball.vx), fixedFromFloat(ball.vy)};
+    
+    // Gravity (transformed to rotating frame)
+    const Fixed g = fixedFromFloat(gravity);
+    Fixed accelX = -fixedMulTrig(g, sine);
+    Fixed accelY = -fixedMulTrig(g, cosine);
+    
+    // Resting on the wall: constrained motion along the arc instead
+    if (contactState == CONTACT_ROLLING && fixedStepRolling(b, dtFixed, omega, accelX, accelY)) {
+        storeFixedBall(b);
+        return;
+    }
+    
+    // Centrifugal: ω²·r, outward
+    if (hasFeature<STEP_RUNTIME>(STEP_CENTRIFUGAL) && fixedHypot(b.x, b.y) > FIXED_CENTER) {
+        Fixed omega2 = fixedMul(omega, omega);
+        accelX += fixedMul(omega2, b.x);
+        accelY += fixedMul(omega2, b.y);
+    }
+    
+    // Coriolis
+    if (hasFeature<STEP_RUNTIME>(STEP_CORIOLIS)) {
+        Fixed twiceOmega = coriolisSignFlip * 2 * omega;
+        accelX += fixedMul(twiceOmega, b.vy);
+        accelY -= fixedMul(twiceOmega, b.vx);
+    }
+    
+    // Air drag
+    Fixed speed = hasFeature<STEP_RUNTIME>(STEP_AIR_DRAG) ? fixedHypot(b.vx, b.vy) : 0;
+    if (speed > FIXED_DRAG_SPEED) {
+        if (hasFeature<STEP_RUNTIME>(STEP_QUADRATIC_DRAG)) {
+            Fixed dragPerSpeed = fixedMul(fixedFromFloat(ball.dragFactor), speed);
+            accelX -= fixedMul(b.vx, dragPerSpeed);
+            accelY -= fixedMul(b.vy, dragPerSpeed);
+        } else {
+            Fixed damping = fixedDamping(fixedMul(fixedFromFloat(LINEAR_DRAG), dtFixed));
+            b.vx = fixedMul(b.vx, damping);
+            b.vy = fixedMul(b.vy, damping);
+        }
+    }
+    
+    b.vx += fixedMul(accelX, dtFixed);
+    b.vy += fixedMul(accelY, dtFixed);
+    b.x += fixedMul(b.vx, dtFixed);
+    b.y += fixedMul(b.vy, dtFixed);
+    
+    // Drum wall collision
+    const Fixed drum = fixedFromFloat(drumRadius);
+    const Fixed radius = fixedFromFloat(ball.radius);
+    const Fixed bounce = fixedFromFloat(ball.bounce);
+    Fixed dist = fixedHypot(b.x, b.y);
+    bool restingContact = false;
+    if (dist + radius > drum && dist > 0) {
+        Fixed penetration = dist + radius - drum;
+        Fixed nx = -fixedDiv(b.x, dist);
+        Fixed ny = -fixedDiv(b.y, dist);
+        b.x += fixedMul(nx, penetration);
+        b.y += fixedMul(ny, penetration);
+        
+        Fixed vn = fixedMul(b.vx, nx) + fixedMul(b.vy, ny);
+        restingContact = (vn < 0 ? -vn : vn) < FIXED_RESTING_SPEED;
+        if (vn < 0) {
+            int slot = surfaceSlot(fixedWallSegment(b), SURFACE_DRUM);
+            Fixed impulse = fixedMul(bounce, vn);
+            b.vx -= fixedMul(impulse, nx);
+            b.vy -= fixedMul(impulse, ny);
+            if (slot < static_cast<int>(surfaces.size())) {
+                triggerCollision<STEP_RUNTIME>(surfaces[slot], fixedToFloat(-vn));
+            }
+        }
+    }
+    
+    // Vane collisions
+    Fixed innerRadius = drum - fixedMul(drum, fixedFromFloat(vaneHeight));
+    Fixed vaneSpeed = -FIXED_ONE;
+    for (int i = 0; i < vaneCount; i++) {
+        vaneSpeed = std::max(vaneSpeed, fixedVaneCollision(i, b, innerRadius, drum, radius, bounce));
+    }
+    
+    // Held against the wall for a while: asleep from the next step, as in
+    // handleCollisions()
+    restingSteps = restingContact && vaneSpeed < FIXED_RESTING_SPEED ? restingSteps + 1 : 0;
+    if (contactSleepEnabled && restingSteps >= RESTING_STEPS) {
+        fixedSleepOnWall(b);
+    }
+    
+    storeFixedBall(b);
+    debugInfo.totalVelocity = fixedToFloat(fixedHypot(b.vx, b.vy));
+}
+
+// stepRolling() in Q16.16: one step sliding along the drum wall, false
+// (and awake again) if the wall would have to pull the ball
+bool DryerPhysics::fixedStepRolling(FixedBall& fixedBall, Fixed dt, Fixed omega, Fixed gravityX,
+                                    Fixed gravityY) {
+    const Fixed drum = fixedFromFloat(drumRadius);
+    const Fixed radius = fixedFromFloat(ball.radius);
+    const Fixed rc = drum - radius;
+    Fixed ux = fixedDiv(fixedBall.x, rc);
+    Fixed uy = fixedDiv(fixedBall.y, rc);
+    Fixed speed = fixedMul(fixedBall.vy, ux) - fixedMul(fixedBall.vx, uy);    // along (-uy, ux)
+    
+    Fixed outward = fixedMul(gravityX, ux) + fixedMul(gravityY, uy) + fixedDiv(fixedMul(speed, speed), rc);
+    if (hasFeature<STEP_RUNTIME>(STEP_CENTRIFUGAL)) {
+        outward += fixedMul(fixedMul(omega, omega), rc);
+    }
+    if (hasFeature<STEP_RUNTIME>(STEP_CORIOLIS)) {
+        outward += fixedMul(coriolisSignFlip * 2 * omega, speed);
+    }
+    if (outward < 0) {
+        wake(CONTACT_WAKE_LIFT_OFF);
+        return false;
+    }
+    
+    // Tangential forces: gravity and drag
+    Fixed along = fixedMul(gravityY, ux) - fixedMul(gravityX, uy);
+    Fixed absSpeed = speed >= 0 ? speed : -speed;
+    if (hasFeature<STEP_RUNTIME>(STEP_AIR_DRAG) && absSpeed > FIXED_DRAG_SPEED) {
+        if (hasFeature<STEP_RUNTIME>(STEP_QUADRATIC_DRAG)) {
+            along -= fixedMul(fixedMul(fixedFromFloat(ball.dragFactor), absSpeed), speed);
+        } else {
+            speed = fixedMul(speed, fixedDamping(fixedMul(fixedFromFloat(LINEAR_DRAG), dt)));
+        }
+    }
+    speed += fixedMul(along, dt);
+    
+    // Along the tangent, then back onto the arc
+    auto moveAlong = [&fixedBall, rc](Fixed distance) {
+        Fixed x = fixedBall.x - fixedMul(distance, fixedDiv(fixedBall.y, rc));
+        Fixed y = fixedBall.y + fixedMul(distance, fixedDiv(fixedBall.x, rc));
+        Fixed scale = fixedDiv(rc, fixedHypot(x, y));
+        fixedBall.x = fixedMul(x, scale);
+        fixedBall.y = fixedMul(y, scale);
+    };
+    auto setVelocity = [&fixedBall, rc](Fixed speed) {
+        fixedBall.vx = -fixedMul(fixedDiv(fixedBall.y, rc), speed);
+        fixedBall.vy = fixedMul(fixedDiv(fixedBall.x, rc), speed);
+    };
+    moveAlong(fixedMul(speed, dt));
+    setVelocity(speed);
+    
+    // Into one of the two vanes either side: slowly, it rests in the
+    // corner; faster, it wakes and bounces off
+    Fixed innerRadius = drum - fixedMul(drum, fixedFromFloat(vaneHeight));
+    for (int side = 0; side < 2; side++) {
+        int vane = (contactSegment + side) % vaneCount;
+        const int32_t dx = activeGeometry().fixedVaneCos[vane];
+        const int32_t dy = activeGeometry().fixedVaneSin[vane];
+        Fixed cross = fixedMulTrig(fixedBall.y, dx) - fixedMulTrig(fixedBall.x, dy);
+        Fixed inside = side == 0 ? cross : -cross;     // distance from the vane
+        Fixed outAlong = fixedMulTrig(fixedBall.x, dx) + fixedMulTrig(fixedBall.y, dy);
+        if (outAlong < innerRadius || inside >= radius) continue;
+        
+        Fixed into = side == 0 ? -speed : speed;
+        if (into >= FIXED_RESTING_SPEED) {
+            wake(CONTACT_WAKE_VANE);
+            fixedVaneCollision(vane, fixedBall, innerRadius, drum, radius, fixedFromFloat(ball.bounce));
+            return true;
+        }
+        
+        // Back out of the vane along the tangent, and stop against it
+        moveAlong(side == 0 ? radius - inside : inside - radius);
+        if (into > 0) {
+            speed = 0;
+        }
+        setVelocity(speed);
+    }
+    
+    debugInfo.totalVelocity = fixedToFloat(speed >= 0 ? speed : -speed);
+    contactStats.rollingSteps++;
+    return true;
+}
+
+// sleepOnWall() in Q16.16
+void DryerPhysics::fixedSleepOnWall(FixedBall& fixedBall) {
+    // Keep only the tangential velocity
+    Fixed dist = fixedHypot(fixedBall.x, fixedBall.y);
+    Fixed ux = fixedDiv(fixedBall.x, dist);
+    Fixed uy = fixedDiv(fixedBall.y, dist);
+    Fixed vn = fixedMul(fixedBall.vx, ux) + fixedMul(fixedBall.vy, uy);
+    fixedBall.vx -= fixedMul(vn, ux);
+    fixedBall.vy -= fixedMul(vn, uy);
+    
+    contactState = CONTACT_ROLLING;
+    contactSegment = fixedWallSegment(fixedBall);
+    restingSteps = 0;
+    contactStats.sleeps++;
+}
+
+void DryerPhysics::storeFixedBall(const FixedBall& fixedBall) {
+    ball.x = fixedToFloat(fixedBall.x);
+    ball.y = fixedToFloat(fixedBall.y);
+    ball.vx = fixedToFloat(fixedBall.vx);
+    ball.vy = fixedToFloat(fixedBall.vy);
+}
+
+// Drum segment the ball is in: between the vanes it is left of and right of
+int DryerPhysics::fixedWallSegment(const FixedBall& fixedBall) const {
+    const Parameters& geometry = activeGeometry();
+    int64_t previous = static_cast<int64_t>(geometry.fixedVaneCos[0]) * fixedBall.y -
+                       static_cast<int64_t>(geometry.fixedVaneSin[0]) * fixedBall.x;
+    for (int i = 0; i < vaneCount; i++) {
+        int next = (i + 1) % vaneCount;
+        int64_t cross = static_cast<int64_t>(geometry.fixedVaneCos[next]) * fixedBall.y -
+                        static_cast<int64_t>(geometry.fixedVaneSin[next]) * fixedBall.x;
+        if (previous >= 0 && cross < 0) return i;
+        previous = cross;
+    }
+    return 0;
+}
+
+// Vane i is radial, so the distance to it is the cross product with its
+// direction, signed: positive on the leading side. Returns the normal speed
+// into the vane if the ball touched it, -FIXED_ONE if not.
+Fixed DryerPhysics::fixedVaneCollision(int i, FixedBall& fixedBall, Fixed innerRadius, Fixed outerRadius,
+                                       Fixed radius, Fixed bounce) {
+    const int32_t dx = activeGeometry().fixedVaneCos[i];
+    const int32_t dy = activeGeometry().fixedVaneSin[i];
+    
+    Fixed along = fixedMulTrig(fixedBall.x, dx) + fixedMulTrig(fixedBall.y, dy);
+    if (along < innerRadius || along > outerRadius) return -FIXED_ONE;
+    Fixed side = fixedMulTrig(fixedBall.y, dx) - fixedMulTrig(fixedBall.x, dy);
+    Fixed dist = side >= 0 ? side : -side;
+    if (dist >= radius) return -FIXED_ONE;
+    
+    // Normal (Q2.30): across the vane, toward the ball
+    int32_t nx = side >= 0 ? -dy : dy;
+    int32_t ny = side >= 0 ? dx : -dx;
+    Fixed penetration = radius - dist;
+    fixedBall.x += fixedMulTrig(penetration, nx);
+    fixedBall.y += fixedMulTrig(penetration, ny);
+    
+    Fixed vn = fixedMulTrig(fixedBall.vx, nx) + fixedMulTrig(fixedBall.vy, ny);
+    if (vn < 0) {
+        Fixed impulse = fixedMul(bounce, vn);
+        fixedBall.vx -= fixedMulTrig(impulse, nx);
+        fixedBall.vy -= fixedMulTrig(impulse, ny);
+        
+        int slot = surfaceSlot(i, side > 0 ? SURFACE_VANE_LEADING : SURFACE_VANE_TRAILING);
+        if (slot < static_cast<int>(surfaces.size())) {
+            triggerCollision<STEP_RUNTIME>(surfaces[slot], fixedToFloat(-vn));
+        }
+    }
+    return vn < 0 ? -vn : vn;
+}
+
+void DryerPhysics::setFixedPoint(bool enabled) {
+    fixedPoint = enabled;
+    wake(CONTACT_WAKE_RESET);
+    selectStepKernel();
+}
+
+void DryerPhysics::setStepFeatures(unsigned features) {
+    enableCentrifugal = (features & STEP_CENTRIFUGAL) != 0;
+    enableCoriolis = (features & STEP_CORIOLIS) != 0;
+    enableAirDrag = (features & STEP_AIR_DRAG) != 0;
+    useQuadraticDrag = (features & STEP_QUADRATIC_DRAG) != 0;
+    lintTrapEnabled = (features & STEP_LINT_TRAP) != 0;
+    selectStepKernel();
+}
+
+void DryerPhysics::setBallState(float x, float y, float vx, float vy) {
+    wake(CONTACT_WAKE_RESET);
+    ball.x = x;
+    ball.y = y;
+    ball.vx = vx;
+    ball.vy = vy;
+}
+
+void DryerPhysics::setContactSleep(bool enabled) {
+    contactSleepEnabled = enabled;
+    if (!enabled) {
+        wake(CONTACT_WAKE_RESET);
+    }
+}
+
+void DryerPhysics::reportContacts(std::ostream& out, const DryerPhysics* drums, int count) {
+    static const char* WAKE_NAMES[CONTACT_WAKE_COUNT] = {"lift-off", "vane", "reset"};
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    
+    out << "=== Dryer Contact ===\n";
+    out << std::fixed << std::setprecision(1);
+    for (int drum = 0; drum < count; drum++) {
+        const ContactStats& stats = drums[drum].contactStats;
+        double resting = stats.steps > 0 ? 100.0 * stats.rollingSteps / stats.steps : 0.0;
+        out << "drum " << drum << ": " << resting << "% of steps resting, "
+            << stats.sleeps << " sleeps, wakes:";
+        for (int cause = 0; cause < CONTACT_WAKE_COUNT; cause++) {
+            out << " " << WAKE_NAMES[cause] << " " << stats.wakes[cause];
+        }
+        out << (drums[drum].contactState == CONTACT_ROLLING ? " (resting now)" : "") << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void DryerPhysics::setSpecializedStep(bool enabled) {
+    specializedStep = enabled;
+    selectStepKernel();
+}
+
 DryerPhysics::BallPosition DryerPhysics::getBallPosition(int canvasSize) const {
     float scale = canvasSize / (drumRadius * 2.2f);
     float centerX = canvasSize / 2.0f;
     float centerY = canvasSize / 2.0f;
     
     // Transform from rotating frame to screen coordinates
-    float cosAngle = std::cos(drumAngle);
-    float sinAngle = std::sin(drumAngle);
-    float screenX = ball.x * cosAngle - ball.y * sinAngle;
-    float screenY = ball.x * sinAngle + ball.y * cosAngle;
+    float screenX = ball.x * drumCos - ball.y * drumSin;
+    float screenY = ball.x * drumSin + ball.y * drumCos;
     
     BallPosition pos;
     pos.x = centerX + screenX * scale;
@@ -389,15 +1129,15 @@ DryerPhysics::BallPosition DryerPhysics::getBallPosition(int canvasSize) const {
     return pos;
 }
 
-std::vector<Vane> DryerPhysics::getVanePositions(int canvasSize) const {
+DryerPhysics::VaneList DryerPhysics::getVanePositions(int canvasSize) const {
     float scale = canvasSize / (drumRadius * 2.2f);
     float centerX = canvasSize / 2.0f;
     float centerY = canvasSize / 2.0f;
     float vaneInnerRadius = drumRadius * (1.0f - vaneHeight);
     
-    std::vector<Vane> vanes;
+    VaneList vanes;
     for (int i = 0; i < vaneCount; i++) {
-        float angle = (static_cast<float>(i) / vaneCount) * 2.0f * M_PI + drumAngle;
+        float angle = (static_cast<float>(i) / vaneCount) * 2.0f * M_PI + getDrumAngle();
         
         Vane vane;
         vane.innerX = centerX + vaneInnerRadius * std::cos(angle) * scale;
@@ -414,15 +1154,18 @@ std::vector<Vane> DryerPhysics::getVanePositions(int canvasSize) const {
 
 void DryerPhysics::toggleCoriolis(bool enable) {
     enableCoriolis = enable;
+    selectStepKernel();
     std::cout << "🌀 Coriolis: " << (enable ? "ON" : "OFF") << std::endl;
 }
 
 void DryerPhysics::toggleCentrifugal(bool enable) {
     enableCentrifugal = enable;
+    selectStepKernel();
     std::cout << "💫 Centrifugal: " << (enable ? "ON" : "OFF") << std::endl;
 }
 
 void DryerPhysics::toggleDrag(bool enable) {
     enableAirDrag = enable;
+    selectStepKernel();
     std::cout << "💨 Air drag: " << (enable ? "ON" : "OFF") << std::endl;
 }
@@ -5,18 +5,30 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <ostream>
 #include <cmath>
-#include <map>
+#include <utility>
+#include <algorithm>
+#include "dryer-balls.h"
+#include "dryer-fixed.h"
+#include "dryer-fixed-vector.h"
 
 // ============================================================================
 // DRYER PHYSICS ENGINE - C++ PORT
 // Custom rigid body physics for ball in rotating drum with vanes
 // ============================================================================
 
+enum SurfaceType {
+    SURFACE_DRUM,
+    SURFACE_VANE_LEADING,
+    SURFACE_VANE_TRAILING
+};
+
 struct Surface {
-    std::string type;       // "drum", "vane_leading", "vane_trailing"
-    std::string id;         // Unique identifier
+    SurfaceType type;       // Drum segment or vane edge
+    const char* id;         // Unique identifier ("drum_0", "vane_0_lead", ...)
     int index;              // Surface index for lookup
+    int slot;               // Position in getSurfaces(), for flat lookup tables
     uint32_t color;         // RGB color (0xRRGGBB)
 };
 
@@ -31,6 +43,11 @@ struct Ball {
     float restitution;      // Coefficient of restitution (0-1)
     float dragCoeff;        // Drag coefficient
     
+    // From the preset (see BallPreset)
+    float inverseMass;      // 1/kg
+    float bounce;           // 1 + restitution
+    float dragFactor;       // quadratic drag accel per v²
+    
     // Calculated property
     float area() const { return M_PI * radius * radius; }
 };
@@ -41,6 +58,37 @@ struct Vane {
     int index;              // Vane index
 };
 
+// Feature toggles the step kernel is specialized on (see setStepFeatures)
+enum StepFeature : unsigned {
+    STEP_CENTRIFUGAL    = 1u << 0,
+    STEP_CORIOLIS       = 1u << 1,
+    STEP_AIR_DRAG       = 1u << 2,
+    STEP_QUADRATIC_DRAG = 1u << 3,
+    STEP_LINT_TRAP      = 1u << 4,
+    STEP_FEATURE_COUNT  = 1u << 5   // number of feature masks
+};
+
+// Resting contact: the ball held against the drum wall slides along the
+// arc (CONTACT_ROLLING) instead of bouncing and being pushed back each step
+enum ContactState {
+    CONTACT_FREE,
+    CONTACT_ROLLING
+};
+
+enum ContactWake {
+    CONTACT_WAKE_LIFT_OFF,  // gravity/centrifugal no longer hold it on the wall
+    CONTACT_WAKE_VANE,      // a vane pushed it
+    CONTACT_WAKE_RESET,     // geometry, ball or reset
+    CONTACT_WAKE_COUNT
+};
+
+struct ContactStats {
+    uint64_t steps = 0;
+    uint64_t rollingSteps = 0;
+    uint64_t sleeps = 0;
+    uint64_t wakes[CONTACT_WAKE_COUNT] = {};
+};
+
 struct DebugInfo {
     float centrifugalMagnitude;
     float coriolisMagnitude;
@@ -50,25 +98,93 @@ struct DebugInfo {
 
 class DryerPhysics {
 public:
+    // Fixed capacities so per-frame and per-hit data never allocate
+    static constexpr int MAX_VANES = 16;
+    static constexpr int SURFACES_PER_VANE = 3;     // drum, leading, trailing
+    static constexpr int MAX_SURFACES = MAX_VANES * SURFACES_PER_VANE;
+    
+    using SurfaceList = FixedVector<Surface, MAX_SURFACES>;
+    using VaneList = FixedVector<Vane, MAX_VANES>;
+    
+    // Slot of a surface in getSurfaces(), valid while index < getVaneCount()
+    static int surfaceSlot(int index, SurfaceType type) {
+        return index * SURFACES_PER_VANE + type;
+    }
+    
+    // Speed and geometry as one value, with the vane direction tables the
+    // steps use built in. Built by setParameters() on the caller's thread.
+    struct Parameters {
+        float rpm;
+        float drumRadius;       // meters
+        int vaneCount;
+        float vaneHeight;       // fraction of radius
+        float vaneCos[MAX_VANES + 1];       // vane i at angle i/vaneCount turns,
+        float vaneSin[MAX_VANES + 1];       // up to i = vaneCount
+        int32_t fixedVaneCos[MAX_VANES];    // Q2.30, for the fixed-point step
+        int32_t fixedVaneSin[MAX_VANES];
+        
+        static Parameters make(float rpm, float drumSizeCm, int vaneCount, float vaneHeightPercent);
+    };
+    
     DryerPhysics();
     ~DryerPhysics() = default;
     
-    // Configuration
+    // Configuration. The new parameters are double-buffered and take over
+    // at the start of the next step (or reset), all at once; RPM, drum size
+    // and vane height then morph over getMorphTime(). A drum shrinking under
+    // the ball takes it along rather than leaving it outside the wall.
     void setParameters(float rpm, float drumSizeCm, int vaneCount, float vaneHeightPercent);
+    void setParameters(const Parameters& parameters);   // e.g. a stored preset
+    const Parameters& getParameters() const;            // latest set, applied or not
+    void setMorphTime(float seconds) { morphTime = std::max(seconds, 0.0f); }
+    float getMorphTime() const { return morphTime; }
+    
+    // CV modulation (DRYER_ADC): RPM and vane height only, cheap enough to
+    // call every step. Applies at once, morph or not.
+    void modulate(float rpm, float vaneHeightPercent);
     void setBallProperties(float radius, float mass, float restitution, float dragCoeff);
     
-    // Ball type presets
-    void setTennisBall();
-    void setBalloonBall();
+    // Ball type presets (dryer-balls.h); takes effect from the next step
+    void setBall(const BallPreset& preset);
     
     // Feature toggles
     void setLintTrap(bool enabled);
     void setMoonGravity(bool enabled);
     
+    // Clock sync: rotation speed is set from outside every step, and
+    // setParameters() only records the knob RPM (getRPM) as a fallback
+    void setExternalRotation(bool enabled) { externalRotation = enabled; }
+    void setAngularVelocity(float radiansPerSecond) { drumAngularVelocity = radiansPerSecond; }
+    
     // Physics simulation
-    void step(float dt);
+    void step(float dt) {
+        if (parametersPending || morphRemaining > 0.0f) applyParameters(dt, true);
+        (this->*stepKernel)(dt);
+    }
     void reset();
     
+    // Step kernel: one instantiation per feature mask, picked whenever a
+    // toggle changes, so the per-step code has no configuration branches.
+    // Runtime dispatch reads the toggles every step instead (dryer-bench).
+    void setStepFeatures(unsigned features);
+    unsigned getStepFeatures() const { return stepFeatures; }
+    void setSpecializedStep(bool enabled);
+    
+    // Integer Q16.16 step (dryer-fixed.h): the same hits, bit for bit, on
+    // the Pi and on x86, resting contact included. On by default in
+    // DRYER_FIXED_POINT builds.
+    void setFixedPoint(bool enabled);
+    bool isFixedPoint() const { return fixedPoint; }
+    
+    // Ball state set from outside (dryer-bench --diff), in the rotating frame
+    void setBallState(float x, float y, float vx, float vy);
+    
+    // Resting contact (on by default)
+    void setContactSleep(bool enabled);
+    ContactState getContactState() const { return contactState; }
+    const ContactStats& getContactStats() const { return contactStats; }
+    static void reportContacts(std::ostream& out, const DryerPhysics* drums, int count);
+    
     // Collision callback
     using CollisionCallback = std::function<void(const Surface&, float velocity)>;
     void onCollision(CollisionCallback callback);
@@ -79,12 +195,14 @@ public:
         float radius;
     };
     BallPosition getBallPosition(int canvasSize) const;
-    std::vector<Vane> getVanePositions(int canvasSize) const;
+    VaneList getVanePositions(int canvasSize) const;
     
     // Accessors
     const Ball& getBall() const { return ball; }
-    const std::vector<Surface>& getSurfaces() const { return surfaces; }
-    float getDrumAngle() const { return drumAngle; }
+    const SurfaceList& getSurfaces() const { return surfaces; }
+    float getDrumAngle() const { return static_cast<float>(drumPhase * RADIANS_PER_PHASE); }  // [0, 2π)
+    float getAngularVelocity() const { return drumAngularVelocity; }
+    float getRPM() const { return rpm; }
     float getDrumRadius() const { return drumRadius; }
     int getVaneCount() const { return vaneCount; }
     float getVaneHeight() const { return vaneHeight; }
@@ -96,12 +214,28 @@ public:
     void toggleDrag(bool enable);
     
 private:
-    // Parameters
+    // Parameters in effect this step (mid-morph: between two snapshots)
     float rpm;
     float drumRadius;       // meters
     int vaneCount;
     float vaneHeight;       // fraction of radius
     
+    // Snapshots: the active one, and the other written by setParameters()
+    // and swapped in at the next step
+    Parameters parameterBuffers[2];
+    int activeParameters;
+    bool parametersPending;
+    bool parametersApplied;     // false until the first swap, which never morphs
+    float morphTime;            // seconds
+    float morphRemaining;
+    float morphFromRpm, morphFromRadius, morphFromHeight;
+    
+    // Arguments of the last setParameters() call, for its change check: the
+    // snapshots carry CV-modulated RPM and height (modulate), so they can't
+    // be compared with knob values. requestedVanes -1: none since a preset.
+    float requestedRpm, requestedDrumSize, requestedHeight;
+    int requestedVanes;
+    
     // Ball
     Ball ball;
     
@@ -109,17 +243,27 @@ private:
     float gravity;
     float earthGravity;
     float moonGravity;
-    float airDensity;       // kg/m³
     
     // Feature toggles
     bool lintTrapEnabled;
     float lintTrapThreshold;
     bool moonGravityEnabled;
-    bool useQuadraticDrag;
+    bool useQuadraticDrag;  // from the ball preset
+    static constexpr float LINEAR_DRAG = 0.1f;      // 1/s
+    float linearDragDt;     // step size linearDamping was worked out for
+    float linearDamping;
     
-    // Drum rotation
-    float drumAngle;        // radians
+    // Drum rotation: the phase wraps instead of growing, and the rotation
+    // is carried as a unit complex number advanced by multiplication
+    static constexpr double RADIANS_PER_PHASE = 2.0 * M_PI / 4294967296.0;
+    static constexpr int ROTATION_RESYNC_STEPS = 1024;  // re-derive cos/sin from the phase
+    uint32_t drumPhase;     // 2^32 per revolution
+    float drumCos, drumSin; // cos/sin of the phase
+    float stepDelta;        // angle of the cached per-step rotation
+    float stepCos, stepSin;
+    int rotationSteps;      // since the last resync
     float drumAngularVelocity;  // rad/s
+    bool externalRotation;      // clock sync owns drumAngularVelocity
     
     // Physics effect toggles
     bool enableCoriolis;
@@ -128,19 +272,67 @@ private:
     int coriolisSignFlip;
     
     // Surface tracking
-    std::vector<Surface> surfaces;
-    std::string lastCollisionSurface;
+    SurfaceList surfaces;
+    int lastCollisionSlot;      // debounce, -1 = none
     std::vector<CollisionCallback> collisionCallbacks;
     
+    // Resting contact: this many steps in a row on the wall, each slower
+    // into it than the lint trap threshold, puts the ball to sleep
+    static constexpr float RESTING_SPEED = 0.15f;   // m/s
+    static constexpr int RESTING_STEPS = 8;
+    bool contactSleepEnabled;
+    ContactState contactState;
+    int contactSegment;     // drum segment it rests in
+    float contactVaneX[2];  // unit directions of the vanes either side
+    float contactVaneY[2];
+    int restingSteps;
+    ContactStats contactStats;
+    
     // Debug
     DebugInfo debugInfo;
     
+    // Step dispatch
+    using StepKernel = void (DryerPhysics::*)(float dt);
+    static constexpr unsigned STEP_RUNTIME = STEP_FEATURE_COUNT;    // kernel reads the toggles
+    StepKernel stepKernel;
+    unsigned stepFeatures;
+    bool specializedStep;
+    bool fixedPoint;
+    
+    // Ball during a fixed-point step
+    struct FixedBall {
+        Fixed x, y;
+        Fixed vx, vy;
+    };
+    
     // Private methods
     void updateSurfaces();
     uint32_t getSurfaceColor(int index) const;
-    void handleCollisions();
-    void checkVaneCollisions();
-    void triggerCollision(const Surface& surface, float velocity);
+    void applyBall(const BallPreset& preset);
+    void applyParameters(float dt, bool morph);
+    const Parameters& activeGeometry() const { return parameterBuffers[activeParameters]; }
+    void selectStepKernel();
+    void advanceRotation(float dt);
+    void syncRotation();
+    template<unsigned Features> bool hasFeature(unsigned feature) const;
+    template<unsigned Features> void stepKernelImpl(float dt);
+    float linearDampingFor(float dt);
+    template<unsigned Features> bool stepRolling(float dt, float gravityX, float gravityY);
+    int wallSegment() const;
+    void sleepOnWall();
+    void wake(ContactWake cause);
+    template<unsigned Features> void handleCollisions();
+    template<unsigned Features> float checkVaneCollisions();
+    template<unsigned Features> float checkVaneCollision(int i);
+    template<unsigned Features> void triggerCollision(const Surface& surface, float velocity);
+    template<unsigned... Masks> static const StepKernel* stepKernelTable(std::integer_sequence<unsigned, Masks...>);
+    void stepFixed(float dt);
+    bool fixedStepRolling(FixedBall& fixedBall, Fixed dt, Fixed omega, Fixed gravityX, Fixed gravityY);
+    void fixedSleepOnWall(FixedBall& fixedBall);
+    void storeFixedBall(const FixedBall& fixedBall);
+    int fixedWallSegment(const FixedBall& fixedBall) const;
+    Fixed fixedVaneCollision(int i, FixedBall& fixedBall, Fixed innerRadius, Fixed outerRadius,
+                             Fixed radius, Fixed bounce);
 };
 
 #endif // DRYER_PHYSICS_H
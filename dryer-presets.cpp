@@ -0,0 +1,112 @@
+#include "dryer-presets.h"
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+// A knob this far from where it was at the recall (fraction of its range)
+// has been turned; less is ADC noise
+static const float KNOB_TAKEOVER = 0.02f;
+
+static bool knobMoved(float now, float then, float min, float max) {
+    return std::abs(now - then) > KNOB_TAKEOVER * (max - min);
+}
+
+ParameterPresets::ParameterPresets()
+    : count(0)
+    , held(false)
+    , heldKnobs{}
+{
+}
+
+void ParameterPresets::loadFromEnvironment(const DrumGroup& drums) {
+    if (const char* path = std::getenv("DRYER_PRESETS")) {
+        if (loadFile(path, drums)) {
+            std::cout << "Presets: " << count << " (kill -USR2 recalls the next)" << std::endl;
+        }
+    }
+}
+
+bool ParameterPresets::loadFile(const char* path, const DrumGroup& drums) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        std::cerr << "WARNING: cannot open presets " << path << std::endl;
+        return false;
+    }
+
+    char line[128];
+    int lineNumber = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        if (char* comment = std::strchr(line, '#')) {
+            *comment = '\0';
+        }
+
+        // name rpm drum_cm vanes vane_height_percent
+        char name[16];
+        float rpm, drumSize, vaneHeight;
+        int vanes;
+        int fields = std::sscanf(line, "%15s %f %f %d %f", name, &rpm, &drumSize, &vanes, &vaneHeight);
+        if (fields <= 0) continue;
+
+        if (fields < 5 || rpm < 0.0f || drumSize <= 0.0f || vanes < ParamRanges::VANES_MIN ||
+            vanes > DryerPhysics::MAX_VANES || vaneHeight <= 0.0f || vaneHeight >= 100.0f) {
+            std::cerr << "WARNING: " << path << ":" << lineNumber << ": bad preset" << std::endl;
+            continue;
+        }
+        if (count >= MAX_PRESETS) {
+            std::cerr << "WARNING: " << path << ":" << lineNumber << ": more than "
+                      << MAX_PRESETS << " presets, ignoring the rest" << std::endl;
+            break;
+        }
+        store(count, name, rpm, drumSize, vanes, vaneHeight, drums);
+    }
+    std::fclose(file);
+    return count > 0;
+}
+
+bool ParameterPresets::store(int slot, const char* name, float rpm, float drumSizeCm, int vanes,
+                             float vaneHeightPercent, const DrumGroup& drums) {
+    if (slot < 0 || slot > count || slot >= MAX_PRESETS) return false;
+
+    // The mapping updateParameters() gives the knobs; the vane tables are
+    // built here, not on the physics thread
+    Preset& preset = presets[slot];
+    std::snprintf(preset.name, sizeof(preset.name), "%s", name);
+    for (int i = 0; i < drums.size(); i++) {
+        const DrumConfig& config = drums.getConfig(i);
+        preset.drums[i] = DryerPhysics::Parameters::make(rpm * config.rpmRatio, drumSizeCm,
+                                                         config.vanes > 0 ? config.vanes : vanes,
+                                                         vaneHeightPercent);
+    }
+    if (slot == count) {
+        count++;
+    }
+    return true;
+}
+
+bool ParameterPresets::recall(int slot, DrumGroup& drums, const HardwareParameters& knobs) {
+    if (slot < 0 || slot >= count) return false;
+
+    for (int i = 0; i < drums.size(); i++) {
+        drums.drum(i).setParameters(presets[slot].drums[i]);
+    }
+    held = true;
+    heldKnobs = knobs;
+    std::cout << "Preset " << slot + 1 << ": " << presets[slot].name << std::endl;
+    return true;
+}
+
+bool ParameterPresets::holding(const HardwareParameters& knobs) {
+    if (!held) return false;
+
+    if (knobMoved(knobs.rpm, heldKnobs.rpm, ParamRanges::RPM_MIN, ParamRanges::RPM_MAX) ||
+        knobMoved(knobs.drumSize, heldKnobs.drumSize, ParamRanges::DRUM_SIZE_MIN, ParamRanges::DRUM_SIZE_MAX) ||
+        knobMoved(knobs.vaneHeight, heldKnobs.vaneHeight, ParamRanges::VANE_HEIGHT_MIN,
+                  ParamRanges::VANE_HEIGHT_MAX) ||
+        knobs.vanes != heldKnobs.vanes) {
+        held = false;
+    }
+    return held;
+}
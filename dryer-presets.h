@@ -0,0 +1,55 @@
+#ifndef DRYER_PRESETS_H
+#define DRYER_PRESETS_H
+
+#include "dryer-drums.h"
+#include "dryer-hardware.h"
+
+// ============================================================================
+// DRYER PRESETS - Stored drum settings, recalled with kill -USR2
+//   DRYER_PRESETS=/etc/dryer/presets.txt   one preset per line:
+//       name rpm drum_cm vanes vane_height_percent
+//     e.g. "slow-big 8 100 3 45"; '#' starts a comment
+//
+// Each preset is kept as one parameter snapshot per drum, vane tables
+// included, so a recall is a copy; the drums swap it in at their next step
+// and morph to it (DryerPhysics::setMorphTime). A recalled preset holds
+// against the knobs until one of them is turned.
+// ============================================================================
+
+class ParameterPresets {
+public:
+    static constexpr int MAX_PRESETS = 8;
+
+    ParameterPresets();
+
+    // After DrumGroup::loadFromEnvironment: presets are per-drum snapshots
+    void loadFromEnvironment(const DrumGroup& drums);
+    bool loadFile(const char* path, const DrumGroup& drums);
+    int size() const { return count; }
+
+    // Knob-style settings into a slot (the drums' RPM ratios and vane
+    // counts applied), and from a slot into every drum
+    bool store(int slot, const char* name, float rpm, float drumSizeCm, int vanes, float vaneHeightPercent,
+               const DrumGroup& drums);
+    bool recall(int slot, DrumGroup& drums, const HardwareParameters& knobs);
+
+    // Whether a recalled preset still overrides the knobs; false for good
+    // once one has moved from where it was at the recall
+    bool holding(const HardwareParameters& knobs);
+
+    // The same, as of the last holding() call; also gates CV modulation
+    bool isHolding() const { return held; }
+
+private:
+    struct Preset {
+        char name[16];
+        DryerPhysics::Parameters drums[MAX_DRUMS];
+    };
+
+    Preset presets[MAX_PRESETS];
+    int count;
+    bool held;
+    HardwareParameters heldKnobs;
+};
+
+#endif // DRYER_PRESETS_H
@@ -0,0 +1,101 @@
+#include "dryer-quantize.h"
+#include "dryer-latency.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+static const int DEFAULT_DIVISION = 16;
+static const double DEFAULT_BPM = 120.0;
+static const uint64_t DEFAULT_LOOKAHEAD_MS = 50;
+static const uint64_t MAX_LOOKAHEAD_MS = 500;
+
+Quantizer::Quantizer()
+    : division(0)
+    , bpm(DEFAULT_BPM)
+    , swing(0.5)
+    , strength(1.0)
+    , lookaheadNs(DEFAULT_LOOKAHEAD_MS * 1000000ULL)
+    , epochNs(0)
+    , eventsQuantized(0)
+    , eventsLate(0)
+{
+}
+
+void Quantizer::loadFromEnvironment() {
+    const char* value = std::getenv("DRYER_QUANTIZE");
+    if (!value || !value[0]) return;
+
+    division = std::atoi(value);
+    if (division == 1) {
+        division = DEFAULT_DIVISION;    // DRYER_QUANTIZE=1: just switch it on
+    }
+    if (division < 0 || division > 64) {
+        std::cerr << "WARNING: ignoring DRYER_QUANTIZE=" << value << std::endl;
+        division = 0;
+    }
+    if (division == 0) return;
+
+    if (const char* text = std::getenv("DRYER_QUANTIZE_BPM")) {
+        double parsed = std::atof(text);
+        if (parsed >= 20.0 && parsed <= 300.0) {
+            bpm = parsed;
+        }
+    }
+    if (const char* text = std::getenv("DRYER_QUANTIZE_SWING")) {
+        swing = std::clamp(std::atof(text), 50.0, 75.0) / 100.0;
+    }
+    if (const char* text = std::getenv("DRYER_QUANTIZE_STRENGTH")) {
+        strength = std::clamp(std::atof(text), 0.0, 100.0) / 100.0;
+    }
+    if (const char* text = std::getenv("DRYER_LOOKAHEAD_MS")) {
+        uint64_t ms = std::min<uint64_t>(std::strtoull(text, nullptr, 10), MAX_LOOKAHEAD_MS);
+        lookaheadNs = ms * 1000000ULL;
+    }
+    epochNs = latencyNowNs();
+
+    std::cout << "Quantize: 1/" << division << " at " << bpm << " BPM, swing " << swing * 100.0
+              << "%, strength " << strength * 100.0 << "%, lookahead "
+              << lookaheadNs / 1000000ULL << " ms" << std::endl;
+}
+
+uint64_t Quantizer::quantize(uint64_t eventNs, uint64_t earliestNs, const ClockState& clock) {
+    // Beat position of the hit
+    double beatNs;
+    double beats;
+    if (clock.locked) {
+        beatNs = clock.beatNs;
+        beats = clock.refBeat + static_cast<double>(static_cast<int64_t>(eventNs - clock.refNs)) / beatNs;
+    } else {
+        beatNs = 60e9 / bpm;
+        beats = static_cast<double>(static_cast<int64_t>(eventNs - epochNs)) / beatNs;
+    }
+
+    // Grid lines come in pairs; swing pushes the second one of each pair later
+    double slot = 4.0 / division;
+    double pairStart = std::floor(beats / (2.0 * slot)) * 2.0 * slot;
+    double offBeat = pairStart + 2.0 * swing * slot;
+    double nextPair = pairStart + 2.0 * slot;
+
+    double target = pairStart;
+    if (std::fabs(offBeat - beats) < std::fabs(target - beats)) target = offBeat;
+    if (std::fabs(nextPair - beats) < std::fabs(target - beats)) target = nextPair;
+
+    double shiftNs = strength * (target - beats) * beatNs;
+    int64_t dueNs = static_cast<int64_t>(eventNs) + static_cast<int64_t>(std::llround(shiftNs));
+
+    eventsQuantized.fetch_add(1, std::memory_order_relaxed);
+    if (dueNs < static_cast<int64_t>(earliestNs)) {
+        eventsLate.fetch_add(1, std::memory_order_relaxed);
+        return earliestNs;
+    }
+    return static_cast<uint64_t>(dueNs);
+}
+
+void Quantizer::report(std::ostream& out) const {
+    out << "=== Dryer quantize ===\n";
+    out << "grid: 1/" << division << ", lookahead " << lookaheadNs / 1000000ULL << " ms\n";
+    out << "events: " << eventsQuantized.load(std::memory_order_relaxed) << " quantized, "
+        << eventsLate.load(std::memory_order_relaxed) << " past their grid line\n";
+}
@@ -0,0 +1,49 @@
+#ifndef DRYER_QUANTIZE_H
+#define DRYER_QUANTIZE_H
+
+#include "dryer-clock.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// ============================================================================
+// DRYER QUANTIZE - Snap collisions to a tempo grid
+//   DRYER_QUANTIZE=16              grid in notes per bar: 4, 8, 16, 32 (0 = off)
+//   DRYER_QUANTIZE_BPM=120         grid tempo; the clock's when DRYER_CLOCK locks
+//   DRYER_QUANTIZE_SWING=50        percent: 50 straight, 66 triplet, up to 75
+//   DRYER_QUANTIZE_STRENGTH=100    percent of the way to the grid line
+//   DRYER_LOOKAHEAD_MS=50          how far physics runs ahead of the outputs
+//
+// Physics runs the lookahead ahead of real time, so a hit is known before
+// it is due and can be moved earlier as well as later. The output thread
+// then plays it at the quantized time.
+// ============================================================================
+
+class Quantizer {
+public:
+    Quantizer();
+
+    void loadFromEnvironment();
+    bool isEnabled() const { return division > 0; }
+    uint64_t getLookaheadNs() const { return isEnabled() ? lookaheadNs : 0; }
+
+    // When a hit at eventNs should sound: the nearest grid line, pulled in
+    // by strength, no earlier than earliestNs. Uses the clock's beat phase
+    // when it is locked, the free-running grid otherwise. Physics thread.
+    uint64_t quantize(uint64_t eventNs, uint64_t earliestNs, const ClockState& clock);
+
+    void report(std::ostream& out) const;
+
+private:
+    int division;               // grid lines per 4 beats
+    double bpm;
+    double swing;               // 0.5 .. 0.75
+    double strength;            // 0 .. 1
+    uint64_t lookaheadNs;
+    uint64_t epochNs;           // beat 0 of the free-running grid
+
+    std::atomic<uint64_t> eventsQuantized;
+    std::atomic<uint64_t> eventsLate;       // grid line already past: played at once
+};
+
+#endif // DRYER_QUANTIZE_H
@@ -0,0 +1,211 @@
+#include "dryer-rasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+// Coverage rule: pixel (x, y) is drawn when its centre (x + 0.5, y + 0.5)
+// lies inside the triangle. Left edges are inclusive, right edges and the
+// bottom row exclusive, and every edge is evaluated from its endpoints in a
+// fixed order, so triangles sharing an edge never overlap or leave gaps.
+// That matters here: strokes are translucent, a double-blended seam shows.
+
+static inline int clampChannel(float value) {
+    int v = static_cast<int>(value + 0.5f);
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static inline uint32_t blendPixel(uint32_t dst, int r, int g, int b, int a) {
+    int inv = 255 - a;
+    int dr = (dst >> 16) & 0xFF;
+    int dg = (dst >> 8) & 0xFF;
+    int db = dst & 0xFF;
+    r = (r * a + dr * inv) / 255;
+    g = (g * a + dg * inv) / 255;
+    b = (b * a + db * inv) / 255;
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+SoftwareRasterizer::SoftwareRasterizer() {
+    target.pixels = nullptr;
+    target.width = 0;
+    target.height = 0;
+    target.stride = 0;
+}
+
+void SoftwareRasterizer::fillRect(const PixelRect& rect, uint32_t color) {
+    int x0 = std::max(rect.x0, 0);
+    int y0 = std::max(rect.y0, 0);
+    int x1 = std::min(rect.x1, target.width);
+    int y1 = std::min(rect.y1, target.height);
+    if (x0 >= x1 || y0 >= y1 || !target.pixels) return;
+
+    uint32_t pixel = 0xFF000000u | color;
+    for (int y = y0; y < y1; y++) {
+        std::fill_n(target.pixels + y * target.stride + x0, x1 - x0, pixel);
+    }
+}
+
+void SoftwareRasterizer::copyRect(const PixelRect& rect, const Framebuffer& source) {
+    int x0 = std::max(rect.x0, 0);
+    int y0 = std::max(rect.y0, 0);
+    int x1 = std::min(rect.x1, std::min(target.width, source.width));
+    int y1 = std::min(rect.y1, std::min(target.height, source.height));
+    if (x0 >= x1 || y0 >= y1 || !target.pixels || !source.pixels) return;
+
+    for (int y = y0; y < y1; y++) {
+        const uint32_t* from = source.pixels + y * source.stride + x0;
+        std::copy(from, from + (x1 - x0), target.pixels + y * target.stride + x0);
+    }
+}
+
+void SoftwareRasterizer::drawTriangles(const SDL_Vertex* vertices, const int* indices,
+                                       int indexCount, const PixelRect& clip) {
+    if (!target.pixels) return;
+
+    PixelRect bounds;
+    bounds.x0 = std::max(clip.x0, 0);
+    bounds.y0 = std::max(clip.y0, 0);
+    bounds.x1 = std::min(clip.x1, target.width);
+    bounds.y1 = std::min(clip.y1, target.height);
+    if (bounds.empty()) return;
+
+    for (int i = 0; i + 2 < indexCount; i += 3) {
+        drawTriangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], bounds);
+    }
+}
+
+namespace {
+
+    // One triangle edge as seen from a scanline
+    struct Edge {
+        float x0, y0;       // endpoint with smaller (y, x)
+        float dxdy;
+        bool horizontal;
+        bool leftBound;     // interior lies to the right
+
+        Edge(const SDL_FPoint& p, const SDL_FPoint& q, const SDL_FPoint& other) {
+            const SDL_FPoint* a = &p;
+            const SDL_FPoint* b = &q;
+            if (a->y > b->y || (a->y == b->y && a->x > b->x)) {
+                std::swap(a, b);
+            }
+            x0 = a->x;
+            y0 = a->y;
+            horizontal = (a->y == b->y);
+            dxdy = horizontal ? 0.0f : (b->x - a->x) / (b->y - a->y);
+
+            float cross = (b->x - a->x) * (other.y - a->y) - (b->y - a->y) * (other.x - a->x);
+            leftBound = cross < 0.0f;
+        }
+
+        float xAt(float y) const { return x0 + (y - y0) * dxdy; }
+    };
+
+}
+
+void SoftwareRasterizer::drawTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c,
+                                      const PixelRect& clip) {
+    // Fully transparent (feather fringes meeting): nothing to do
+    if (a.color.a == 0 && b.color.a == 0 && c.color.a == 0) return;
+
+    float minX = std::min(a.position.x, std::min(b.position.x, c.position.x));
+    float maxX = std::max(a.position.x, std::max(b.position.x, c.position.x));
+    float minY = std::min(a.position.y, std::min(b.position.y, c.position.y));
+    float maxY = std::max(a.position.y, std::max(b.position.y, c.position.y));
+
+    // Rows whose centre is in [minY, maxY)
+    int rowStart = std::max(clip.y0, static_cast<int>(std::ceil(minY - 0.5f)));
+    int rowEnd = std::min(clip.y1, static_cast<int>(std::ceil(maxY - 0.5f)));
+    if (rowStart >= rowEnd) return;
+    if (std::ceil(maxX - 0.5f) <= clip.x0 || std::ceil(minX - 0.5f) >= clip.x1) return;
+
+    float abx = b.position.x - a.position.x;
+    float aby = b.position.y - a.position.y;
+    float acx = c.position.x - a.position.x;
+    float acy = c.position.y - a.position.y;
+    float area = abx * acy - aby * acx;
+    if (std::fabs(area) < 1e-6f) return;
+
+    Edge edges[3] = {
+        Edge(a.position, b.position, c.position),
+        Edge(b.position, c.position, a.position),
+        Edge(c.position, a.position, b.position)
+    };
+
+    // Colour as a plane over the triangle: value at a plus x/y gradients
+    const SDL_Color* colors[3] = {&a.color, &b.color, &c.color};
+    float channel[3][4];
+    for (int v = 0; v < 3; v++) {
+        channel[v][0] = colors[v]->r;
+        channel[v][1] = colors[v]->g;
+        channel[v][2] = colors[v]->b;
+        channel[v][3] = colors[v]->a;
+    }
+    const float* base = channel[0];
+    float toB[4];
+    float toC[4];
+    float ddx[4];
+    float ddy[4];
+    bool flat = true;
+    for (int k = 0; k < 4; k++) {
+        toB[k] = channel[1][k] - base[k];
+        toC[k] = channel[2][k] - base[k];
+        ddx[k] = (toB[k] * acy - toC[k] * aby) / area;
+        ddy[k] = (toC[k] * abx - toB[k] * acx) / area;
+        if (toB[k] != 0.0f || toC[k] != 0.0f) flat = false;
+    }
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        float py = y + 0.5f;
+        float lo = -1e30f;
+        float hi = 1e30f;
+
+        for (const Edge& edge : edges) {
+            if (edge.horizontal) continue;  // handled by the row range
+            float x = edge.xAt(py);
+            if (edge.leftBound) {
+                lo = std::max(lo, x);
+            } else {
+                hi = std::min(hi, x);
+            }
+        }
+
+        int spanStart = std::max(clip.x0, static_cast<int>(std::ceil(std::max(lo, -1e6f) - 0.5f)));
+        int spanEnd = std::min(clip.x1, static_cast<int>(std::ceil(std::min(hi, 1e6f) - 0.5f)));
+        if (spanStart >= spanEnd) continue;
+
+        uint32_t* row = target.pixels + y * target.stride;
+
+        if (flat) {
+            int r = a.color.r;
+            int g = a.color.g;
+            int bl = a.color.b;
+            int al = a.color.a;
+            if (al == 255) {
+                std::fill(row + spanStart, row + spanEnd, 0xFF000000u | (r << 16) | (g << 8) | bl);
+            } else {
+                for (int x = spanStart; x < spanEnd; x++) {
+                    row[x] = blendPixel(row[x], r, g, bl, al);
+                }
+            }
+            continue;
+        }
+
+        // Gouraud: step the colour plane along the span
+        float px = spanStart + 0.5f;
+        float value[4];
+        for (int k = 0; k < 4; k++) {
+            value[k] = base[k] + ddx[k] * (px - a.position.x) + ddy[k] * (py - a.position.y);
+        }
+
+        for (int x = spanStart; x < spanEnd; x++) {
+            int al = clampChannel(value[3]);
+            if (al > 0) {
+                row[x] = blendPixel(row[x], clampChannel(value[0]), clampChannel(value[1]),
+                                    clampChannel(value[2]), al);
+            }
+            for (int k = 0; k < 4; k++) {
+                value[k] += ddx[k];
+            }
+        }
+    }
+}
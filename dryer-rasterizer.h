@@ -0,0 +1,50 @@
+#ifndef DRYER_RASTERIZER_H
+#define DRYER_RASTERIZER_H
+
+#include "dryer-framebuffer.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// ============================================================================
+// DRYER RASTERIZER - Span-based software triangle rasterizer
+// Draws the same GeometryBuilder batch the SDL path submits, straight into a
+// 32bpp framebuffer: exact per-row spans from the edge equations, Gouraud
+// colour and alpha, src-over blending onto an opaque background.
+// ============================================================================
+
+// Half-open pixel rectangle [x0, x1) x [y0, y1)
+struct PixelRect {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    int area() const { return empty() ? 0 : (x1 - x0) * (y1 - y0); }
+};
+
+class SoftwareRasterizer {
+public:
+    SoftwareRasterizer();
+
+    void setTarget(const Framebuffer& framebuffer) { target = framebuffer; }
+    const Framebuffer& getTarget() const { return target; }
+
+    // Opaque fill, color is 0xRRGGBB
+    void fillRect(const PixelRect& rect, uint32_t color);
+
+    // Copy the same rectangle from another buffer of at least the same size
+    void copyRect(const PixelRect& rect, const Framebuffer& source);
+
+    // Indexed triangle list, clipped to clip (and the target)
+    void drawTriangles(const SDL_Vertex* vertices, const int* indices, int indexCount,
+                       const PixelRect& clip);
+
+private:
+    Framebuffer target;
+
+    void drawTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c,
+                      const PixelRect& clip);
+};
+
+#endif // DRYER_RASTERIZER_H
@@ -0,0 +1,271 @@
+#include "dryer-realtime.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <alloca.h>
+#include <sched.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+static const char* ROLE_NAMES[THREAD_ROLE_COUNT] = {
+    "physics", "output", "render", "control", "clock", "adc", "drum1", "drum2", "drum3"
+};
+
+static const char* ROLE_ENV[THREAD_ROLE_COUNT] = {
+    "DRYER_RT_PHYSICS", "DRYER_RT_OUTPUT", "DRYER_RT_RENDER", "DRYER_RT_CONTROL",
+    "DRYER_RT_CLOCK", "DRYER_RT_ADC", "DRYER_RT_DRUM1", "DRYER_RT_DRUM2", "DRYER_RT_DRUM3"
+};
+
+// ============================================================================
+// PiMutex
+// ============================================================================
+
+PiMutex::PiMutex() {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+PiMutex::~PiMutex() {
+    pthread_mutex_destroy(&mutex);
+}
+
+// ============================================================================
+// DryerRealtime
+// ============================================================================
+
+DryerRealtime::DryerRealtime()
+    : memoryLocked(false)
+{
+    config.enabled = true;
+    config.lockMemory = true;
+    config.stackPrefaultBytes = 256 * 1024;
+    config.heapPrefaultBytes = 8 * 1024 * 1024;
+
+    // Pi Zero 2W (4 cores): CPU0 keeps IRQs, kernel work and housekeeping,
+    // render gets CPU1, physics CPU2, output CPU3. Output outranks physics
+    // so a gate edge is never held up by a physics step.
+    //
+    // Sharing: clock sits with output on CPU3, ADC and drums 1 and 3 with
+    // housekeeping on CPU0, drum 2 with physics on CPU2. No FIFO thread runs
+    // on CPU1, where SCHED_OTHER render would only get what they leave.
+    config.threads[THREAD_PHYSICS] = {SCHED_FIFO, 70, 2};
+    config.threads[THREAD_OUTPUT]  = {SCHED_FIFO, 80, 3};
+    config.threads[THREAD_RENDER]  = {SCHED_OTHER, -5, 1};
+    config.threads[THREAD_CONTROL] = {SCHED_OTHER, 0, 0};
+
+    // Clock input shares the output core: it sleeps until a byte or edge
+    // arrives, and its timestamps are only as good as its wakeups
+    config.threads[THREAD_CLOCK]   = {SCHED_FIFO, 75, 3};
+
+    // CV sampling sits with the housekeeping on CPU0; FIFO so conversions
+    // are read back on time, below physics since it mostly sleeps
+    config.threads[THREAD_ADC]     = {SCHED_FIFO, 65, 0};
+
+    // Extra drums (only started in polyrhythm mode) run at physics priority,
+    // kept off the render core and the output/clock core. Drum 2 takes the
+    // physics core: physics steps drum 0 first and then sleeps at the
+    // barrier, so the two take turns rather than compete.
+    config.threads[THREAD_DRUM_1]  = {SCHED_FIFO, 70, 0};
+    config.threads[THREAD_DRUM_2]  = {SCHED_FIFO, 70, 2};
+    config.threads[THREAD_DRUM_3]  = {SCHED_FIFO, 70, 0};
+
+    for (auto& c : counters) {
+        c.active = false;
+        c.minorFaults = 0;
+        c.majorFaults = 0;
+        c.voluntarySwitches = 0;
+        c.involuntarySwitches = 0;
+        std::memset(c.baseline, 0, sizeof(c.baseline));
+    }
+}
+
+void DryerRealtime::loadFromEnvironment() {
+    const char* value = std::getenv("DRYER_RT");
+    if (value && std::strcmp(value, "0") == 0) {
+        config.enabled = false;
+    }
+
+    value = std::getenv("DRYER_RT_LOCK");
+    if (value && std::strcmp(value, "0") == 0) {
+        config.lockMemory = false;
+    }
+
+    for (int role = 0; role < THREAD_ROLE_COUNT; role++) {
+        value = std::getenv(ROLE_ENV[role]);
+        if (!value) continue;
+
+        // policy:priority:cpu
+        char policy[16] = {0};
+        int priority = 0;
+        int cpu = -1;
+        if (std::sscanf(value, "%15[a-z]:%d:%d", policy, &priority, &cpu) < 2) {
+            std::cerr << "WARNING: ignoring " << ROLE_ENV[role] << "=" << value << "\n";
+            continue;
+        }
+
+        ThreadRtSettings& settings = config.threads[role];
+        if (std::strcmp(policy, "fifo") == 0) {
+            settings.policy = SCHED_FIFO;
+        } else if (std::strcmp(policy, "rr") == 0) {
+            settings.policy = SCHED_RR;
+        } else {
+            settings.policy = SCHED_OTHER;
+        }
+        settings.priority = priority;
+        settings.cpu = cpu;
+    }
+}
+
+bool DryerRealtime::setupProcess() {
+    if (!config.enabled) {
+        std::cout << "Realtime: disabled\n";
+        return true;
+    }
+
+    bool ok = true;
+
+    // Keep freed memory in the process and never satisfy malloc with
+    // fresh mmap()s, so the prefaulted (and locked) heap gets reused
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (config.heapPrefaultBytes > 0) {
+        char* block = static_cast<char*>(std::malloc(config.heapPrefaultBytes));
+        if (block) {
+            long pageSize = sysconf(_SC_PAGESIZE);
+            for (size_t i = 0; i < config.heapPrefaultBytes; i += pageSize) {
+                block[i] = 0;
+            }
+            std::free(block);
+        }
+    }
+
+    if (config.lockMemory) {
+        int flags = MCL_CURRENT | MCL_FUTURE;
+#ifdef MCL_ONFAULT
+        // Only lock pages once touched; thread stacks and GPU mappings
+        // would otherwise pin far more than the Pi Zero can spare
+        flags |= MCL_ONFAULT;
+#endif
+        if (mlockall(flags) == 0) {
+            memoryLocked = true;
+        } else {
+            std::cerr << "WARNING: mlockall failed: " << std::strerror(errno) << "\n";
+            ok = false;
+        }
+    }
+
+    std::cout << "Realtime: memory " << (memoryLocked ? "locked" : "not locked")
+              << ", heap prefault " << (config.heapPrefaultBytes / 1024) << " KB\n";
+    return ok;
+}
+
+bool DryerRealtime::enterThread(ThreadRole role) {
+    pthread_setname_np(pthread_self(), (std::string("dryer-") + ROLE_NAMES[role]).c_str());
+
+    bool ok = true;
+
+    if (config.enabled) {
+        const ThreadRtSettings& settings = config.threads[role];
+
+        if (settings.policy == SCHED_FIFO || settings.policy == SCHED_RR) {
+            sched_param param;
+            param.sched_priority = settings.priority;
+            int err = pthread_setschedparam(pthread_self(), settings.policy, &param);
+            if (err != 0) {
+                std::cerr << "WARNING: " << ROLE_NAMES[role] << " RT priority "
+                          << settings.priority << " failed: " << std::strerror(err) << "\n";
+                ok = false;
+            }
+        } else if (settings.priority != 0) {
+            // Linux applies nice per thread (tid)
+            setpriority(PRIO_PROCESS, 0, settings.priority);
+        }
+
+        long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+        if (settings.cpu >= 0 && settings.cpu < cpuCount) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(settings.cpu, &set);
+            int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (err != 0) {
+                std::cerr << "WARNING: " << ROLE_NAMES[role] << " affinity to CPU "
+                          << settings.cpu << " failed: " << std::strerror(err) << "\n";
+                ok = false;
+            }
+        }
+
+        // Touch the stack we're going to use so it's resident (and locked)
+        if (config.stackPrefaultBytes > 0) {
+            volatile char* stack = static_cast<volatile char*>(alloca(config.stackPrefaultBytes));
+            long pageSize = sysconf(_SC_PAGESIZE);
+            for (size_t i = 0; i < config.stackPrefaultBytes; i += pageSize) {
+                stack[i] = 0;
+            }
+        }
+    }
+
+    // Counters start from here so startup faults don't hide steady-state ones
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    ThreadCounters& c = counters[role];
+    c.baseline[0] = usage.ru_minflt;
+    c.baseline[1] = usage.ru_majflt;
+    c.baseline[2] = usage.ru_nvcsw;
+    c.baseline[3] = usage.ru_nivcsw;
+    c.active = true;
+
+    return ok;
+}
+
+void DryerRealtime::sampleThread(ThreadRole role) {
+    rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) return;
+
+    ThreadCounters& c = counters[role];
+    c.minorFaults.store(usage.ru_minflt - c.baseline[0], std::memory_order_relaxed);
+    c.majorFaults.store(usage.ru_majflt - c.baseline[1], std::memory_order_relaxed);
+    c.voluntarySwitches.store(usage.ru_nvcsw - c.baseline[2], std::memory_order_relaxed);
+    c.involuntarySwitches.store(usage.ru_nivcsw - c.baseline[3], std::memory_order_relaxed);
+}
+
+void DryerRealtime::report(std::ostream& out) const {
+    out << "=== Dryer realtime (since thread start) ===\n";
+    out << std::left << std::setw(9) << "thread" << std::right
+        << std::setw(7) << "policy"
+        << std::setw(6) << "prio"
+        << std::setw(5) << "cpu"
+        << std::setw(10) << "minflt"
+        << std::setw(8) << "majflt"
+        << std::setw(10) << "vcsw"
+        << std::setw(10) << "ivcsw" << "\n";
+
+    for (int role = 0; role < THREAD_ROLE_COUNT; role++) {
+        const ThreadCounters& c = counters[role];
+        if (!c.active) continue;
+
+        const ThreadRtSettings& settings = config.threads[role];
+        const char* policy = !config.enabled ? "-" :
+                             settings.policy == SCHED_FIFO ? "fifo" :
+                             settings.policy == SCHED_RR ? "rr" : "other";
+
+        out << std::left << std::setw(9) << ROLE_NAMES[role] << std::right
+            << std::setw(7) << policy
+            << std::setw(6) << settings.priority
+            << std::setw(5) << settings.cpu
+            << std::setw(10) << c.minorFaults.load(std::memory_order_relaxed)
+            << std::setw(8) << c.majorFaults.load(std::memory_order_relaxed)
+            << std::setw(10) << c.voluntarySwitches.load(std::memory_order_relaxed)
+            << std::setw(10) << c.involuntarySwitches.load(std::memory_order_relaxed) << "\n";
+    }
+    out << "memory locked: " << (memoryLocked ? "yes" : "no") << "\n";
+}
@@ -0,0 +1,103 @@
+#ifndef DRYER_REALTIME_H
+#define DRYER_REALTIME_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <pthread.h>
+
+// ============================================================================
+// DRYER REALTIME - Scheduling, CPU pinning and memory locking
+// Configured per thread role; overridable from the environment:
+//   DRYER_RT=0                  disable everything below
+//   DRYER_RT_LOCK=0             don't mlockall()
+//   DRYER_RT_PHYSICS=fifo:70:2  policy:priority:cpu  (cpu -1 = any)
+//   DRYER_RT_OUTPUT / DRYER_RT_RENDER / DRYER_RT_CONTROL likewise
+//   DRYER_RT_CLOCK              clock sync input (DRYER_CLOCK)
+//   DRYER_RT_ADC                CV input scheduler (DRYER_ADC)
+//   DRYER_RT_DRUM1..3           polyrhythm mode: extra drum workers
+// ============================================================================
+
+enum ThreadRole {
+    THREAD_PHYSICS = 0,
+    THREAD_OUTPUT,
+    THREAD_RENDER,
+    THREAD_CONTROL,
+    THREAD_CLOCK,           // clock sync: MIDI clock / gate input and PLL
+    THREAD_ADC,             // ADS1115 conversions for the CV inputs
+    THREAD_DRUM_1,          // polyrhythm mode: drums 1-3 step in parallel
+    THREAD_DRUM_2,          // with physics (which steps drum 0)
+    THREAD_DRUM_3,
+    THREAD_ROLE_COUNT
+};
+
+struct ThreadRtSettings {
+    int policy;             // SCHED_FIFO, SCHED_RR or SCHED_OTHER
+    int priority;           // 1-99 for FIFO/RR, nice value for OTHER
+    int cpu;                // CPU to pin to, -1 = no affinity
+};
+
+struct RealtimeConfig {
+    bool enabled;
+    bool lockMemory;
+    size_t stackPrefaultBytes;      // touched on every RT thread at start
+    size_t heapPrefaultBytes;       // touched once, then kept by malloc
+    ThreadRtSettings threads[THREAD_ROLE_COUNT];
+};
+
+// Mutex with priority inheritance, so a SCHED_OTHER thread holding it
+// can't stall a SCHED_FIFO waiter behind unrelated work
+class PiMutex {
+public:
+    PiMutex();
+    ~PiMutex();
+    PiMutex(const PiMutex&) = delete;
+    PiMutex& operator=(const PiMutex&) = delete;
+
+    void lock() { pthread_mutex_lock(&mutex); }
+    void unlock() { pthread_mutex_unlock(&mutex); }
+    bool try_lock() { return pthread_mutex_trylock(&mutex) == 0; }
+
+private:
+    pthread_mutex_t mutex;
+};
+
+class DryerRealtime {
+public:
+    DryerRealtime();
+
+    // Configuration
+    void loadFromEnvironment();
+    const RealtimeConfig& getConfig() const { return config; }
+
+    // Process-wide: malloc tuning, heap prefault, mlockall
+    bool setupProcess();
+
+    // Per-thread: name, policy/priority, affinity, stack prefault.
+    // Call first thing on the thread that will play the given role.
+    bool enterThread(ThreadRole role);
+
+    // Snapshot this thread's page faults / context switches (cheap;
+    // call about once a second from each role's loop)
+    void sampleThread(ThreadRole role);
+
+    // Per-role counters since enterThread()
+    void report(std::ostream& out) const;
+
+private:
+    RealtimeConfig config;
+    bool memoryLocked;
+
+    struct ThreadCounters {
+        std::atomic<bool> active;
+        std::atomic<uint64_t> minorFaults;
+        std::atomic<uint64_t> majorFaults;
+        std::atomic<uint64_t> voluntarySwitches;
+        std::atomic<uint64_t> involuntarySwitches;
+        uint64_t baseline[4];       // written by the owning thread only
+    };
+    ThreadCounters counters[THREAD_ROLE_COUNT];
+};
+
+#endif // DRYER_REALTIME_H
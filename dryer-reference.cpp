@@ -0,0 +1,412 @@
+#include "dryer-reference.h"
+#include <algorithm>
+#include <cmath>
+
+ReferencePhysics::ReferencePhysics()
+    : rpm(20.0f)
+    , drumRadius(0.80f)
+    , vaneCount(5)
+    , vaneHeight(0.30f)
+    , drumAngularVelocity((20.0f * 2.0f * M_PI) / 60.0f)
+    , targetRpm(20.0f)
+    , targetRadius(0.80f)
+    , targetHeight(0.30f)
+    , targetVanes(5)
+    , parametersPending(false)
+    , parametersApplied(false)
+    , morphTime(0.0f)
+    , morphRemaining(0.0f)
+    , morphFromRpm(20.0f)
+    , morphFromRadius(0.80f)
+    , morphFromHeight(0.30f)
+    , ball()
+    , useQuadraticDrag(false)
+    , gravity(9.81f)
+    , lintTrapEnabled(false)
+    , lintTrapThreshold(0.15f)
+    , enableCentrifugal(true)
+    , enableCoriolis(true)
+    , enableAirDrag(true)
+    , drumPhase(0)
+    , drumCos(1.0f)
+    , drumSin(0.0f)
+    , stepDelta(0.0f)
+    , stepCos(1.0f)
+    , stepSin(0.0f)
+    , rotationSteps(0)
+    , contactSleepEnabled(true)
+    , rolling(false)
+    , contactSegment(0)
+    , contactVaneX{1.0f, 1.0f}
+    , contactVaneY{0.0f, 0.0f}
+    , restingSteps(0)
+    , lastCollisionSlot(-1)
+{
+    setBall(*builtinBallPreset("tennis"));
+    setBallState(drumRadius * 0.3f, 0.0f, 0.0f, 0.0f);
+}
+
+void ReferencePhysics::setParameters(float rpm, float drumSizeCm, int vaneCount, float vaneHeightPercent) {
+    targetRpm = rpm;
+    targetRadius = drumSizeCm / 100.0f;
+    targetVanes = std::max(1, std::min(vaneCount, DryerPhysics::MAX_VANES));
+    targetHeight = vaneHeightPercent / 100.0f;
+    parametersPending = true;
+}
+
+void ReferencePhysics::applyParameters(float dt) {
+    if (parametersPending) {
+        if (targetRadius != drumRadius || targetVanes != vaneCount) {
+            rolling = false;
+            restingSteps = 0;
+        }
+        morphFromRpm = rpm;
+        morphFromRadius = drumRadius;
+        morphFromHeight = vaneHeight;
+        morphRemaining = parametersApplied ? morphTime : 0.0f;
+        parametersPending = false;
+        parametersApplied = true;
+        vaneCount = targetVanes;
+    }
+
+    morphRemaining = std::max(morphRemaining - dt, 0.0f);
+    if (morphRemaining > 0.0f) {
+        float t = 1.0f - morphRemaining / morphTime;
+        rpm = morphFromRpm + (targetRpm - morphFromRpm) * t;
+        drumRadius = morphFromRadius + (targetRadius - morphFromRadius) * t;
+        vaneHeight = morphFromHeight + (targetHeight - morphFromHeight) * t;
+    } else {
+        rpm = targetRpm;
+        drumRadius = targetRadius;
+        vaneHeight = targetHeight;
+    }
+    drumAngularVelocity = (rpm * 2.0f * M_PI) / 60.0f;
+
+    // The wall carries the ball in, outward speed dropped, no hit
+    float limit = drumRadius - ball.radius;
+    float dist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    if (dist > limit && dist > 0.0f) {
+        float ux = ball.x / dist;
+        float uy = ball.y / dist;
+        ball.x = ux * limit;
+        ball.y = uy * limit;
+        float outward = ball.vx * ux + ball.vy * uy;
+        if (outward > 0.0f) {
+            ball.vx -= outward * ux;
+            ball.vy -= outward * uy;
+        }
+    }
+}
+
+void ReferencePhysics::setBall(const BallPreset& preset) {
+    rolling = false;
+    restingSteps = 0;
+    ball.radius = preset.radius;
+    ball.mass = preset.mass;
+    ball.restitution = preset.restitution;
+    ball.dragCoeff = preset.dragCoeff;
+    ball.inverseMass = preset.inverseMass;
+    ball.bounce = preset.bounce;
+    ball.dragFactor = preset.dragFactor;
+    useQuadraticDrag = preset.quadraticDrag;
+}
+
+void ReferencePhysics::setFeatures(bool centrifugal, bool coriolis, bool airDrag) {
+    enableCentrifugal = centrifugal;
+    enableCoriolis = coriolis;
+    enableAirDrag = airDrag;
+}
+
+void ReferencePhysics::setContactSleep(bool enabled) {
+    contactSleepEnabled = enabled;
+    if (!enabled) {
+        rolling = false;
+        restingSteps = 0;
+    }
+}
+
+void ReferencePhysics::setBallState(float x, float y, float vx, float vy) {
+    rolling = false;
+    restingSteps = 0;
+    ball.x = x;
+    ball.y = y;
+    ball.vx = vx;
+    ball.vy = vy;
+}
+
+void ReferencePhysics::syncRotation() {
+    float angle = getDrumAngle();
+    drumCos = std::cos(angle);
+    drumSin = std::sin(angle);
+    rotationSteps = 0;
+}
+
+void ReferencePhysics::advanceRotation(float dt) {
+    float delta = drumAngularVelocity * dt;
+    drumPhase += static_cast<uint32_t>(std::llround(delta / RADIANS_PER_PHASE));
+
+    if (++rotationSteps >= ROTATION_RESYNC_STEPS) {
+        syncRotation();
+        return;
+    }
+
+    if (delta != stepDelta) {
+        stepDelta = delta;
+        if (std::abs(delta) < 0.1f) {
+            float delta2 = delta * delta;
+            stepCos = 1.0f - delta2 * (0.5f - delta2 * (1.0f / 24.0f));
+            stepSin = delta * (1.0f - delta2 * ((1.0f / 6.0f) - delta2 * (1.0f / 120.0f)));
+        } else {
+            stepCos = std::cos(delta);
+            stepSin = std::sin(delta);
+        }
+    }
+
+    float c = drumCos * stepCos - drumSin * stepSin;
+    float s = drumSin * stepCos + drumCos * stepSin;
+    float norm = 1.5f - 0.5f * (c * c + s * s);
+    drumCos = c * norm;
+    drumSin = s * norm;
+}
+
+void ReferencePhysics::step(float dt) {
+    hits.clear();
+    if (parametersPending || morphRemaining > 0.0f) {
+        applyParameters(dt);
+    }
+    advanceRotation(dt);
+
+    float gravityX = -gravity * drumSin;
+    float gravityY = -gravity * drumCos;
+
+    if (rolling && stepRolling(dt, gravityX, gravityY)) {
+        return;
+    }
+
+    float centrifugalX = 0.0f;
+    float centrifugalY = 0.0f;
+    if (enableCentrifugal) {
+        float distFromCenter = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+        if (distFromCenter > 0.0001f) {
+            float centrifugalMagnitude = drumAngularVelocity * drumAngularVelocity * distFromCenter;
+            centrifugalX = (ball.x / distFromCenter) * centrifugalMagnitude;
+            centrifugalY = (ball.y / distFromCenter) * centrifugalMagnitude;
+        }
+    }
+
+    float coriolisX = 0.0f;
+    float coriolisY = 0.0f;
+    if (enableCoriolis) {
+        coriolisX = 2.0f * drumAngularVelocity * ball.vy;
+        coriolisY = -2.0f * drumAngularVelocity * ball.vx;
+    }
+
+    float dragX = 0.0f;
+    float dragY = 0.0f;
+    if (enableAirDrag) {
+        float speed = std::sqrt(ball.vx * ball.vx + ball.vy * ball.vy);
+        if (speed > 0.001f) {
+            if (useQuadraticDrag) {
+                float dragPerSpeed = ball.dragFactor * speed;
+                dragX = -ball.vx * dragPerSpeed;
+                dragY = -ball.vy * dragPerSpeed;
+            } else {
+                float dampingFactor = std::exp(-LINEAR_DRAG * dt);
+                ball.vx *= dampingFactor;
+                ball.vy *= dampingFactor;
+            }
+        }
+    }
+
+    float totalAccelX = gravityX + centrifugalX + coriolisX;
+    float totalAccelY = gravityY + centrifugalY + coriolisY;
+    if (useQuadraticDrag) {
+        totalAccelX += dragX;
+        totalAccelY += dragY;
+    }
+
+    ball.vx += totalAccelX * dt;
+    ball.vy += totalAccelY * dt;
+    ball.x += ball.vx * dt;
+    ball.y += ball.vy * dt;
+
+    handleCollisions();
+}
+
+bool ReferencePhysics::stepRolling(float dt, float gravityX, float gravityY) {
+    float rc = drumRadius - ball.radius;
+    float ux = ball.x / rc;
+    float uy = ball.y / rc;
+    float tx = -uy;
+    float ty = ux;
+    float speed = ball.vx * tx + ball.vy * ty;
+
+    float outward = gravityX * ux + gravityY * uy + speed * speed / rc;
+    if (enableCentrifugal) {
+        outward += drumAngularVelocity * drumAngularVelocity * rc;
+    }
+    if (enableCoriolis) {
+        outward += 2.0f * drumAngularVelocity * speed;
+    }
+    if (outward < 0.0f) {
+        rolling = false;
+        restingSteps = 0;
+        return false;
+    }
+
+    float along = gravityX * tx + gravityY * ty;
+    if (enableAirDrag && std::abs(speed) > 0.001f) {
+        if (useQuadraticDrag) {
+            along -= ball.dragFactor * std::abs(speed) * speed;
+        } else {
+            speed *= std::exp(-LINEAR_DRAG * dt);
+        }
+    }
+    speed += along * dt;
+
+    float x = ball.x + speed * tx * dt;
+    float y = ball.y + speed * ty * dt;
+    float scale = rc / std::sqrt(x * x + y * y);
+    ball.x = x * scale;
+    ball.y = y * scale;
+    ball.vx = -ball.y / rc * speed;
+    ball.vy = ball.x / rc * speed;
+
+    float vaneInnerRadius = drumRadius * (1.0f - vaneHeight);
+    for (int side = 0; side < 2; side++) {
+        float dx = contactVaneX[side];
+        float dy = contactVaneY[side];
+        float sign = side == 0 ? 1.0f : -1.0f;
+        float inside = sign * (dx * ball.y - dy * ball.x);
+        if (dx * ball.x + dy * ball.y < vaneInnerRadius || inside >= ball.radius) continue;
+
+        if (-sign * speed >= RESTING_SPEED) {
+            rolling = false;
+            restingSteps = 0;
+            checkVaneCollision(side == 0 ? contactSegment : (contactSegment + 1) % vaneCount);
+            return true;
+        }
+
+        x = ball.x + sign * (ball.radius - inside) * (-ball.y / rc);
+        y = ball.y + sign * (ball.radius - inside) * (ball.x / rc);
+        scale = rc / std::sqrt(x * x + y * y);
+        ball.x = x * scale;
+        ball.y = y * scale;
+        if (-sign * speed > 0.0f) {
+            speed = 0.0f;
+        }
+        ball.vx = -ball.y / rc * speed;
+        ball.vy = ball.x / rc * speed;
+    }
+    return true;
+}
+
+int ReferencePhysics::wallSegment() const {
+    float ballAngle = std::atan2(ball.y, ball.x);
+    float anglePerSegment = (2.0f * M_PI) / vaneCount;
+    float normalizedAngle = ballAngle;
+    if (normalizedAngle < 0.0f) normalizedAngle += 2.0f * M_PI;
+    return static_cast<int>(std::floor(normalizedAngle / anglePerSegment)) % vaneCount;
+}
+
+void ReferencePhysics::sleepOnWall() {
+    float dist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    float ux = ball.x / dist;
+    float uy = ball.y / dist;
+    float vn = ball.vx * ux + ball.vy * uy;
+    ball.vx -= vn * ux;
+    ball.vy -= vn * uy;
+
+    rolling = true;
+    contactSegment = wallSegment();
+    restingSteps = 0;
+    for (int side = 0; side < 2; side++) {
+        float vaneAngle = (static_cast<float>(contactSegment + side) / vaneCount) * 2.0f * M_PI;
+        contactVaneX[side] = std::cos(vaneAngle);
+        contactVaneY[side] = std::sin(vaneAngle);
+    }
+}
+
+void ReferencePhysics::handleCollisions() {
+    float ballDist = std::sqrt(ball.x * ball.x + ball.y * ball.y);
+    bool restingContact = false;
+
+    if (ballDist + ball.radius > drumRadius) {
+        float penetration = ballDist + ball.radius - drumRadius;
+        float nx = -ball.x / ballDist;
+        float ny = -ball.y / ballDist;
+        ball.x += nx * penetration;
+        ball.y += ny * penetration;
+
+        float vn = ball.vx * nx + ball.vy * ny;
+        restingContact = std::abs(vn) < RESTING_SPEED;
+        if (vn < 0.0f) {
+            int segmentIndex = wallSegment();
+            ball.vx -= ball.bounce * vn * nx;
+            ball.vy -= ball.bounce * vn * ny;
+            if (segmentIndex >= 0) {
+                triggerCollision(DryerPhysics::surfaceSlot(segmentIndex, SURFACE_DRUM), std::abs(vn));
+            }
+        }
+    }
+
+    float vaneSpeed = -1.0f;
+    for (int i = 0; i < vaneCount; i++) {
+        vaneSpeed = std::max(vaneSpeed, checkVaneCollision(i));
+    }
+
+    restingSteps = restingContact && vaneSpeed < RESTING_SPEED ? restingSteps + 1 : 0;
+    if (contactSleepEnabled && restingSteps >= RESTING_STEPS) {
+        sleepOnWall();
+    }
+}
+
+float ReferencePhysics::checkVaneCollision(int i) {
+    float vaneInnerRadius = drumRadius * (1.0f - vaneHeight);
+    float vaneAngle = (static_cast<float>(i) / vaneCount) * 2.0f * M_PI;
+
+    float vx1 = vaneInnerRadius * std::cos(vaneAngle);
+    float vy1 = vaneInnerRadius * std::sin(vaneAngle);
+    float vx2 = drumRadius * std::cos(vaneAngle);
+    float vy2 = drumRadius * std::sin(vaneAngle);
+
+    float dx = ball.x - vx1;
+    float dy = ball.y - vy1;
+    float vdx = vx2 - vx1;
+    float vdy = vy2 - vy1;
+    float vaneLength = std::sqrt(vdx * vdx + vdy * vdy);
+    float t = (dx * vdx + dy * vdy) / (vaneLength * vaneLength);
+    if (t < 0.0f || t > 1.0f) return -1.0f;
+
+    float closestX = vx1 + t * vdx;
+    float closestY = vy1 + t * vdy;
+    float distX = ball.x - closestX;
+    float distY = ball.y - closestY;
+    float dist = std::sqrt(distX * distX + distY * distY);
+    if (dist >= ball.radius) return -1.0f;
+
+    float penetration = ball.radius - dist;
+    float nx = distX / dist;
+    float ny = distY / dist;
+    ball.x += nx * penetration;
+    ball.y += ny * penetration;
+
+    float vn = ball.vx * nx + ball.vy * ny;
+    if (vn < 0.0f) {
+        ball.vx -= ball.bounce * vn * nx;
+        ball.vy -= ball.bounce * vn * ny;
+
+        float perpX = -vdy / vaneLength;
+        float perpY = vdx / vaneLength;
+        SurfaceType side = (dx * perpX + dy * perpY) > 0.0f ? SURFACE_VANE_LEADING : SURFACE_VANE_TRAILING;
+        triggerCollision(DryerPhysics::surfaceSlot(i, side), std::abs(vn));
+    }
+    return std::abs(vn);
+}
+
+void ReferencePhysics::triggerCollision(int slot, float velocity) {
+    if (lintTrapEnabled && velocity < lintTrapThreshold) return;
+    if (lastCollisionSlot == slot) return;
+    lastCollisionSlot = slot;
+    hits.push_back(ReferenceHit{slot, velocity});
+}
@@ -0,0 +1,103 @@
+#ifndef DRYER_REFERENCE_H
+#define DRYER_REFERENCE_H
+
+#include "dryer-physics.h"
+
+// ============================================================================
+// DRYER REFERENCE - Frozen copy of the physics step, the oracle for
+// dryer-bench --diff
+// The float step, resting contact and collisions as DryerPhysics had them
+// when this was frozen, with the toggles read at runtime, and a parameter
+// change as it applies: at the next step, morphing RPM, drum size and vane
+// height over setMorphTime(), a shrinking wall carrying the ball in. Do not
+// optimize or fix it: optimizations of DryerPhysics are checked against it.
+// A change meant to alter the rhythm output updates this file in the same
+// commit.
+// ============================================================================
+
+struct ReferenceHit {
+    int slot;               // DryerPhysics::surfaceSlot()
+    float velocity;
+};
+
+class ReferencePhysics {
+public:
+    using HitList = FixedVector<ReferenceHit, DryerPhysics::MAX_SURFACES>;
+
+    ReferencePhysics();
+
+    // Takes effect at the next step; the first change never morphs
+    void setParameters(float rpm, float drumSizeCm, int vaneCount, float vaneHeightPercent);
+    void setMorphTime(float seconds) { morphTime = std::max(seconds, 0.0f); }
+    void setBall(const BallPreset& preset);
+    void setLintTrap(bool enabled) { lintTrapEnabled = enabled; }
+    void setMoonGravity(bool enabled) { gravity = enabled ? 1.635f : 9.81f; }
+    void setFeatures(bool centrifugal, bool coriolis, bool airDrag);
+    void setContactSleep(bool enabled);
+    void setBallState(float x, float y, float vx, float vy);
+
+    // One step; hits it reported are in getHits() until the next
+    void step(float dt);
+
+    const Ball& getBall() const { return ball; }
+    const HitList& getHits() const { return hits; }
+    float getDrumAngle() const { return static_cast<float>(drumPhase * RADIANS_PER_PHASE); }
+
+private:
+    static constexpr double RADIANS_PER_PHASE = 2.0 * M_PI / 4294967296.0;
+    static constexpr int ROTATION_RESYNC_STEPS = 1024;
+    static constexpr float LINEAR_DRAG = 0.1f;
+    static constexpr float RESTING_SPEED = 0.15f;
+    static constexpr int RESTING_STEPS = 8;
+
+    float rpm;
+    float drumRadius;
+    int vaneCount;
+    float vaneHeight;
+    float drumAngularVelocity;
+
+    // Last setParameters(), and the morph towards it
+    float targetRpm, targetRadius, targetHeight;
+    int targetVanes;
+    bool parametersPending;
+    bool parametersApplied;
+    float morphTime;
+    float morphRemaining;
+    float morphFromRpm, morphFromRadius, morphFromHeight;
+    Ball ball;
+    bool useQuadraticDrag;
+    float gravity;
+    bool lintTrapEnabled;
+    float lintTrapThreshold;
+    bool enableCentrifugal;
+    bool enableCoriolis;
+    bool enableAirDrag;
+
+    uint32_t drumPhase;
+    float drumCos, drumSin;
+    float stepDelta;
+    float stepCos, stepSin;
+    int rotationSteps;
+
+    bool contactSleepEnabled;
+    bool rolling;
+    int contactSegment;
+    float contactVaneX[2];
+    float contactVaneY[2];
+    int restingSteps;
+
+    int lastCollisionSlot;
+    HitList hits;
+
+    void applyParameters(float dt);
+    void syncRotation();
+    void advanceRotation(float dt);
+    bool stepRolling(float dt, float gravityX, float gravityY);
+    int wallSegment() const;
+    void sleepOnWall();
+    void handleCollisions();
+    float checkVaneCollision(int i);
+    void triggerCollision(int slot, float velocity);
+};
+
+#endif // DRYER_REFERENCE_H
@@ -1,7 +1,50 @@
 #include "dryer-renderer.h"
+#include "dryer-latency.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// Highlight fade: full -> off in 1/3 s, independent of frame rate
+static const float HIGHLIGHT_DECAY_PER_SECOND = 3.0f;
+
+// Motion trail look
+static const float DEFAULT_TRAIL_SECONDS = 1.5f;    // until ~5% brightness
+static const float TRAIL_WIDTH = 3.0f;
+static const float TRAIL_HIT_RADIUS = 5.0f;
+// Time constants until a stamp is below 1/255 (ln 255): then clear outright
+static const float TRAIL_EXPIRY_CONSTANTS = 5.55f;
+
+// Software path: past this share of the screen, one full repaint is cheaper
+// than many small rectangles
+static const float FULL_REPAINT_FRACTION = 0.4f;
+
+// Rectangles closer than this are merged (saves re-walking the batch)
+static const int DIRTY_MERGE_MARGIN = 8;
+
+static SDL_Color toSDLColor(uint32_t color, float alpha) {
+    SDL_Color c;
+    c.r = (color >> 16) & 0xFF;
+    c.g = (color >> 8) & 0xFF;
+    c.b = color & 0xFF;
+    c.a = static_cast<uint8_t>(alpha * 255);
+    return c;
+}
+
+void RenderProfile::reset() {
+    std::fill(std::begin(stageNs), std::end(stageNs), 0);
+    frames = 0;
+}
+
+const char* RenderProfile::stageName(int stage) {
+    static const char* names[RENDER_STAGE_COUNT] = {
+        "drum", "vanes", "ball", "mask", "trail", "dirty", "raster", "present"
+    };
+    return (stage >= 0 && stage < RENDER_STAGE_COUNT) ? names[stage] : "?";
+}
 
 DryerRenderer::DryerRenderer(int width, int height)
     : window(nullptr)
@@ -9,14 +52,44 @@ DryerRenderer::DryerRenderer(int width, int height)
     , width(width)
     , height(height)
     , initialized(false)
+    , viewportCount(0)
+    , renderedDrums(0)
+    , lastHighlightUpdate(0)
+    , useGeometry(false)
+    , trailEnabled(false)
+    , trailTimeConstant(DEFAULT_TRAIL_SECONDS / 3.0f)
+    , trailTexture(nullptr)
+    , trailBounds{0, 0, 0, 0}
+    , trailDirty{0, 0, 0, 0}
+    , trailLastStamp(0)
+    , lastTrailUpdate(0)
+    , backend(RENDER_SDL)
+    , dirtyFraction(1.0f)
+    , stageStart(0)
 {
+    std::fill(std::begin(activeCollisions), std::end(activeCollisions), 0.0f);
+    for (auto& pen : trailPens) {
+        pen = TrailPen{false, 0.0f, 0.0f};
+    }
+    layoutDrums(1);
 }
 
 DryerRenderer::~DryerRenderer() {
     shutdown();
 }
 
-bool DryerRenderer::initialize(bool fullscreen) {
+bool DryerRenderer::initialize(bool fullscreen, RenderBackend backend) {
+    this->backend = backend;
+    
+    const char* trail = std::getenv("DRYER_TRAIL");
+    const char* trailSeconds = std::getenv("DRYER_TRAIL_SECONDS");
+    setTrail(trail && trail[0] == '1',
+             trailSeconds ? static_cast<float>(std::atof(trailSeconds)) : DEFAULT_TRAIL_SECONDS);
+    
+    if (backend != RENDER_SDL) {
+        return initializeSoftware();
+    }
+    
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
@@ -54,15 +127,68 @@ bool DryerRenderer::initialize(bool fullscreen) {
     // Set blend mode for alpha
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    const char* forceLines = std::getenv("DRYER_RENDER_LINES");
+    useGeometry = !(forceLines && forceLines[0] == '1');
+#endif
+    
     initialized = true;
-    std::cout << "SDL renderer initialized: " << width << "x" << height << std::endl;
+    std::cout << "SDL renderer initialized: " << width << "x" << height
+              << (useGeometry ? " (geometry batch)" : " (lines)")
+              << (trailEnabled ? ", trail" : "") << std::endl;
     
     return true;
 }
 
+bool DryerRenderer::initializeSoftware() {
+    const char* kind = "memory";
+    if (backend == RENDER_DRM) kind = "drm";
+    if (backend == RENDER_FBDEV) kind = "fbdev";
+    
+    target.reset(createFramebufferTarget(kind));
+    if (!target || !target->open(width, height)) {
+        std::cerr << "Software renderer: cannot open " << kind << " target" << std::endl;
+        target.reset();
+        return false;
+    }
+    
+    // Empty history forces a full repaint of every buffer
+    previousShapes.clear();
+    previousDirty.clear();
+    
+    initialized = true;
+    std::cout << "Software renderer initialized: " << width << "x" << height
+              << " (" << target->name() << (trailEnabled ? ", trail" : "") << ")" << std::endl;
+    
+    return true;
+}
+
+RenderBackend DryerRenderer::backendFromEnvironment() {
+    const char* value = std::getenv("DRYER_RENDERER");
+    if (!value || std::strcmp(value, "sdl") == 0) return RENDER_SDL;
+    if (std::strcmp(value, "drm") == 0) return RENDER_DRM;
+    if (std::strcmp(value, "fbdev") == 0) return RENDER_FBDEV;
+    if (std::strcmp(value, "memory") == 0) return RENDER_MEMORY;
+    
+    std::cerr << "Unknown DRYER_RENDERER=" << value << ", using sdl" << std::endl;
+    return RENDER_SDL;
+}
+
 void DryerRenderer::shutdown() {
     if (!initialized) return;
     
+    if (target) {
+        target->close();
+        target.reset();
+        initialized = false;
+        return;
+    }
+    
+    if (trailTexture) {
+        SDL_DestroyTexture(trailTexture);
+        trailTexture = nullptr;
+    }
+    
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
@@ -96,55 +222,631 @@ void DryerRenderer::present() {
     SDL_RenderPresent(renderer);
 }
 
-void DryerRenderer::render(const DryerPhysics& physics) {
+bool DryerRenderer::processEvents() {
+    // No window on the software backends; SIGINT/SIGTERM stop those
+    if (backend != RENDER_SDL) return true;
+    
+    bool open = true;
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_QUIT) {
+            open = false;
+        } else if (event.type == SDL_RENDER_TARGETS_RESET) {
+            // Render-target textures lost their contents
+            clearTrail();
+        }
+    }
+    return open;
+}
+
+void DryerRenderer::render(const DryerPhysics* drums, int drumCount) {
+    drumCount = std::max(1, std::min(drumCount, MAX_DRUMS));
+    if (drumCount != viewportCount) {
+        layoutDrums(drumCount);
+    }
+    
+    // Pick up hits reported since the last frame
+    applyCollisionEvents();
+    
+    stageStart = latencyNowNs();
+    
+    if (target) {
+        renderSoftware(drums, drumCount);
+        updateCollisionHighlights();
+        rememberRendered(drums, drumCount);
+        profile.frames++;
+        return;
+    }
+    
+    // Trail texture first: it switches render targets
+    if (trailEnabled) {
+        updateTrail(drums, drumCount);
+    }
+    
     clear();
     
-    // Draw components
-    drawDrumSegments(physics);
-    drawVanes(physics);
-    drawBall(physics);
+    // Trail underneath everything else
+    if (trailTexture) {
+        SDL_RenderCopy(renderer, trailTexture, nullptr, nullptr);
+        endStage(RENDER_STAGE_TRAIL);
+    }
     
-    // Apply circular mask for round display
-    applyCircleMask();
+    if (useGeometry) {
+        // Build the whole frame, then one draw call
+        buildFrame(drums, drumCount);
+        
+        if (!geometry.submit(renderer)) {
+            std::cerr << "SDL_RenderGeometry failed (" << SDL_GetError()
+                      << "), falling back to line rendering" << std::endl;
+            useGeometry = false;
+        }
+        endStage(RENDER_STAGE_RASTER);
+    } else {
+        // Draw components
+        for (int drum = 0; drum < drumCount; drum++) {
+            drawDrumSegments(drums[drum], drum);
+            endStage(RENDER_STAGE_DRUM);
+            drawVanes(drums[drum], drum);
+            endStage(RENDER_STAGE_VANES);
+            drawBall(drums[drum], drum);
+            endStage(RENDER_STAGE_BALL);
+        }
+        
+        // Apply circular mask for round display
+        applyCircleMask();
+        endStage(RENDER_STAGE_MASK);
+    }
     
     // Update collision highlights
     updateCollisionHighlights();
     
     present();
+    endStage(RENDER_STAGE_PRESENT);
+    rememberRendered(drums, drumCount);
+    profile.frames++;
 }
 
-void DryerRenderer::drawDrumSegments(const DryerPhysics& physics) {
-    int centerX = width / 2;
-    int centerY = height / 2;
-    float scale = width / (physics.getDrumRadius() * 2.2f);
+void DryerRenderer::layoutDrums(int drumCount) {
+    viewportCount = drumCount;
+    
+    // New layout: nothing on screen is where it was
+    renderedDrums = 0;
+    clearTrail();
+    
+    if (drumCount == 1) {
+        viewports[0] = DrumViewport{0.0f, 0.0f, width};
+        return;
+    }
+    
+    // Largest equal circles that fit in the round display, in a ring
+    // around the centre starting on the left
+    float displayRadius = width / 2.0f;
+    float s = std::sin(static_cast<float>(M_PI) / drumCount);
+    float radius = std::floor(displayRadius * s / (1.0f + s));
+    for (int i = 0; i < drumCount; i++) {
+        float angle = static_cast<float>(M_PI) * (1.0f - 2.0f * i / drumCount);
+        float cx = width / 2.0f + (displayRadius - radius) * std::cos(angle);
+        float cy = height / 2.0f - (displayRadius - radius) * std::sin(angle);
+        viewports[i] = DrumViewport{std::round(cx - radius), std::round(cy - radius),
+                                    static_cast<int>(2.0f * radius)};
+    }
+}
+
+void DryerRenderer::rememberRendered(const DryerPhysics* drums, int drumCount) {
+    renderedDrums = drumCount;
+    for (int i = 0; i < drumCount; i++) {
+        const DryerPhysics& physics = drums[i];
+        auto ball = physics.getBallPosition(viewports[i].size);
+        RenderedState& last = lastRendered[i];
+        last.ballX = ball.x;
+        last.ballY = ball.y;
+        last.ballRadius = ball.radius;
+        last.drumAngle = physics.getDrumAngle();
+        last.drumRadius = physics.getDrumRadius();
+        last.vaneHeight = physics.getVaneHeight();
+        last.vaneCount = physics.getVaneCount();
+    }
+}
+
+float DryerRenderer::estimateChange(const DryerPhysics* drums, int drumCount) const {
+    const float everything = std::numeric_limits<float>::infinity();
+    
+    if (drumCount != renderedDrums) return everything;
+    
+    // New hits, or highlights / trail still fading
+    if (!collisionEvents.empty()) return everything;
+    if (trailEnabled && !trailBounds.empty()) return everything;
+    for (float intensity : activeCollisions) {
+        if (intensity > 0.0f) return everything;
+    }
+    
+    float change = 0.0f;
+    for (int i = 0; i < drumCount; i++) {
+        const DryerPhysics& physics = drums[i];
+        const RenderedState& last = lastRendered[i];
+        
+        if (physics.getVaneCount() != last.vaneCount ||
+            physics.getDrumRadius() != last.drumRadius ||
+            physics.getVaneHeight() != last.vaneHeight) {
+            return everything;
+        }
+        
+        // Ball travel
+        int size = viewports[i].size;
+        auto ball = physics.getBallPosition(size);
+        float dx = ball.x - last.ballX;
+        float dy = ball.y - last.ballY;
+        float ballMove = std::sqrt(dx * dx + dy * dy) + std::fabs(ball.radius - last.ballRadius);
+        
+        // Drum and vanes: arc length travelled at the rim
+        float angle = std::remainder(physics.getDrumAngle() - last.drumAngle, 2.0f * static_cast<float>(M_PI));
+        float rimMove = std::fabs(angle) * size / 2.2f;
+        
+        change = std::max(change, std::max(ballMove, rimMove));
+    }
+    return change;
+}
+
+void DryerRenderer::endStage(RenderStage stage) {
+    uint64_t now = latencyNowNs();
+    profile.stageNs[stage] += now - stageStart;
+    stageStart = now;
+}
+
+void DryerRenderer::invalidate() {
+    // A shape count mismatch forces a full repaint
+    previousShapes.clear();
+}
+
+void DryerRenderer::buildFrame(const DryerPhysics* drums, int drumCount) {
+    geometry.clear();
+    for (int drum = 0; drum < drumCount; drum++) {
+        buildDrumSegments(drums[drum], drum);
+        endStage(RENDER_STAGE_DRUM);
+        buildVanes(drums[drum], drum);
+        endStage(RENDER_STAGE_VANES);
+        buildBall(drums[drum], drum);
+        endStage(RENDER_STAGE_BALL);
+    }
+    buildCircleMask();
+    endStage(RENDER_STAGE_MASK);
+}
+
+void DryerRenderer::renderSoftware(const DryerPhysics* drums, int drumCount) {
+    if (trailEnabled) {
+        updateTrail(drums, drumCount);
+        endStage(RENDER_STAGE_TRAIL);
+    }
+    
+    buildFrame(drums, drumCount);
+    
+    // What changed since the last frame
+    ShapeList shapes;
+    RectList frameDirty;
+    collectShapes(shapes);
+    findDirtyRects(shapes, frameDirty);
+    if (!trailDirty.empty() && !frameDirty.push_back(trailDirty)) {
+        frameDirty.clear();
+        frameDirty.push_back(PixelRect{0, 0, width, height});
+    }
+    
+    // A double-buffered back buffer also misses the previous frame's changes
+    RectList repaint = frameDirty;
+    if (target->bufferCount() > 1) {
+        for (const auto& rect : previousDirty) {
+            if (!repaint.push_back(rect)) {
+                repaint.clear();
+                repaint.push_back(PixelRect{0, 0, width, height});
+                break;
+            }
+        }
+    }
+    mergeRects(repaint);
+    
+    int repaintArea = 0;
+    for (const auto& rect : repaint) {
+        repaintArea += rect.area();
+    }
+    if (repaintArea > FULL_REPAINT_FRACTION * width * height) {
+        repaint.clear();
+        repaint.push_back(PixelRect{0, 0, width, height});
+        repaintArea = width * height;
+    }
+    endStage(RENDER_STAGE_DIRTY);
+    
+    // May wait for the previous page flip
+    rasterizer.setTarget(target->backBuffer());
+    endStage(RENDER_STAGE_PRESENT);
+    
+    // Clear and redraw each region with the batch clipped to it
+    const int indexCount = static_cast<int>(geometry.indexCount());
+    Framebuffer trailFrame = {trailPixels.data(), width, height, width};
+    for (const auto& rect : repaint) {
+        if (trailPixels.empty()) {
+            rasterizer.fillRect(rect, 0x000000);
+        } else {
+            rasterizer.copyRect(rect, trailFrame);
+        }
+        rasterizer.drawTriangles(geometry.vertexData(), geometry.indexData(), indexCount, rect);
+    }
+    endStage(RENDER_STAGE_RASTER);
+    
+    if (!repaint.empty()) {
+        target->flip();
+    }
+    endStage(RENDER_STAGE_PRESENT);
+    
+    previousShapes = shapes;
+    previousDirty = frameDirty;
+    dirtyFraction = static_cast<float>(repaintArea) / (width * height);
+}
+
+void DryerRenderer::setTrail(bool enabled, float seconds) {
+    trailEnabled = enabled;
+    trailTimeConstant = std::max(0.05f, seconds) / 3.0f;   // 3 time constants = 5%
+    clearTrail();
+}
+
+void DryerRenderer::clearTrail() {
+    for (auto& pen : trailPens) {
+        pen.hasLast = false;
+    }
+    trailHits.clear();
+    trailBounds = PixelRect{0, 0, 0, 0};
+    trailLastStamp = 0;
+    lastTrailUpdate = 0;
+    
+    if (trailTexture) {
+        SDL_SetRenderTarget(renderer, trailTexture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+    std::fill(trailPixels.begin(), trailPixels.end(), 0xFF000000u);
+    
+    // Whatever was on screen must go too
+    invalidate();
+}
+
+bool DryerRenderer::createTrailTexture() {
+    trailTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                     width, height);
+    if (!trailTexture) {
+        std::cerr << "Trail texture unavailable (" << SDL_GetError() << "), trail disabled" << std::endl;
+        return false;
+    }
+    
+    // Black adds nothing, so only the trail itself shows
+    SDL_SetTextureBlendMode(trailTexture, SDL_BLENDMODE_ADD);
+    SDL_SetRenderTarget(renderer, trailTexture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderTarget(renderer, nullptr);
+    return true;
+}
+
+void DryerRenderer::updateTrail(const DryerPhysics* drums, int drumCount) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    float frequency = static_cast<float>(SDL_GetPerformanceFrequency());
+    float elapsed = lastTrailUpdate != 0 ? (now - lastTrailUpdate) / frequency : 0.0f;
+    lastTrailUpdate = now;
+    
+    // Newest segment of each ball's path, plus a mark for every hit since
+    // the last frame (the ball is where the hit happened)
+    trailGeometry.clear();
+    
+    for (int drum = 0; drum < drumCount; drum++) {
+        const DrumViewport& view = viewports[drum];
+        auto ball = drums[drum].getBallPosition(view.size);
+        ball.x += view.x;
+        ball.y += view.y;
+        
+        TrailPen& pen = trailPens[drum];
+        if (pen.hasLast) {
+            SDL_Color pathColor = {232, 244, 54, 160};
+            trailGeometry.addLine(pen.lastX, pen.lastY, ball.x, ball.y, TRAIL_WIDTH, pathColor);
+        }
+        pen = TrailPen{true, ball.x, ball.y};
+        
+        const auto& surfaces = drums[drum].getSurfaces();
+        for (int key : trailHits) {
+            int slot = key - highlightKey(drum, 0);
+            if (slot < 0 || slot >= static_cast<int>(surfaces.size())) continue;
+            SDL_Color hitColor = toSDLColor(surfaces[slot].color, 1.0f);
+            trailGeometry.addDisc(ball.x, ball.y, TRAIL_HIT_RADIUS, hitColor, hitColor, 16);
+        }
+    }
+    trailHits.clear();
+    
+    // Grow the area that may hold trail pixels
+    if (trailGeometry.vertexCount() > 0) {
+        const SDL_Vertex* vertices = trailGeometry.vertexData();
+        float minX = vertices[0].position.x;
+        float maxX = minX;
+        float minY = vertices[0].position.y;
+        float maxY = minY;
+        for (size_t i = 1; i < trailGeometry.vertexCount(); i++) {
+            minX = std::min(minX, vertices[i].position.x);
+            maxX = std::max(maxX, vertices[i].position.x);
+            minY = std::min(minY, vertices[i].position.y);
+            maxY = std::max(maxY, vertices[i].position.y);
+        }
+        
+        PixelRect stamp = {
+            std::max(0, static_cast<int>(std::floor(minX)) - 1),
+            std::max(0, static_cast<int>(std::floor(minY)) - 1),
+            std::min(width, static_cast<int>(std::ceil(maxX)) + 1),
+            std::min(height, static_cast<int>(std::ceil(maxY)) + 1)
+        };
+        if (trailBounds.empty()) {
+            trailBounds = stamp;
+        } else {
+            trailBounds.x0 = std::min(trailBounds.x0, stamp.x0);
+            trailBounds.y0 = std::min(trailBounds.y0, stamp.y0);
+            trailBounds.x1 = std::max(trailBounds.x1, stamp.x1);
+            trailBounds.y1 = std::max(trailBounds.y1, stamp.y1);
+        }
+        trailLastStamp = now;
+    }
+    
+    // Fading touches everything stamped so far
+    trailDirty = trailBounds;
+    if (trailBounds.empty()) return;
+    
+    // Nothing new for long enough that the rest is invisible: clear it
+    // outright so rounding leaves no residue, and stop repainting
+    if ((now - trailLastStamp) / frequency > trailTimeConstant * TRAIL_EXPIRY_CONSTANTS) {
+        PixelRect last = trailBounds;
+        clearTrail();
+        trailDirty = last;
+        return;
+    }
+    
+    stampTrail(std::exp(-elapsed / trailTimeConstant));
+}
+
+void DryerRenderer::stampTrail(float fade) {
+    if (target) {
+        // Software: multiply the used area down, then rasterize the stamps
+        if (trailPixels.empty()) {
+            trailPixels.assign(static_cast<size_t>(width) * height, 0xFF000000u);
+        }
+        
+        uint32_t k = static_cast<uint32_t>(fade * 256.0f);
+        for (int y = trailBounds.y0; y < trailBounds.y1; y++) {
+            uint32_t* row = trailPixels.data() + y * width;
+            for (int x = trailBounds.x0; x < trailBounds.x1; x++) {
+                uint32_t p = row[x];
+                uint32_t r = (((p >> 16) & 0xFF) * k) >> 8;
+                uint32_t g = (((p >> 8) & 0xFF) * k) >> 8;
+                uint32_t b = ((p & 0xFF) * k) >> 8;
+                row[x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+            }
+        }
+        
+        rasterizer.setTarget(Framebuffer{trailPixels.data(), width, height, width});
+        rasterizer.drawTriangles(trailGeometry.vertexData(), trailGeometry.indexData(),
+                                 static_cast<int>(trailGeometry.indexCount()), trailBounds);
+        return;
+    }
+    
+    // SDL: one translucent black fill, then the stamps, into the texture
+    if (!trailTexture && !createTrailTexture()) {
+        trailEnabled = false;
+        return;
+    }
+    
+    SDL_SetRenderTarget(renderer, trailTexture);
+    uint8_t alpha = static_cast<uint8_t>((1.0f - fade) * 255.0f + 0.5f);
+    if (alpha > 0) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, alpha);
+        SDL_RenderFillRect(renderer, nullptr);
+    }
+    trailGeometry.submit(renderer);
+    SDL_SetRenderTarget(renderer, nullptr);
+}
+
+void DryerRenderer::collectShapes(ShapeList& shapes) const {
+    const SDL_Vertex* vertices = geometry.vertexData();
+    
+    for (size_t shape = 0; shape < geometry.shapeCount(); shape++) {
+        size_t begin = geometry.shapeBegin(shape);
+        size_t end = geometry.shapeEnd(shape);
+        
+        ShapeState state;
+        state.bounds = PixelRect{0, 0, 0, 0};
+        state.hash = 2166136261u;  // FNV-1a
+        
+        if (begin < end) {
+            float minX = vertices[begin].position.x;
+            float maxX = minX;
+            float minY = vertices[begin].position.y;
+            float maxY = minY;
+            
+            for (size_t i = begin; i < end; i++) {
+                const SDL_Vertex& v = vertices[i];
+                minX = std::min(minX, v.position.x);
+                maxX = std::max(maxX, v.position.x);
+                minY = std::min(minY, v.position.y);
+                maxY = std::max(maxY, v.position.y);
+                
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&v);
+                for (size_t k = 0; k < sizeof(SDL_Vertex); k++) {
+                    state.hash = (state.hash ^ bytes[k]) * 16777619u;
+                }
+            }
+            
+            // One pixel of slack for the coverage rule
+            state.bounds.x0 = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+            state.bounds.y0 = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+            state.bounds.x1 = std::min(width, static_cast<int>(std::ceil(maxX)) + 1);
+            state.bounds.y1 = std::min(height, static_cast<int>(std::ceil(maxY)) + 1);
+        }
+        
+        if (!shapes.push_back(state)) {
+            // Too many to track: findDirtyRects sees a count change
+            shapes.clear();
+            return;
+        }
+    }
+}
+
+void DryerRenderer::findDirtyRects(const ShapeList& shapes, RectList& dirty) const {
+    PixelRect screen = {0, 0, width, height};
+    
+    // Different scene layout (vane count, seam on/off, first frame)
+    if (shapes.empty() || shapes.size() != previousShapes.size()) {
+        dirty.push_back(screen);
+        return;
+    }
+    
+    for (size_t i = 0; i < shapes.size(); i++) {
+        if (shapes[i].hash == previousShapes[i].hash) continue;
+        
+        // Where it was and where it is now
+        for (const PixelRect& rect : {previousShapes[i].bounds, shapes[i].bounds}) {
+            if (rect.empty()) continue;
+            if (!dirty.push_back(rect)) {
+                dirty.clear();
+                dirty.push_back(screen);
+                return;
+            }
+        }
+    }
+}
+
+void DryerRenderer::mergeRects(RectList& rects) const {
+    // Repaint regions must not overlap: translucent strokes would be
+    // blended twice. Merge until all are disjoint (and not nearly touching).
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                PixelRect& a = rects[i];
+                const PixelRect& b = rects[j];
+                if (a.x0 > b.x1 + DIRTY_MERGE_MARGIN || b.x0 > a.x1 + DIRTY_MERGE_MARGIN ||
+                    a.y0 > b.y1 + DIRTY_MERGE_MARGIN || b.y0 > a.y1 + DIRTY_MERGE_MARGIN) {
+                    continue;
+                }
+                
+                a.x0 = std::min(a.x0, b.x0);
+                a.y0 = std::min(a.y0, b.y0);
+                a.x1 = std::max(a.x1, b.x1);
+                a.y1 = std::max(a.y1, b.y1);
+                rects[j] = rects.back();
+                rects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+}
+
+void DryerRenderer::buildDrumSegments(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
+    float centerX = view.x + view.size / 2.0f;
+    float centerY = view.y + view.size / 2.0f;
+    float scale = view.size / (physics.getDrumRadius() * 2.2f);
     float radius = physics.getDrumRadius() * scale;
     
     int vaneCount = physics.getVaneCount();
     float anglePerSegment = (2.0f * M_PI) / vaneCount;
+    const auto& surfaces = physics.getSurfaces();
     
-    // Draw each drum segment
     for (int i = 0; i < vaneCount; i++) {
-        float startAngle = (i * anglePerSegment) + physics.getDrumAngle();
-        float endAngle = startAngle + anglePerSegment;
+        int slot = DryerPhysics::surfaceSlot(i, SURFACE_DRUM);
+        if (slot >= static_cast<int>(surfaces.size())) continue;
         
-        // Find corresponding surface
-        const auto& surfaces = physics.getSurfaces();
-        auto it = std::find_if(surfaces.begin(), surfaces.end(),
-            [i](const Surface& s) {
-                return s.type == "drum" && s.index == i;
-            });
+        float highlight = activeCollisions[highlightKey(drum, slot)];
+        float alpha = 0.3f + (highlight * 0.5f);
         
-        if (it == surfaces.end()) continue;
+        // Physics angles are counter-clockwise, screen y points down
+        float startAngle = (i * anglePerSegment) + physics.getDrumAngle();
+        geometry.addArc(centerX, centerY, radius, -startAngle, -(startAngle + anglePerSegment),
+                        9.0f, toSDLColor(surfaces[slot].color, alpha), 20);
+    }
+}
+
+void DryerRenderer::buildVanes(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
+    const auto& surfaces = physics.getSurfaces();
+    auto vanes = physics.getVanePositions(view.size);
+    
+    for (const auto& vane : vanes) {
+        int leadSlot = DryerPhysics::surfaceSlot(vane.index, SURFACE_VANE_LEADING);
+        int trailSlot = DryerPhysics::surfaceSlot(vane.index, SURFACE_VANE_TRAILING);
+        bool hasSurfaces = trailSlot < static_cast<int>(surfaces.size());
         
-        // Get highlight intensity
         float highlight = 0.0f;
-        auto collIt = activeCollisions.find(it->id);
-        if (collIt != activeCollisions.end()) {
-            highlight = collIt->second;
+        if (hasSurfaces) {
+            highlight = std::max(activeCollisions[highlightKey(drum, leadSlot)],
+                                 activeCollisions[highlightKey(drum, trailSlot)]);
         }
         
+        float alpha = 0.8f + (highlight * 0.2f);
+        uint32_t color = hasSurfaces ? surfaces[leadSlot].color : 0x555555;
+        float lineWidth = 4.0f + highlight * 4.0f;
+        
+        geometry.addLine(view.x + vane.innerX, view.y + vane.innerY,
+                         view.x + vane.outerX, view.y + vane.outerY,
+                         lineWidth, toSDLColor(color, alpha));
+    }
+}
+
+void DryerRenderer::buildBall(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
+    auto ball = physics.getBallPosition(view.size);
+    ball.x += view.x;
+    ball.y += view.y;
+    
+    // Tennis ball gradient: bright centre to darker rim
+    SDL_Color centerColor = {232, 244, 54, 255};
+    SDL_Color rimColor = {202, 194, 24, 255};
+    geometry.addDisc(ball.x, ball.y, ball.radius, centerColor, rimColor, 48);
+    
+    // Seam (two white curves)
+    if (ball.radius >= 4.0f) {
+        SDL_Color seamColor = {255, 255, 255, 150};
+        float seamRadius = ball.radius * 0.7f;
+        float degToRad = M_PI / 180.0f;
+        geometry.addArc(ball.x, ball.y, seamRadius, 10 * degToRad, 170 * degToRad,
+                        1.5f, seamColor, 40);
+        geometry.addArc(ball.x, ball.y, seamRadius, 190 * degToRad, 350 * degToRad,
+                        1.5f, seamColor, 40);
+    }
+}
+
+void DryerRenderer::buildCircleMask() {
+    SDL_Color black = {0, 0, 0, 255};
+    geometry.addCircleMask(width / 2.0f, height / 2.0f, width / 2.0f, width / 2.0f, black, 96);
+}
+
+void DryerRenderer::drawDrumSegments(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
+    int centerX = static_cast<int>(view.x) + view.size / 2;
+    int centerY = static_cast<int>(view.y) + view.size / 2;
+    float scale = view.size / (physics.getDrumRadius() * 2.2f);
+    float radius = physics.getDrumRadius() * scale;
+    
+    int vaneCount = physics.getVaneCount();
+    float anglePerSegment = (2.0f * M_PI) / vaneCount;
+    
+    const auto& surfaces = physics.getSurfaces();
+    
+    // Draw each drum segment
+    for (int i = 0; i < vaneCount; i++) {
+        float startAngle = (i * anglePerSegment) + physics.getDrumAngle();
+        
+        // Corresponding surface
+        int slot = DryerPhysics::surfaceSlot(i, SURFACE_DRUM);
+        if (slot >= static_cast<int>(surfaces.size())) continue;
+        
+        // Get highlight intensity
+        float highlight = activeCollisions[highlightKey(drum, slot)];
+        
         float alpha = 0.3f + (highlight * 0.5f);
-        setDrawColor(it->color, alpha);
+        setDrawColor(surfaces[slot].color, alpha);
         
         // Draw arc as series of line segments
         int segments = 20;
@@ -172,40 +874,25 @@ void DryerRenderer::drawDrumSegments(const DryerPhysics& physics) {
     }
 }
 
-void DryerRenderer::drawVanes(const DryerPhysics& physics) {
+void DryerRenderer::drawVanes(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
     const auto& surfaces = physics.getSurfaces();
-    auto vanes = physics.getVanePositions(width);
+    auto vanes = physics.getVanePositions(view.size);
     
     for (const auto& vane : vanes) {
-        // Get highlight for this vane
-        float highlight = 0.0f;
-        
-        auto leadIt = std::find_if(surfaces.begin(), surfaces.end(),
-            [&vane](const Surface& s) {
-                return s.type == "vane_leading" && s.index == vane.index;
-            });
+        // Get highlight for this vane (either edge)
+        int leadSlot = DryerPhysics::surfaceSlot(vane.index, SURFACE_VANE_LEADING);
+        int trailSlot = DryerPhysics::surfaceSlot(vane.index, SURFACE_VANE_TRAILING);
+        bool hasSurfaces = trailSlot < static_cast<int>(surfaces.size());
         
-        auto trailIt = std::find_if(surfaces.begin(), surfaces.end(),
-            [&vane](const Surface& s) {
-                return s.type == "vane_trailing" && s.index == vane.index;
-            });
-        
-        if (leadIt != surfaces.end()) {
-            auto collIt = activeCollisions.find(leadIt->id);
-            if (collIt != activeCollisions.end()) {
-                highlight = std::max(highlight, collIt->second);
-            }
-        }
-        
-        if (trailIt != surfaces.end()) {
-            auto collIt = activeCollisions.find(trailIt->id);
-            if (collIt != activeCollisions.end()) {
-                highlight = std::max(highlight, collIt->second);
-            }
+        float highlight = 0.0f;
+        if (hasSurfaces) {
+            highlight = std::max(activeCollisions[highlightKey(drum, leadSlot)],
+                                 activeCollisions[highlightKey(drum, trailSlot)]);
         }
         
         float alpha = 0.8f + (highlight * 0.2f);
-        uint32_t color = (leadIt != surfaces.end()) ? leadIt->color : 0x555555;
+        uint32_t color = hasSurfaces ? surfaces[leadSlot].color : 0x555555;
         setDrawColor(color, alpha);
         
         // Draw thick line for vane
@@ -218,14 +905,17 @@ void DryerRenderer::drawVanes(const DryerPhysics& physics) {
             float perpY = dx / len * offset;
             
             SDL_RenderDrawLine(renderer,
-                             vane.innerX + perpX, vane.innerY + perpY,
-                             vane.outerX + perpX, vane.outerY + perpY);
+                             view.x + vane.innerX + perpX, view.y + vane.innerY + perpY,
+                             view.x + vane.outerX + perpX, view.y + vane.outerY + perpY);
         }
     }
 }
 
-void DryerRenderer::drawBall(const DryerPhysics& physics) {
-    auto ball = physics.getBallPosition(width);
+void DryerRenderer::drawBall(const DryerPhysics& physics, int drum) {
+    const DrumViewport& view = viewports[drum];
+    auto ball = physics.getBallPosition(view.size);
+    ball.x += view.x;
+    ball.y += view.y;
     
     // Draw ball as filled circle (tennis ball yellow-green)
     // SDL2 doesn't have native circle drawing, so we approximate
@@ -315,20 +1005,36 @@ void DryerRenderer::applyCircleMask() {
     }
 }
 
-void DryerRenderer::highlightCollision(const std::string& surfaceId) {
-    activeCollisions[surfaceId] = 1.0f;
+void DryerRenderer::highlightCollision(int surfaceSlot, int drum) {
+    if (surfaceSlot < 0 || surfaceSlot >= DryerPhysics::MAX_SURFACES || drum < 0 || drum >= MAX_DRUMS) {
+        return;
+    }
+    
+    // Visual only: if the frame is late and the queue fills, drop the hit
+    collisionEvents.push(highlightKey(drum, surfaceSlot));
 }
 
-void DryerRenderer::updateCollisionHighlights() {
-    // Decay highlights over time
-    auto it = activeCollisions.begin();
-    while (it != activeCollisions.end()) {
-        it->second -= 0.05f;
-        
-        if (it->second <= 0.0f) {
-            it = activeCollisions.erase(it);
-        } else {
-            ++it;
+void DryerRenderer::applyCollisionEvents() {
+    int key;
+    while (collisionEvents.pop(key)) {
+        activeCollisions[key] = 1.0f;
+        if (trailEnabled) {
+            trailHits.push_back(key);
         }
     }
 }
+
+void DryerRenderer::updateCollisionHighlights() {
+    uint64_t now = SDL_GetPerformanceCounter();
+    float elapsed = 0.0f;
+    if (lastHighlightUpdate != 0) {
+        elapsed = static_cast<float>(now - lastHighlightUpdate) / SDL_GetPerformanceFrequency();
+    }
+    lastHighlightUpdate = now;
+    
+    // Decay highlights over real elapsed time
+    float decay = HIGHLIGHT_DECAY_PER_SECOND * elapsed;
+    for (float& intensity : activeCollisions) {
+        intensity = std::max(0.0f, intensity - decay);
+    }
+}
@@ -2,29 +2,96 @@
 #define DRYER_RENDERER_H
 
 #include "dryer-physics.h"
+#include "dryer-queue.h"
+#include "dryer-geometry.h"
+#include "dryer-framebuffer.h"
+#include "dryer-rasterizer.h"
+#include "dryer-fixed-vector.h"
+#include "pins.h"
 #include <SDL2/SDL.h>
-#include <map>
-#include <string>
+#include <memory>
+#include <vector>
 
 // ============================================================================
 // DRYER RENDERER - SDL2 Graphics
 // Renders physics simulation to 480x480 round display
 // ============================================================================
 
+// Selected at runtime with DRYER_RENDERER=sdl|drm|fbdev|memory
+enum RenderBackend {
+    RENDER_SDL,         // SDL2 window (kmsdrm + GLES2 on the Pi)
+    RENDER_DRM,         // software rasterizer into DRM dumb buffers
+    RENDER_FBDEV,       // software rasterizer into /dev/fb0
+    RENDER_MEMORY       // software rasterizer, no display (headless)
+};
+
+// Per-frame cost breakdown (dryer-bench)
+enum RenderStage {
+    RENDER_STAGE_DRUM,      // tessellation / line drawing per scene part
+    RENDER_STAGE_VANES,
+    RENDER_STAGE_BALL,
+    RENDER_STAGE_MASK,
+    RENDER_STAGE_TRAIL,     // fade + stamp of the motion trail
+    RENDER_STAGE_DIRTY,     // software: dirty region search
+    RENDER_STAGE_RASTER,    // software: rasterize; SDL: RenderGeometry submit
+    RENDER_STAGE_PRESENT,   // flip / RenderPresent
+    RENDER_STAGE_COUNT
+};
+
+struct RenderProfile {
+    uint64_t stageNs[RENDER_STAGE_COUNT];
+    uint64_t frames;
+
+    RenderProfile() { reset(); }
+    void reset();
+    static const char* stageName(int stage);
+};
+
 class DryerRenderer {
 public:
     DryerRenderer(int width = 480, int height = 480);
     ~DryerRenderer();
     
     // Initialization
-    bool initialize(bool fullscreen = true);
+    bool initialize(bool fullscreen = true, RenderBackend backend = RENDER_SDL);
     void shutdown();
     
-    // Rendering
-    void render(const DryerPhysics& physics);
+    // DRYER_RENDERER environment variable (default sdl)
+    static RenderBackend backendFromEnvironment();
+    
+    // Rendering. Several drums (polyrhythm mode) are tiled across the
+    // round display, drum 0 on the left.
+    void render(const DryerPhysics* drums, int drumCount);
+    void render(const DryerPhysics& physics) { render(&physics, 1); }
+    
+    // Window events; false once the window was closed
+    bool processEvents();
+    
+    // How far (in pixels) the scene has moved since the last rendered frame.
+    // Infinite while highlights fade or after a layout change.
+    float estimateChange(const DryerPhysics* drums, int drumCount) const;
+    float estimateChange(const DryerPhysics& physics) const { return estimateChange(&physics, 1); }
     
     // Status
     bool isInitialized() const { return initialized; }
+    bool isUsingGeometry() const { return useGeometry; }
+    RenderBackend getBackend() const { return backend; }
+    
+    // Software backends: the framebuffer target, and the share of the
+    // screen repainted by the last frame (0-1)
+    FramebufferTarget* getFramebufferTarget() { return target.get(); }
+    float getDirtyFraction() const { return dirtyFraction; }
+    
+    // Motion trail (DRYER_TRAIL=1, length DRYER_TRAIL_SECONDS)
+    bool isTrailEnabled() const { return trailEnabled; }
+    void setTrail(bool enabled, float seconds);
+    
+    // Software backends: next frame repaints everything
+    void invalidate();
+    
+    // Accumulated stage timings since the last reset
+    const RenderProfile& getProfile() const { return profile; }
+    void resetProfile() { profile.reset(); }
     
 private:
     // SDL objects
@@ -36,15 +103,113 @@ private:
     int height;
     bool initialized;
     
-    // Collision highlighting
-    std::map<std::string, float> activeCollisions;  // surfaceId -> intensity
+    // Square area of the screen one drum is drawn into
+    struct DrumViewport {
+        float x;
+        float y;
+        int size;
+    };
+    DrumViewport viewports[MAX_DRUMS];
+    int viewportCount;
+    void layoutDrums(int drumCount);
+    
+    // Scene as of the last render(), for estimateChange()
+    struct RenderedState {
+        bool valid;
+        float ballX;
+        float ballY;
+        float ballRadius;
+        float drumAngle;
+        float drumRadius;
+        float vaneHeight;
+        int vaneCount;
+    };
+    RenderedState lastRendered[MAX_DRUMS];
+    int renderedDrums;          // 0 = nothing rendered yet
+    void rememberRendered(const DryerPhysics* drums, int drumCount);
+    
+    // Collision highlighting, indexed by highlightKey(drum, Surface::slot)
+    static int highlightKey(int drum, int slot) { return drum * DryerPhysics::MAX_SURFACES + slot; }
+    float activeCollisions[MAX_DRUMS * DryerPhysics::MAX_SURFACES];  // intensity 0-1
+    SpscQueue<int, 128> collisionEvents;    // keys hit since last frame
+    uint64_t lastHighlightUpdate;                        // SDL performance counter
+    
+    // Triangle batch path (SDL_RenderGeometry): whole frame in one call.
+    // Falls back to the line path below when unavailable, or when
+    // DRYER_RENDER_LINES=1 is set for comparison.
+    GeometryBuilder geometry;
+    bool useGeometry;
+    
+    void buildFrame(const DryerPhysics* drums, int drumCount);
+    void buildDrumSegments(const DryerPhysics& physics, int drum);
+    void buildVanes(const DryerPhysics& physics, int drum);
+    void buildBall(const DryerPhysics& physics, int drum);
+    void buildCircleMask();
+    
+    // Motion trail: the ball's path and hit points accumulate in a persistent
+    // buffer (render-target texture on SDL, pixel buffer in software) that
+    // is faded once per frame and stamped with only the newest segment, so
+    // cost does not grow with trail length. Composited additively under the
+    // scene.
+    bool trailEnabled;
+    float trailTimeConstant;            // seconds for the trail to fade to 1/e
+    SDL_Texture* trailTexture;          // SDL path
+    std::vector<uint32_t> trailPixels;  // software path, width x height
+    GeometryBuilder trailGeometry;      // this frame's stamps
+    FixedVector<int, 32> trailHits;     // highlight keys hit since the last frame
+    struct TrailPen {
+        bool hasLast;
+        float lastX;
+        float lastY;
+    };
+    TrailPen trailPens[MAX_DRUMS];      // per drum
+    PixelRect trailBounds;              // everything stamped since the last clear
+    PixelRect trailDirty;               // changed by this frame's update
+    uint64_t trailLastStamp;            // SDL performance counter
+    uint64_t lastTrailUpdate;
+    
+    bool createTrailTexture();
+    void clearTrail();
+    void updateTrail(const DryerPhysics* drums, int drumCount);
+    void stampTrail(float fade);
+    
+    // Software path: rasterizes the geometry batch into a raw framebuffer,
+    // repainting only the bounding boxes of shapes that changed
+    static const int MAX_SHAPES = 64;
+    static const int MAX_DIRTY_RECTS = 128;
+    
+    struct ShapeState {
+        PixelRect bounds;
+        uint32_t hash;      // of the shape's vertices
+    };
+    
+    typedef FixedVector<ShapeState, MAX_SHAPES> ShapeList;
+    typedef FixedVector<PixelRect, MAX_DIRTY_RECTS> RectList;
+    
+    RenderBackend backend;
+    std::unique_ptr<FramebufferTarget> target;
+    SoftwareRasterizer rasterizer;
+    ShapeList previousShapes;
+    RectList previousDirty;     // last frame's changes, still stale in the back buffer
+    float dirtyFraction;
+    
+    RenderProfile profile;
+    uint64_t stageStart;
+    void endStage(RenderStage stage);   // charge time since stageStart
+    
+    bool initializeSoftware();
+    void renderSoftware(const DryerPhysics* drums, int drumCount);
+    void collectShapes(ShapeList& shapes) const;
+    void findDirtyRects(const ShapeList& shapes, RectList& dirty) const;
+    void mergeRects(RectList& rects) const;
     
-    // Drawing methods
+    // Drawing methods (line path)
     void clear();
     void present();
-    void drawDrumSegments(const DryerPhysics& physics);
-    void drawVanes(const DryerPhysics& physics);
-    void drawBall(const DryerPhysics& physics);
+    void drawDrumSegments(const DryerPhysics& physics, int drum);
+    void drawVanes(const DryerPhysics& physics, int drum);
+    void drawBall(const DryerPhysics& physics, int drum);
+    void applyCollisionEvents();
     void updateCollisionHighlights();
     
     // Helper to convert color
@@ -54,8 +219,9 @@ private:
     void applyCircleMask();
     
 public:
-    // Called by collision events
-    void highlightCollision(const std::string& surfaceId);
+    // Called by collision events. Safe to call from the physics thread
+    // (single producer) while render() runs on another.
+    void highlightCollision(int surfaceSlot, int drum = 0);
 };
 
 #endif // DRYER_RENDERER_H
@@ -0,0 +1,472 @@
+#include "dryer-sim.h"
+#include "dryer-latency.h"
+#include "pins.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static const int SWITCH_PINS[3] = {GPIO_BALL_TYPE, GPIO_LINT_TRAP, GPIO_MOON_GRAVITY};
+static const char* SWITCH_NAMES[3] = {"balloon", "lint", "moon"};
+static const char* POT_NAMES[4] = {"rpm", "drum", "vanes", "height"};
+static const int POT_CHANNELS[4] = {ADC_CHAN_RPM, ADC_CHAN_DRUM_SIZE, ADC_CHAN_VANES, ADC_CHAN_VANE_HEIGHT};
+
+// ADS1115 data rates by the config register's DR bits (samples/s)
+static const int ADC_DATA_RATES[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+static const uint16_t ADC_CONFIG_OS = 0x8000;
+static const uint16_t ADC_CONFIG_MODE_SINGLE = 0x0100;
+static const uint16_t ADC_CONFIG_DEFAULT = 0x0583;      // power-up value, OS aside
+static const uint64_t ADC_WAKEUP_NS = 25000;            // single shot: out of power-down
+static const int ADC_NOISE_LSB = 3;
+
+static const double I2C_CLOCK_HZ = 100000.0;            // Pi default bus speed
+static const size_t GATE_CAPACITY = 65536;
+
+float SimCurve::at(double time) const {
+    switch (shape) {
+        case RAMP: {
+            double t = seconds > 0.0 ? std::clamp(time / seconds, 0.0, 1.0) : 1.0;
+            return static_cast<float>(from + (to - from) * t);
+        }
+        case SINE: {
+            double phase = seconds > 0.0 ? 2.0 * M_PI * time / seconds : 0.0;
+            return static_cast<float>(from + (to - from) * 0.5 * (1.0 - std::cos(phase)));
+        }
+        case SQUARE: {
+            if (seconds <= 0.0) return from;
+            return std::fmod(time, seconds) < seconds * 0.5 ? from : to;
+        }
+        case CONSTANT:
+        default:
+            return from;
+    }
+}
+
+bool SimCurve::parse(const char* text, SimCurve& curve) {
+    curve = SimCurve{CONSTANT, 0.5f, 0.5f, 0.0};
+
+    char shape[16];
+    float from = 0.0f;
+    float to = 0.0f;
+    double seconds = 0.0;
+    if (std::sscanf(text, "%15[a-z]:%f:%f:%lf", shape, &from, &to, &seconds) == 4) {
+        if (std::strcmp(shape, "ramp") == 0) curve.shape = RAMP;
+        else if (std::strcmp(shape, "sine") == 0) curve.shape = SINE;
+        else if (std::strcmp(shape, "square") == 0) curve.shape = SQUARE;
+        else return false;
+        curve.from = from;
+        curve.to = to;
+        curve.seconds = seconds;
+        return seconds > 0.0;
+    }
+
+    char* end = nullptr;
+    curve.from = curve.to = std::strtof(text, &end);
+    return end != text;
+}
+
+SimHardwareBackend::SimHardwareBackend()
+    : clockBpm(0.0)
+    , clockPulsesPerBeat(1)
+    , clockEnabled(false)
+    , nextClockEdge(0)
+    , speed(1.0)
+    , durationSeconds(0.0)
+    , recordPath(nullptr)
+    , startNs(latencyNowNs())
+    , registers{0, ADC_CONFIG_DEFAULT, 0x8000, 0x7FFF}
+    , converting(false)
+    , conversionStartNs(0)
+    , conversionNs(0)
+    , readyEnabled(false)
+    , readyPending(false)
+    , noiseState(12345)
+    , conversions(0)
+    , earlyReads(0)
+    , gatesDropped(0)
+{
+    for (SimCurve& pot : pots) {
+        pot = SimCurve{SimCurve::CONSTANT, 0.5f, 0.5f, 0.0};
+    }
+}
+
+void SimHardwareBackend::loadFromEnvironment() {
+    if (const char* value = std::getenv("DRYER_SIM_POTS")) {
+        std::string entries = value;
+        size_t begin = 0;
+        while (begin < entries.size()) {
+            size_t end = entries.find(',', begin);
+            if (end == std::string::npos) end = entries.size();
+            std::string entry = entries.substr(begin, end - begin);
+            begin = end + 1;
+
+            // knob=curve
+            size_t equals = entry.find('=');
+            int knob = -1;
+            for (int i = 0; i < 4 && equals != std::string::npos; i++) {
+                if (entry.compare(0, equals, POT_NAMES[i]) == 0) knob = i;
+            }
+            SimCurve curve;
+            if (knob < 0 || !SimCurve::parse(entry.c_str() + equals + 1, curve)) {
+                std::cerr << "WARNING: ignoring DRYER_SIM_POTS entry " << entry << std::endl;
+                continue;
+            }
+            pots[POT_CHANNELS[knob]] = curve;
+        }
+    }
+
+    if (const char* value = std::getenv("DRYER_SIM_SWITCHES")) {
+        const char* entry = value;
+        while (entry && *entry) {
+            // switch=seconds:seconds:...
+            const char* equals = std::strchr(entry, '=');
+            const char* comma = std::strchr(entry, ',');
+            int index = -1;
+            for (int i = 0; i < 3 && equals && (!comma || equals < comma); i++) {
+                size_t length = static_cast<size_t>(equals - entry);
+                if (std::strlen(SWITCH_NAMES[i]) == length && std::strncmp(entry, SWITCH_NAMES[i], length) == 0) {
+                    index = i;
+                }
+            }
+            if (index < 0) {
+                std::cerr << "WARNING: ignoring DRYER_SIM_SWITCHES entry " << entry << std::endl;
+            } else {
+                const char* cursor = equals + 1;
+                while (*cursor && *cursor != ',') {
+                    char* end = nullptr;
+                    double seconds = std::strtod(cursor, &end);
+                    if (end == cursor) break;
+                    switchFlips[index].push_back(seconds);
+                    cursor = *end == ':' ? end + 1 : end;
+                }
+                std::sort(switchFlips[index].begin(), switchFlips[index].end());
+            }
+
+            entry = comma;
+            if (entry) entry++;
+        }
+    }
+
+    if (const char* value = std::getenv("DRYER_SIM_CLOCK")) {
+        int pulses = 1;
+        if (std::sscanf(value, "%lf:%d", &clockBpm, &pulses) < 1 || clockBpm <= 0.0) {
+            std::cerr << "WARNING: ignoring DRYER_SIM_CLOCK=" << value << std::endl;
+            clockBpm = 0.0;
+        }
+        clockPulsesPerBeat = std::max(1, pulses);
+    }
+    if (const char* value = std::getenv("DRYER_SIM_SPEED")) {
+        speed = std::clamp(std::atof(value), 0.1, 100.0);
+    }
+    if (const char* value = std::getenv("DRYER_SIM_SECONDS")) {
+        durationSeconds = std::max(0.0, std::atof(value));
+    }
+    recordPath = std::getenv("DRYER_SIM_RECORD");
+
+    std::cout << "Sim hardware: " << speed << "x";
+    if (durationSeconds > 0.0) {
+        std::cout << ", " << durationSeconds << " s";
+    }
+    if (clockBpm > 0.0) {
+        std::cout << ", clock " << clockBpm << " BPM x " << clockPulsesPerBeat;
+    }
+    if (recordPath) {
+        std::cout << ", recording to " << recordPath;
+    }
+    std::cout << std::endl;
+}
+
+bool SimHardwareBackend::openGPIO(const int*, int) {
+    // Simulated time starts with the hardware
+    startNs = latencyNowNs();
+    gates.reserve(GATE_CAPACITY);
+    return true;
+}
+
+bool SimHardwareBackend::openADC() {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    registers[1] = ADC_CONFIG_DEFAULT;
+    converting = false;
+    return true;
+}
+
+void SimHardwareBackend::close() {
+    clockEnabled = false;
+}
+
+double SimHardwareBackend::simSeconds(uint64_t nowNs) const {
+    int64_t elapsedNs = static_cast<int64_t>(nowNs - startNs);
+    return static_cast<double>(elapsedNs) * 1e-9 * speed;
+}
+
+bool SimHardwareBackend::finished() const {
+    return durationSeconds > 0.0 && simSeconds(latencyNowNs()) >= durationSeconds;
+}
+
+void SimHardwareBackend::waitSim(uint64_t simNs) const {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(simNs / speed)));
+}
+
+void SimHardwareBackend::i2cTransfer(int bytes) const {
+    // Address byte plus data, 9 clocks each (ACK included), start/stop aside
+    double seconds = (bytes + 1) * 9.0 / I2C_CLOCK_HZ;
+    waitSim(static_cast<uint64_t>(seconds * 1e9));
+}
+
+bool SimHardwareBackend::writeADCRegister(uint8_t reg, uint16_t value) {
+    i2cTransfer(3);
+
+    std::lock_guard<std::mutex> lock(adcMutex);
+    uint64_t nowNs = latencyNowNs();
+    updateConversion(nowNs);
+
+    switch (reg) {
+        case 0:
+            return true;    // conversion register is read-only
+        case 1: {
+            registers[1] = value & ~ADC_CONFIG_OS;
+            int rate = ADC_DATA_RATES[(value >> 5) & 0x07];
+            bool single = (value & ADC_CONFIG_MODE_SINGLE) != 0;
+            uint64_t simNs = 1000000000ULL / rate + (single ? ADC_WAKEUP_NS : 0);
+            conversionNs = static_cast<uint64_t>(simNs / speed);
+
+            // Single shot starts on OS; continuous runs until told otherwise
+            if (!single || (value & ADC_CONFIG_OS)) {
+                converting = true;
+                conversionStartNs = nowNs;
+            } else {
+                converting = false;
+            }
+            return true;
+        }
+        case 2:
+        case 3:
+            registers[reg] = value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool SimHardwareBackend::readADCRegister(uint8_t reg, uint16_t& value) {
+    if (reg > 3) return false;
+
+    // Pointer write, then the 2-byte read
+    i2cTransfer(1);
+    i2cTransfer(2);
+
+    std::lock_guard<std::mutex> lock(adcMutex);
+    updateConversion(latencyNowNs());
+
+    if (reg == 0 && converting && (registers[1] & ADC_CONFIG_MODE_SINGLE)) {
+        earlyReads++;
+    }
+    value = registers[reg];
+    if (reg == 1 && !converting) {
+        value |= ADC_CONFIG_OS;     // reads 1 when idle
+    }
+    return true;
+}
+
+bool SimHardwareBackend::enableADCReady(int) {
+    readyEnabled = true;
+    return true;
+}
+
+int SimHardwareBackend::waitADCReady(int timeoutUs) {
+    if (!readyEnabled) return -1;
+
+    uint64_t nowNs = latencyNowNs();
+    uint64_t deadlineNs = nowNs + static_cast<uint64_t>(timeoutUs) * 1000ULL;
+    uint64_t edgeNs = 0;
+    {
+        std::lock_guard<std::mutex> lock(adcMutex);
+        updateConversion(nowNs);
+        if (readyPending) {
+            readyPending = false;
+            return 1;
+        }
+        if (converting && readyMode()) {
+            edgeNs = conversionStartNs + conversionNs;
+        }
+    }
+
+    if (edgeNs == 0 || edgeNs > deadlineNs) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(deadlineNs - nowNs));
+        return 0;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(edgeNs - std::min(edgeNs, nowNs)));
+
+    std::lock_guard<std::mutex> lock(adcMutex);
+    updateConversion(latencyNowNs());
+    readyPending = false;
+    return 1;
+}
+
+bool SimHardwareBackend::readyMode() const {
+    // Hi_thresh MSB set, Lo_thresh MSB clear, comparator queue enabled
+    return (registers[3] & 0x8000) && !(registers[2] & 0x8000) && (registers[1] & 0x0003) != 0x0003;
+}
+
+void SimHardwareBackend::updateConversion(uint64_t nowNs) {
+    if (!converting || nowNs < conversionStartNs + conversionNs) return;
+    readyPending = readyMode();
+
+    int channel = -1;
+    uint16_t mux = (registers[1] >> 12) & 0x07;
+    if (mux >= 4) {
+        channel = mux - 4;  // AIN0..3 against GND; differential pairs read 0
+    }
+
+    if (registers[1] & ADC_CONFIG_MODE_SINGLE) {
+        uint64_t doneNs = conversionStartNs + conversionNs;
+        registers[0] = channel >= 0 ? sample(channel, doneNs) : 0;
+        converting = false;
+        conversions++;
+    } else {
+        // Continuous: keep the newest completed conversion
+        uint64_t completed = (nowNs - conversionStartNs) / conversionNs;
+        conversionStartNs += completed * conversionNs;
+        registers[0] = channel >= 0 ? sample(channel, conversionStartNs) : 0;
+        conversions += completed;
+    }
+}
+
+uint16_t SimHardwareBackend::sample(int channel, uint64_t atNs) {
+    float knob = std::clamp(pots[channel].at(simSeconds(atNs)), 0.0f, 1.0f);
+
+    noiseState = noiseState * 1664525u + 1013904223u;
+    int noise = static_cast<int>((noiseState >> 16) % (2 * ADC_NOISE_LSB + 1)) - ADC_NOISE_LSB;
+
+    int code = static_cast<int>(knob * ADC_MAX_VALUE + 0.5f) + noise;
+    return static_cast<uint16_t>(std::clamp(code, 0, 32767));
+}
+
+bool SimHardwareBackend::readSwitch(int pin) {
+    double now = simSeconds(latencyNowNs());
+    for (int i = 0; i < 3; i++) {
+        if (SWITCH_PINS[i] == pin) {
+            auto flipped = std::upper_bound(switchFlips[i].begin(), switchFlips[i].end(), now);
+            return (flipped - switchFlips[i].begin()) % 2 == 1;
+        }
+    }
+    return false;
+}
+
+void SimHardwareBackend::writeTrigger(int pin, bool value) {
+    std::lock_guard<PiMutex> lock(gateMutex);
+    if (gates.size() < GATE_CAPACITY) {
+        gates.push_back(GateEdge{latencyNowNs(), pin, value});
+    } else {
+        gatesDropped++;
+    }
+}
+
+bool SimHardwareBackend::enableClockInput() {
+    if (clockBpm <= 0.0) {
+        std::cerr << "sim: no DRYER_SIM_CLOCK for the gate input" << std::endl;
+        return false;
+    }
+
+    double edgeSeconds = 60.0 / (clockBpm * clockPulsesPerBeat);
+    nextClockEdge = static_cast<uint64_t>(std::ceil(simSeconds(latencyNowNs()) / edgeSeconds));
+    clockEnabled = true;
+    return true;
+}
+
+int SimHardwareBackend::readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) {
+    if (!clockEnabled) return -1;
+
+    // Edge k falls at simulated time k * edgeSeconds
+    double edgeSeconds = 60.0 / (clockBpm * clockPulsesPerBeat);
+    auto edgeNs = [this, edgeSeconds](uint64_t edge) {
+        return startNs + static_cast<uint64_t>(edge * edgeSeconds / speed * 1e9);
+    };
+
+    uint64_t deadlineNs = latencyNowNs() + static_cast<uint64_t>(timeoutMs) * 1000000ULL;
+    uint64_t firstNs = edgeNs(nextClockEdge);
+    if (firstNs > deadlineNs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return 0;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(firstNs - std::min(firstNs, latencyNowNs()))));
+
+    int count = 0;
+    uint64_t nowNs = latencyNowNs();
+    while (count < maxEdges && edgeNs(nextClockEdge) <= nowNs) {
+        timestampsNs[count++] = edgeNs(nextClockEdge++);
+    }
+    return count;
+}
+
+std::vector<SimHardwareBackend::GateEdge> SimHardwareBackend::gateEdges() const {
+    std::lock_guard<PiMutex> lock(gateMutex);
+    return gates;
+}
+
+void SimHardwareBackend::report(std::ostream& out) const {
+    std::lock_guard<PiMutex> lock(gateMutex);
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "=== Dryer sim ===\n";
+    out << "time: " << std::fixed << std::setprecision(1) << simSeconds(latencyNowNs())
+        << " s simulated at " << speed << "x\n";
+    out.flags(flags);
+    out.precision(precision);
+    out << "adc: " << conversions << " conversions, " << earlyReads << " reads before ready\n";
+    out << "gates: " << gates.size() << " edges";
+    if (gatesDropped > 0) {
+        out << " (" << gatesDropped << " past the recording limit)";
+    }
+    out << "\n";
+}
+
+void SimHardwareBackend::writeRecording(const std::vector<MidiPort*>& midiPorts) const {
+    if (!recordPath) return;
+
+    struct Row {
+        uint64_t timeNs;
+        std::string kind;
+        std::string data;
+    };
+    std::vector<Row> rows;
+
+    for (const GateEdge& edge : gateEdges()) {
+        rows.push_back(Row{edge.timeNs, "gate", std::to_string(edge.pin) + (edge.value ? " on" : " off")});
+    }
+    for (MidiPort* port : midiPorts) {
+        const FakeMidiPort* fake = dynamic_cast<const FakeMidiPort*>(port);
+        if (!fake) continue;
+        for (const FakeMidiPort::Message& message : fake->messages()) {
+            char hex[16] = "";
+            for (int i = 0; i < message.count; i++) {
+                size_t used = std::strlen(hex);
+                std::snprintf(hex + used, sizeof(hex) - used, i ? " %02X" : "%02X", message.bytes[i]);
+            }
+            rows.push_back(Row{message.timeNs, "midi", hex});
+        }
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.timeNs < b.timeNs; });
+
+    std::ofstream file(recordPath);
+    if (!file) {
+        std::cerr << "WARNING: cannot write " << recordPath << std::endl;
+        return;
+    }
+    file << "time_ms,sim_s,kind,data\n";
+    file << std::fixed;
+    for (const Row& row : rows) {
+        int64_t sinceStartNs = static_cast<int64_t>(row.timeNs - startNs);
+        file << std::setprecision(3) << sinceStartNs * 1e-6 << ","
+             << std::setprecision(6) << simSeconds(row.timeNs) << ","
+             << row.kind << "," << row.data << "\n";
+    }
+    std::cout << "Sim: " << rows.size() << " events recorded to " << recordPath << std::endl;
+}
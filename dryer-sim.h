@@ -0,0 +1,119 @@
+#ifndef DRYER_SIM_H
+#define DRYER_SIM_H
+
+#include "dryer-hardware-backend.h"
+#include "dryer-midi-port.h"
+#include "dryer-realtime.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// DRYER SIM - Hardware backend for dev machines (DRYER_HARDWARE=sim)
+//   DRYER_SIM_POTS=rpm=0.3,drum=sine:0.2:0.8:10,vanes=ramp:0:1:60
+//                              knob positions 0..1 over time: a constant,
+//                              ramp:from:to:seconds (then holds),
+//                              sine:min:max:period or square:a:b:period;
+//                              knobs left out sit at 0.5
+//   DRYER_SIM_SWITCHES=balloon=5:10,lint=0,moon=20
+//                              seconds at which a switch flips (all start off)
+//   DRYER_SIM_CLOCK=120:4      BPM[:pulses per beat] on the gate input
+//   DRYER_SIM_SPEED=4          simulated seconds per real second
+//   DRYER_SIM_SECONDS=60       end the run after this much simulated time
+//   DRYER_SIM_RECORD=run.csv   write every MIDI message and gate edge,
+//                              timestamped, at shutdown
+//
+// The ADS1115 is modelled at register level: I2C transfers take their time
+// at 100 kHz, a conversion takes 1/SPS of the configured data rate (single
+// shot or continuous), the config register's OS bit reads busy until it is
+// done, and reading early returns the previous result. ALERT/RDY fires at
+// the end of a conversion once the threshold registers select
+// conversion-ready mode, as on the chip.
+// ============================================================================
+
+struct SimCurve {
+    enum Shape { CONSTANT, RAMP, SINE, SQUARE };
+
+    Shape shape;
+    float from;
+    float to;
+    double seconds;             // ramp length / period
+
+    float at(double time) const;
+    static bool parse(const char* text, SimCurve& curve);
+};
+
+class SimHardwareBackend : public HardwareBackend {
+public:
+    // A gate edge as it went out
+    struct GateEdge {
+        uint64_t timeNs;        // latencyNowNs()
+        int pin;
+        bool value;
+    };
+
+    SimHardwareBackend();
+
+    void loadFromEnvironment();
+
+    bool openGPIO(const int* triggerPins, int triggerCount) override;
+    bool openADC() override;
+    void close() override;
+    bool writeADCRegister(uint8_t reg, uint16_t value) override;
+    bool readADCRegister(uint8_t reg, uint16_t& value) override;
+    bool enableADCReady(int pin) override;
+    int waitADCReady(int timeoutUs) override;
+    bool readSwitch(int pin) override;
+    void writeTrigger(int pin, bool value) override;
+    bool enableClockInput() override;
+    int readClockEdges(uint64_t* timestampsNs, int maxEdges, int timeoutMs) override;
+    double timeScale() const override { return speed; }
+    bool finished() const override;
+    void report(std::ostream& out) const override;
+    const char* name() const override { return "sim"; }
+
+    // Simulated seconds since the backend was opened
+    double simSeconds(uint64_t nowNs) const;
+
+    // Gate edges so far, oldest first
+    std::vector<GateEdge> gateEdges() const;
+
+    // DRYER_SIM_RECORD: gates plus whatever the fake MIDI ports kept
+    void writeRecording(const std::vector<MidiPort*>& midiPorts) const;
+
+private:
+    SimCurve pots[4];           // by ADC channel
+    std::vector<double> switchFlips[3];     // ball type, lint trap, moon gravity
+    double clockBpm;            // 0 = no clock on the gate input
+    int clockPulsesPerBeat;
+    bool clockEnabled;
+    uint64_t nextClockEdge;     // index of the next edge to hand out
+    double speed;
+    double durationSeconds;     // 0 = run until stopped
+    const char* recordPath;
+    uint64_t startNs;
+
+    // ADS1115 state
+    std::mutex adcMutex;
+    uint16_t registers[4];      // conversion, config, lo/hi threshold
+    bool converting;
+    uint64_t conversionStartNs;
+    uint64_t conversionNs;      // real time one conversion takes
+    bool readyEnabled;          // ALERT/RDY "wired"
+    bool readyPending;          // conversion done, edge not yet waited for
+    uint32_t noiseState;
+    uint64_t conversions;
+    uint64_t earlyReads;        // conversion register read while busy
+
+    mutable PiMutex gateMutex;
+    std::vector<GateEdge> gates;    // reserved up front, not grown
+    uint64_t gatesDropped;
+
+    void waitSim(uint64_t simNs) const;
+    void i2cTransfer(int bytes) const;
+    void updateConversion(uint64_t nowNs);
+    bool readyMode() const;
+    uint16_t sample(int channel, uint64_t atNs);
+};
+
+#endif // DRYER_SIM_H
@@ -21,20 +21,32 @@
 #define GPIO_BALL_TYPE      17          // Ball type selector (tennis/balloon)
 #define GPIO_LINT_TRAP      27          // Lint trap filter enable
 #define GPIO_MOON_GRAVITY   22          // Moon gravity mode enable
+#define GPIO_CLOCK_IN       6           // External clock / gate input (DRYER_CLOCK=gate)
+#define GPIO_ADC_READY      16          // ADS1115 ALERT/RDY, if wired (DRYER_ADC_READY=1)
 
 // GPIO Digital Outputs (0-3.3V triggers)
 #define GPIO_TRIGGER_OUT_1  23          // Trigger output 1 (drum collision)
 #define GPIO_TRIGGER_OUT_2  24          // Trigger output 2 (vane collision)
+#define GPIO_TRIGGER_OUT_3  25          // Trigger output 3 (multi-drum only)
+#define GPIO_TRIGGER_OUT_4  5           // Trigger output 4 (multi-drum only)
 #define GPIO_TRIG_PULSE_MS  10          // Trigger pulse duration (ms)
+#define TRIGGER_OUTPUT_COUNT 4
+
+// Polyrhythm mode (DRYER_DRUMS): one gate output per drum
+#define MAX_DRUMS           TRIGGER_OUTPUT_COUNT
 
 // UART for MIDI Output
 #define UART_DEVICE         "/dev/serial0"  // Hardware UART
 #define MIDI_BAUD_RATE      31250       // MIDI standard baud rate
+#define MIDI_NOTE_LENGTH_MS 100         // Note-on -> note-off delay (ms)
 
 // Display
 #define DISPLAY_WIDTH       480
 #define DISPLAY_HEIGHT      480
 #define DISPLAY_FPS         60
+#define DISPLAY_IDLE_FPS    10          // Render floor while the scene is static
+#define DISPLAY_MIN_CHANGE_PX 0.75f     // Smaller visual change: skip the frame
+#define PHYSICS_RATE_HZ     240         // Fixed physics step rate (Hz)
 
 // ADC Conversion Parameters
 #define ADC_MAX_VALUE       26400       // ADS1115 16-bit max (accounting for PGA)